@@ -0,0 +1,33 @@
+#include "gdwg/betweenness.hpp"
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+// Betweenness on a scale 14 R-MAT graph from 256 sampled sources, unweighted and weighted, with
+// 1, 2, 4, 8 and 16 threads. A full run costs n / 256 = 64 times as much.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 14, .edge_factor = 16, .max_weight = 100, .seed = 6771}),
+		   gdwg::csr_layout::outgoing);
+		return view;
+	}
+
+	auto betweenness(benchmark::State& state, bool weighted) -> void {
+		auto const& view = rmat_view();
+		auto const options = gdwg::betweenness_options{
+		   .weighted = weighted,
+		   .samples = 256,
+		   .threads = static_cast<std::size_t>(state.range(0)),
+		};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::betweenness(view, options));
+		}
+		state.SetItemsProcessed(state.iterations() * 256);
+	}
+} // namespace
+
+BENCHMARK_CAPTURE(betweenness, unweighted, false)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK_CAPTURE(betweenness, weighted, true)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
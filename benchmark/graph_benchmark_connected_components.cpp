@@ -0,0 +1,27 @@
+#include "gdwg/connected_components.hpp"
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+// Weakly connected components on a scale 20 R-MAT graph (about 16 million edges) with 1, 2, 4, 8
+// and 16 threads, to check that the Afforest routine scales with cores.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 20, .edge_factor = 16, .seed = 6771}));
+		return view;
+	}
+
+	auto weakly_connected_components(benchmark::State& state) -> void {
+		auto const& view = rmat_view();
+		auto const threads = static_cast<std::size_t>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::weakly_connected_components(view, {.threads = threads}));
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(view.num_edges()));
+	}
+} // namespace
+
+BENCHMARK(weakly_connected_components)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
@@ -0,0 +1,38 @@
+#include "gdwg/dynamic_distances.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Erasing a random edge of a scale 14 R-MAT graph and putting it back, with distances kept from
+// 4 sources. The touched counter is the average number of nodes an update looked at again, out
+// of 2^14 that a recomputation would settle per source. The time is mostly graph::erase_edge,
+// which looks at every edge of the graph.
+
+namespace {
+	auto update(benchmark::State& state) -> void {
+		auto g = gdwg::rmat_graph({.scale = 14, .edge_factor = 16, .max_weight = 100, .seed = 6771});
+		auto edges = std::vector<gdwg::graph<int, int>::value_type>(g.begin(), g.end());
+		auto distances = gdwg::dynamic_distances<int, int>(g, {0, 1, 2, 3});
+		auto rng = std::mt19937(6771);
+		auto pick = std::uniform_int_distribution<std::size_t>(0, edges.size() - 1);
+		auto touched = std::size_t{0};
+		for (auto _ : state) {
+			auto const& [from, to, weight] = edges[pick(rng)];
+			distances.erase_edge(from, to, weight);
+			touched += distances.last_update().touched;
+			distances.insert_edge(from, to, weight);
+			touched += distances.last_update().touched;
+		}
+		state.counters["touched"] = benchmark::Counter(static_cast<double>(touched) / 2.0,
+		                                               benchmark::Counter::kAvgIterations);
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 2);
+	}
+} // namespace
+
+BENCHMARK(update);
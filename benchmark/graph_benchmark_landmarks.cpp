@@ -0,0 +1,84 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/landmarks.hpp"
+#include "gdwg/shortest_path.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+// Landmarks over a scale 16 R-MAT graph: building the oracle on 1 to 16 threads, a bounds query
+// between random pairs, and A* between random pairs with and without the landmark heuristic.
+// The settled counter is the average number of nodes an A* query expanded.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 16, .edge_factor = 8, .max_weight = 100, .seed = 6771}));
+		return view;
+	}
+
+	auto oracle() -> gdwg::landmark_oracle<int, int> const& {
+		static auto const ret = gdwg::landmark_oracle<int, int>(rmat_view());
+		return ret;
+	}
+
+	auto build(benchmark::State& state, gdwg::landmark_selection selection) -> void {
+		auto const& view = rmat_view();
+		auto const options = gdwg::landmark_options{
+		   .selection = selection,
+		   .threads = static_cast<std::size_t>(state.range(0)),
+		};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::landmark_oracle<int, int>(view, options));
+		}
+	}
+
+	auto bounds(benchmark::State& state) -> void {
+		auto const& landmarks = oracle();
+		auto rng = std::mt19937(6771);
+		auto pick = std::uniform_int_distribution<gdwg::node_id>(
+		   0,
+		   static_cast<gdwg::node_id>(landmarks.num_nodes() - 1));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(landmarks.bounds(pick(rng), pick(rng)));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+
+	auto astar(benchmark::State& state, bool guided) -> void {
+		auto const& view = rmat_view();
+		auto const& landmarks = oracle();
+		auto ws = gdwg::search_workspace<int>(view.num_nodes());
+		auto rng = std::mt19937(6771);
+		auto pick = std::uniform_int_distribution<gdwg::node_id>(
+		   0,
+		   static_cast<gdwg::node_id>(view.num_nodes() - 1));
+		auto settled = std::size_t{0};
+		for (auto _ : state) {
+			auto const src = pick(rng);
+			auto const dst = pick(rng);
+			auto const result =
+			   guided ? gdwg::astar(view, src, dst, landmarks.heuristic(dst), ws)
+			          : gdwg::astar(view, src, dst, [](gdwg::node_id) { return 0; }, ws);
+			settled += result.stats.settled;
+		}
+		state.counters["settled"] = benchmark::Counter(static_cast<double>(settled),
+		                                               benchmark::Counter::kAvgIterations);
+	}
+} // namespace
+
+BENCHMARK_CAPTURE(build, degree, gdwg::landmark_selection::degree)
+   ->RangeMultiplier(2)
+   ->Range(1, 16)
+   ->UseRealTime();
+BENCHMARK_CAPTURE(build, farthest, gdwg::landmark_selection::farthest)
+   ->RangeMultiplier(2)
+   ->Range(1, 16)
+   ->UseRealTime();
+BENCHMARK(bounds);
+BENCHMARK_CAPTURE(astar, dijkstra, false);
+BENCHMARK_CAPTURE(astar, landmarks, true);
@@ -0,0 +1,50 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/matching.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+// Hopcroft-Karp on a bipartite graph made from a scale 18 R-MAT graph by sending every edge from
+// a worker copy of its source to a job copy of its target, about 4 million edges, and the
+// Hungarian algorithm on a dense 256 x 256 instance.
+
+namespace {
+	auto bipartite(unsigned scale, std::size_t edge_factor) -> gdwg::csr_graph<int, int> {
+		auto const g = gdwg::rmat_graph({.scale = scale,
+		                                 .edge_factor = edge_factor,
+		                                 .max_weight = 100,
+		                                 .seed = 6771});
+		auto const n = 1 << scale;
+		auto nodes = std::vector<int>(2 * static_cast<std::size_t>(n));
+		std::iota(nodes.begin(), nodes.end(), 0);
+		auto ret = gdwg::graph<int, int>(nodes.begin(), nodes.end());
+		auto edges = std::vector<gdwg::graph<int, int>::value_type>();
+		for (auto const& [from, to, weight] : g) {
+			edges.push_back({from, to + n, weight});
+		}
+		ret.insert_edges(edges.begin(), edges.end());
+		return gdwg::csr_graph<int, int>(ret, gdwg::csr_layout::outgoing);
+	}
+
+	auto hopcroft_karp(benchmark::State& state) -> void {
+		static auto const view = bipartite(18, 16);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::hopcroft_karp(view));
+		}
+	}
+
+	auto hungarian(benchmark::State& state) -> void {
+		static auto const view = bipartite(8, 64);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::hungarian(view));
+		}
+	}
+} // namespace
+
+BENCHMARK(hopcroft_karp)->Unit(benchmark::kMillisecond);
+BENCHMARK(hungarian)->Unit(benchmark::kMillisecond);
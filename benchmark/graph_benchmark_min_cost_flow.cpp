@@ -0,0 +1,43 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/min_cost_flow.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Maximum flow at least cost between the two busiest nodes of R-MAT graphs of scale 12 to 16,
+// capacities and costs drawn uniformly from [1, 100]. The value counter is the flow sent.
+
+namespace {
+	auto network(unsigned scale) -> gdwg::csr_graph<int, std::pair<int, int>> {
+		auto const g = gdwg::rmat_graph({.scale = scale, .edge_factor = 8, .seed = 6771});
+		auto rng = std::mt19937(6771);
+		auto draw = std::uniform_int_distribution<int>(1, 100);
+		auto nodes = g.nodes();
+		auto ret = gdwg::graph<int, std::pair<int, int>>(nodes.begin(), nodes.end());
+		for (auto const& [from, to, weight] : g) {
+			ret.insert_edge(from, to, {draw(rng), draw(rng)});
+		}
+		return gdwg::csr_graph<int, std::pair<int, int>>(ret, gdwg::csr_layout::outgoing);
+	}
+
+	auto solve(benchmark::State& state) -> void {
+		auto const view = network(static_cast<unsigned>(state.range(0)));
+		auto value = 0;
+		for (auto _ : state) {
+			auto const result = gdwg::min_cost_flow(view, 0, 1);
+			value = result.value;
+			benchmark::DoNotOptimize(result.cost);
+		}
+		state.counters["value"] = value;
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * view.num_edges()));
+	}
+} // namespace
+
+BENCHMARK(solve)->DenseRange(10, 14, 2)->Unit(benchmark::kMillisecond);
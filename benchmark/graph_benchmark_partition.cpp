@@ -0,0 +1,52 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/partition.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+// Multilevel partitioning of a scale 18 R-MAT graph (about two million edges) into 2 to 64
+// parts, and into 16 parts over one to eight threads. The cut is reported as a fraction of the
+// total edge weight.
+
+namespace {
+	auto view() -> gdwg::csr_graph<int, int> const& {
+		static auto const g = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 18, .edge_factor = 8, .max_weight = 100, .seed = 6771}),
+		   gdwg::csr_layout::outgoing);
+		return g;
+	}
+
+	auto total_weight() -> double {
+		auto ret = 0.0;
+		for (auto const w : view().weights()) {
+			ret += w;
+		}
+		return ret;
+	}
+
+	auto partition(benchmark::State& state, std::size_t k, std::size_t threads) -> void {
+		auto const& g = view();
+		auto result = gdwg::partition_result{};
+		for (auto _ : state) {
+			result = gdwg::multilevel_partition(g, k, {.threads = threads});
+			benchmark::DoNotOptimize(result.part.data());
+		}
+		state.counters["cut"] = result.cut / total_weight();
+		state.counters["levels"] = static_cast<double>(result.levels);
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * g.num_edges()));
+	}
+
+	auto parts(benchmark::State& state) -> void {
+		partition(state, static_cast<std::size_t>(state.range(0)), 0);
+	}
+
+	auto threads(benchmark::State& state) -> void {
+		partition(state, 16, static_cast<std::size_t>(state.range(0)));
+	}
+} // namespace
+
+BENCHMARK(parts)->RangeMultiplier(4)->Range(2, 64)->Unit(benchmark::kMillisecond);
+BENCHMARK(threads)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,54 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/pagerank.hpp"
+#include "gdwg/personalized_pagerank.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+// Personalized PageRank from random seeds of a scale 18 R-MAT graph by forward push, for a range
+// of tolerances, against one global power iteration for scale. The pushes counter is the average
+// number of nodes a query pushed from.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 18, .edge_factor = 8, .max_weight = 100, .seed = 6771}));
+		return view;
+	}
+
+	auto push(benchmark::State& state) -> void {
+		auto const& view = rmat_view();
+		auto const options = gdwg::personalized_pagerank_options{
+		   .tolerance = 1.0 / static_cast<double>(state.range(0)),
+		};
+		auto ws = gdwg::personalized_pagerank_workspace(view.num_nodes());
+		auto result = gdwg::personalized_pagerank_result{};
+		auto rng = std::mt19937(6771);
+		auto pick = std::uniform_int_distribution<gdwg::node_id>(
+		   0,
+		   static_cast<gdwg::node_id>(view.num_nodes() - 1));
+		auto pushes = std::size_t{0};
+		for (auto _ : state) {
+			gdwg::personalized_pagerank(view, pick(rng), options, ws, result);
+			pushes += result.pushes;
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+		state.counters["pushes"] = benchmark::Counter(static_cast<double>(pushes),
+		                                              benchmark::Counter::kAvgIterations);
+	}
+
+	auto power_iteration(benchmark::State& state) -> void {
+		auto const& view = rmat_view();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::pagerank(view, {.tolerance = 1e-6, .threads = 1}));
+		}
+	}
+} // namespace
+
+BENCHMARK(push)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(power_iteration)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,56 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/random_walk.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// One walk of length 80 from every node of a scale 16 R-MAT graph, uniform, weighted and
+// node2vec, with 1, 2, 4, 8 and 16 threads. The sink only adds up the last nodes so the walks
+// aren't optimised away.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 16, .edge_factor = 16, .max_weight = 100, .seed = 6771}),
+		   gdwg::csr_layout::outgoing);
+		return view;
+	}
+
+	auto random_walks(benchmark::State& state, bool weighted, double p, double q) -> void {
+		auto const& view = rmat_view();
+		auto const options = gdwg::walk_options{
+		   .length = 80,
+		   .walks_per_node = 1,
+		   .weighted = weighted,
+		   .p = p,
+		   .q = q,
+		   .threads = static_cast<std::size_t>(state.range(0)),
+		};
+		auto sum = std::atomic<std::size_t>(0);
+		for (auto _ : state) {
+			gdwg::random_walks(view, options, [&](std::size_t, std::span<gdwg::node_id const> nodes) {
+				sum.fetch_add(nodes.back(), std::memory_order_relaxed);
+			});
+		}
+		benchmark::DoNotOptimize(sum.load());
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(view.num_nodes()));
+	}
+} // namespace
+
+BENCHMARK_CAPTURE(random_walks, uniform, false, 1.0, 1.0)
+   ->RangeMultiplier(2)
+   ->Range(1, 16)
+   ->UseRealTime();
+BENCHMARK_CAPTURE(random_walks, weighted, true, 1.0, 1.0)
+   ->RangeMultiplier(2)
+   ->Range(1, 16)
+   ->UseRealTime();
+BENCHMARK_CAPTURE(random_walks, node2vec, false, 0.5, 2.0)
+   ->RangeMultiplier(2)
+   ->Range(1, 16)
+   ->UseRealTime();
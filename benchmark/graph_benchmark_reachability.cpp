@@ -0,0 +1,63 @@
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/reachability.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// is_reachable between random pairs of a scale 16 R-MAT graph, as generated (one giant component
+// and many small ones) and with every edge turned to point from the lower node to the higher
+// one, which leaves a DAG of 2^16 components. Building the index is measured separately.
+
+namespace {
+	auto rmat(bool dag) -> gdwg::graph<int, int> {
+		auto g = gdwg::rmat_graph({.scale = 16, .edge_factor = 8, .seed = 6771});
+		if (!dag) {
+			return g;
+		}
+		auto nodes = g.nodes();
+		auto ret = gdwg::graph<int, int>(nodes.begin(), nodes.end());
+		for (auto const& [from, to, weight] : g) {
+			if (from != to) {
+				ret.insert_edge(std::min(from, to), std::max(from, to), weight);
+			}
+		}
+		return ret;
+	}
+
+	auto build(benchmark::State& state, bool dag) -> void {
+		auto g = rmat(dag);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::reachability_index<int, int>(g));
+		}
+	}
+
+	auto query(benchmark::State& state, bool dag) -> void {
+		auto g = rmat(dag);
+		auto const index = gdwg::reachability_index<int, int>(g);
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(0, (1 << 16) - 1);
+		auto pairs = std::vector<std::pair<int, int>>(4096);
+		for (auto& [src, dst] : pairs) {
+			src = node(rng);
+			dst = node(rng);
+		}
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto const& [src, dst] = pairs[i++ % pairs.size()];
+			benchmark::DoNotOptimize(index.is_reachable(src, dst));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+} // namespace
+
+BENCHMARK_CAPTURE(build, rmat, false)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(build, dag, true)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(query, rmat, false);
+BENCHMARK_CAPTURE(query, dag, true);
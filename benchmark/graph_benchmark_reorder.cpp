@@ -0,0 +1,66 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/pagerank.hpp"
+#include "gdwg/reorder.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Node reordering of a scale 18 R-MAT graph whose ids were shuffled first, as they would be for
+// keys that sort in no useful order: how long each order takes to find, and twenty PageRank
+// iterations on one thread over the shuffled graph and over each reordered copy.
+
+namespace {
+	auto shuffled_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = [] {
+			auto const g = gdwg::csr_graph<int, int>(
+			   gdwg::rmat_graph({.scale = 18, .edge_factor = 8, .max_weight = 100, .seed = 6771}));
+			auto order = std::vector<gdwg::node_id>(g.num_nodes());
+			std::iota(order.begin(), order.end(), gdwg::node_id{0});
+			std::shuffle(order.begin(), order.end(), std::mt19937(6771));
+			return g.reordered(order);
+		}();
+		return view;
+	}
+
+	auto order(benchmark::State& state, gdwg::reorder_method method) -> void {
+		auto const& view = shuffled_view();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::reorder(view, method));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * view.num_edges()));
+	}
+
+	auto pagerank(benchmark::State& state, bool reorder, gdwg::reorder_method method) -> void {
+		auto const& shuffled = shuffled_view();
+		auto const view = reorder ? gdwg::reorder(shuffled, method) : shuffled;
+		auto const options = gdwg::pagerank_options{.tolerance = 0.0,
+		                                            .max_iterations = 20,
+		                                            .threads = 1};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::pagerank(view, options));
+		}
+		state.SetItemsProcessed(
+		   static_cast<std::int64_t>(state.iterations() * view.num_edges() * 20));
+	}
+} // namespace
+
+BENCHMARK_CAPTURE(order, rcm, gdwg::reorder_method::reverse_cuthill_mckee)
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(order, hub_sort, gdwg::reorder_method::hub_sort)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(order, gorder, gdwg::reorder_method::gorder)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(pagerank, shuffled, false, gdwg::reorder_method::hub_sort)
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(pagerank, rcm, true, gdwg::reorder_method::reverse_cuthill_mckee)
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(pagerank, hub_sort, true, gdwg::reorder_method::hub_sort)
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(pagerank, gorder, true, gdwg::reorder_method::gorder)
+   ->Unit(benchmark::kMillisecond);
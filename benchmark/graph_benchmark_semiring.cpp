@@ -0,0 +1,60 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/semiring.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Kernels over a scale 18 R-MAT graph on 1 to 16 threads: a dense plus-times x A as in a PageRank
+// iteration, a dense min-plus x A as in a Bellman-Ford round, and a whole breadth first search
+// from node 0 as or-and frontier expansions masked by the visited set. Items are edges.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 18, .edge_factor = 16, .max_weight = 100, .seed = 6771}));
+		return view;
+	}
+
+	template<typename S>
+	auto dense(benchmark::State& state) -> void {
+		using T = typename S::value_type;
+		auto const& view = rmat_view();
+		auto ws = gdwg::spmv_workspace<T>(static_cast<std::size_t>(state.range(0)));
+		auto x = std::vector<T>(view.num_nodes(), S::one());
+		auto y = std::vector<T>(view.num_nodes());
+		for (auto _ : state) {
+			gdwg::vxm<S>(view, x, y, ws);
+			benchmark::DoNotOptimize(y.data());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * view.num_edges()));
+	}
+
+	auto bfs(benchmark::State& state) -> void {
+		auto const& view = rmat_view();
+		auto ws = gdwg::spmv_workspace<std::uint8_t>(static_cast<std::size_t>(state.range(0)));
+		auto visited = std::vector<char>(view.num_nodes());
+		for (auto _ : state) {
+			std::fill(visited.begin(), visited.end(), 0);
+			auto frontier = gdwg::sparse_vector<std::uint8_t>{{0}, {1}};
+			while (!frontier.indices.empty()) {
+				for (auto const u : frontier.indices) {
+					visited[u] = 1;
+				}
+				frontier = gdwg::vxm<gdwg::or_and>(view, frontier, ws, visited);
+			}
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * view.num_edges()));
+	}
+} // namespace
+
+BENCHMARK_TEMPLATE(dense, gdwg::plus_times<double>)
+   ->RangeMultiplier(2)
+   ->Range(1, 16)
+   ->UseRealTime();
+BENCHMARK_TEMPLATE(dense, gdwg::min_plus<int>)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(bfs)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
@@ -0,0 +1,37 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/spanning_forest.hpp"
+
+#include <benchmark/benchmark.h>
+
+// Minimum spanning forest of a scale 18 R-MAT graph with weights in [1, 1000]: Kruskal against
+// Boruvka with 1, 2, 4, 8 and 16 threads. Kruskal's sort dominates on large inputs, Boruvka only
+// needs O(log(n)) passes over the edges and splits each pass over the threads.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 18, .edge_factor = 16, .max_weight = 1000, .seed = 6771}));
+		return view;
+	}
+
+	auto kruskal(benchmark::State& state) -> void {
+		auto const& view = rmat_view();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::kruskal(view));
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(view.num_edges()));
+	}
+
+	auto boruvka(benchmark::State& state) -> void {
+		auto const& view = rmat_view();
+		auto const threads = static_cast<std::size_t>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::boruvka(view, threads));
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(view.num_edges()));
+	}
+} // namespace
+
+BENCHMARK(kruskal)->UseRealTime();
+BENCHMARK(boruvka)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
@@ -0,0 +1,42 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/subgraph_match.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+// Directed 4 cycles whose edges all weigh at least 50 in a scale 12 R-MAT graph with weights up
+// to 100, with 1, 2, 4, 8 and 16 threads. The sink only counts.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 12, .edge_factor = 8, .max_weight = 100, .seed = 6771}));
+		return view;
+	}
+
+	auto cycles(benchmark::State& state) -> void {
+		auto square = gdwg::graph<int, int>{0, 1, 2, 3};
+		square.insert_edge(0, 1, 50);
+		square.insert_edge(1, 2, 50);
+		square.insert_edge(2, 3, 50);
+		square.insert_edge(3, 0, 50);
+		auto const pattern = gdwg::csr_graph<int, int>(square);
+		auto const options = gdwg::subgraph_options{static_cast<std::size_t>(state.range(0))};
+		auto const at_least = [](int p, int t) { return t >= p; };
+		auto seen = std::atomic<std::size_t>(0);
+		for (auto _ : state) {
+			auto const sink = [&](std::span<gdwg::node_id const>) {
+				seen.fetch_add(1, std::memory_order_relaxed);
+			};
+			benchmark::DoNotOptimize(
+			   gdwg::subgraph_matches(pattern, rmat_view(), sink, options, {}, at_least));
+		}
+	}
+} // namespace
+
+BENCHMARK(cycles)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
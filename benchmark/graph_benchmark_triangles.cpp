@@ -0,0 +1,27 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/triangles.hpp"
+
+#include <benchmark/benchmark.h>
+
+// Triangle counting on a scale 18 R-MAT graph with 1, 2, 4, 8 and 16 threads. The skewed degrees
+// are what the degree ordering and the galloping intersection are there for.
+
+namespace {
+	auto rmat_view() -> gdwg::csr_graph<int, int> const& {
+		static auto const view = gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 18, .edge_factor = 16, .seed = 6771}));
+		return view;
+	}
+
+	auto count_triangles(benchmark::State& state) -> void {
+		auto const& view = rmat_view();
+		auto const threads = static_cast<std::size_t>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::count_triangles(view, {.threads = threads}));
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(view.num_edges()));
+	}
+} // namespace
+
+BENCHMARK(count_triangles)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
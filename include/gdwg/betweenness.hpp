@@ -0,0 +1,252 @@
+#ifndef GDWG_BETWEENNESS_HPP
+#define GDWG_BETWEENNESS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct betweenness_options {
+		// false counts every edge as length 1 and searches breadth first
+		bool weighted = true;
+		// divide by (n - 1)(n - 2), the number of ordered pairs that don't include the node
+		bool normalized = false;
+		// 0 runs from every source and is exact, otherwise this many sources are sampled
+		std::size_t samples = 0;
+		// chance that every sampled score is within error_bound of the exact one
+		double confidence = 0.95;
+		std::uint64_t seed = 6771;
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+	};
+
+	// centrality[u] is the betweenness of node id u over ordered pairs of other nodes. When
+	// sources were sampled the scores are scaled up to estimate the exact ones and error_bound is
+	// a Hoeffding bound on how far any of them can be off at the requested confidence.
+	struct betweenness_result {
+		std::vector<double> centrality;
+		std::size_t sources = 0;
+		bool exact = true;
+		double error_bound = 0.0;
+	};
+
+	// Sources needed for every normalized score of an n node graph to be within error of the exact
+	// one with the given confidence, from Hoeffding's inequality and a union bound over the nodes.
+	inline auto betweenness_sample_size(std::size_t num_nodes, double error, double confidence)
+	   -> std::size_t {
+		if (num_nodes < 3) {
+			return num_nodes;
+		}
+		auto const n = static_cast<double>(num_nodes);
+		auto const scale = n / (n - 1.0);
+		auto const k = scale * scale * std::log(2.0 * n / (1.0 - confidence)) / (2.0 * error * error);
+		return std::min(num_nodes, static_cast<std::size_t>(std::ceil(k)));
+	}
+
+	namespace detail {
+		// Per thread state of Brandes' algorithm. Only the nodes a search reached are reset after
+		// it, so a source costs time in the part of the graph it can see.
+		template<typename E>
+		struct brandes_workspace {
+			std::vector<E> dist;
+			std::vector<double> sigma;
+			std::vector<double> delta;
+			std::vector<char> reached;
+			std::vector<char> settled;
+			std::vector<node_id> order;
+			std::vector<std::pair<E, node_id>> heap;
+			std::vector<double> centrality;
+
+			explicit brandes_workspace(std::size_t n)
+			: dist(n)
+			, sigma(n, 0.0)
+			, delta(n, 0.0)
+			, reached(n, 0)
+			, settled(n, 0)
+			, centrality(n, 0.0) {}
+		};
+
+		// Calls fn(v, w) once per distinct target v of u with the lightest weight w of the edges to
+		// it. Rows are sorted by (dst, weight) so the first edge to each target is the lightest.
+		template<typename N, typename E, typename F>
+		auto for_each_lightest(csr_graph<N, E> const& g, node_id u, F&& fn) -> void {
+			auto const out = g.out_targets(u);
+			auto const weights = g.out_weights(u);
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				if (i == 0 || out[i] != out[i - 1]) {
+					fn(out[i], weights[i]);
+				}
+			}
+		}
+
+		// Shortest path counts from s into ws.order, in order of distance, then the dependencies
+		// accumulated back to front. Parallel edges don't add paths: paths are sequences of nodes.
+		template<typename N, typename E>
+		auto brandes_source(csr_graph<N, E> const& g,
+		                    node_id s,
+		                    bool weighted,
+		                    brandes_workspace<E>& ws) -> void {
+			using entry = std::pair<E, node_id>;
+			auto const step = [weighted](E const& w) { return weighted ? w : E{1}; };
+			ws.order.clear();
+			ws.dist[s] = E{};
+			ws.sigma[s] = 1.0;
+			ws.reached[s] = 1;
+			if (weighted) {
+				ws.heap.assign(1, entry{E{}, s});
+				while (!ws.heap.empty()) {
+					std::pop_heap(ws.heap.begin(), ws.heap.end(), std::greater<>());
+					auto const [d, u] = ws.heap.back();
+					ws.heap.pop_back();
+					if (ws.settled[u] != 0) {
+						continue;
+					}
+					ws.settled[u] = 1;
+					ws.order.push_back(u);
+					for_each_lightest(g, u, [&](node_id v, E const& w) {
+						auto const candidate = d + w;
+						if (ws.reached[v] == 0 || candidate < ws.dist[v]) {
+							ws.reached[v] = 1;
+							ws.dist[v] = candidate;
+							ws.sigma[v] = ws.sigma[u];
+							ws.heap.push_back({candidate, v});
+							std::push_heap(ws.heap.begin(), ws.heap.end(), std::greater<>());
+						}
+						else if (candidate == ws.dist[v]) {
+							ws.sigma[v] += ws.sigma[u];
+						}
+					});
+				}
+			}
+			else {
+				// the order doubles as the breadth first queue
+				ws.order.push_back(s);
+				for (auto i = std::size_t{0}; i < ws.order.size(); ++i) {
+					auto const u = ws.order[i];
+					for_each_lightest(g, u, [&](node_id v, E const&) {
+						if (ws.reached[v] == 0) {
+							ws.reached[v] = 1;
+							ws.dist[v] = ws.dist[u] + E{1};
+							ws.order.push_back(v);
+						}
+						if (ws.dist[v] == ws.dist[u] + E{1}) {
+							ws.sigma[v] += ws.sigma[u];
+						}
+					});
+				}
+			}
+
+			for (auto i = ws.order.size(); i-- > 0;) {
+				auto const u = ws.order[i];
+				for_each_lightest(g, u, [&](node_id v, E const& w) {
+					if (ws.reached[v] != 0 && ws.dist[v] == ws.dist[u] + step(w)) {
+						ws.delta[u] += ws.sigma[u] / ws.sigma[v] * (1.0 + ws.delta[v]);
+					}
+				});
+				if (u != s) {
+					ws.centrality[u] += ws.delta[u];
+				}
+			}
+			for (auto const u : ws.order) {
+				ws.sigma[u] = 0.0;
+				ws.delta[u] = 0.0;
+				ws.reached[u] = 0;
+				ws.settled[u] = 0;
+			}
+		}
+	} // namespace detail
+
+	// Brandes' algorithm, one breadth first search or Dijkstra per source followed by a backwards
+	// sweep that adds up the dependencies. Threads take sources from a shared counter and add into
+	// their own arrays, which are summed at the end. Weighted runs need positive weights.
+	template<typename N, typename E>
+	auto betweenness(csr_graph<N, E> const& g, betweenness_options const& options = {})
+	   -> betweenness_result {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::betweenness requires arithmetic edge weights");
+		auto const positive = [](E const& w) { return E{} < w; };
+		if (options.weighted && !std::all_of(g.weights().begin(), g.weights().end(), positive)) {
+			throw std::runtime_error("Cannot call gdwg::betweenness on a graph with non-positive edge "
+			                         "weights");
+		}
+		if (options.samples != 0 && !(options.confidence > 0.0 && options.confidence < 1.0)) {
+			throw std::runtime_error("Cannot call gdwg::betweenness with a confidence outside (0, 1)");
+		}
+		auto const n = g.num_nodes();
+		auto ret = betweenness_result{};
+		ret.centrality.assign(n, 0.0);
+
+		auto sources = std::vector<node_id>(n);
+		std::iota(sources.begin(), sources.end(), node_id{0});
+		if (options.samples != 0 && options.samples < n) {
+			// the first samples entries of a partial Fisher-Yates shuffle
+			auto rng = std::mt19937_64(options.seed);
+			for (auto i = std::size_t{0}; i < options.samples; ++i) {
+				auto pick = std::uniform_int_distribution<std::size_t>(i, n - 1);
+				std::swap(sources[i], sources[pick(rng)]);
+			}
+			sources.resize(options.samples);
+			ret.exact = false;
+		}
+		ret.sources = sources.size();
+
+		auto pool = detail::thread_pool(options.threads);
+		auto workspaces = std::vector<detail::brandes_workspace<E>>();
+		workspaces.reserve(pool.size());
+		for (auto t = std::size_t{0}; t < pool.size(); ++t) {
+			workspaces.emplace_back(n);
+		}
+		auto next = std::atomic<std::size_t>(0);
+		pool.parallel_for(pool.size(), [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto t = first; t < last; ++t) {
+				for (auto i = next.fetch_add(1); i < sources.size(); i = next.fetch_add(1)) {
+					detail::brandes_source(g, sources[i], options.weighted, workspaces[t]);
+				}
+			}
+		});
+
+		auto scale = 1.0;
+		if (!ret.exact) {
+			auto const nodes = static_cast<double>(n);
+			auto const k = static_cast<double>(ret.sources);
+			scale = nodes / k;
+			auto const failure = 1.0 - options.confidence;
+			ret.error_bound = nodes * (nodes - 2.0)
+			                  * std::sqrt(std::log(2.0 * nodes / failure) / (2.0 * k));
+		}
+		if (options.normalized && n > 2) {
+			auto const pairs = static_cast<double>(n - 1) * static_cast<double>(n - 2);
+			scale /= pairs;
+			ret.error_bound /= pairs;
+		}
+		pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+			for (auto u = begin; u < end; ++u) {
+				for (auto const& ws : workspaces) {
+					ret.centrality[u] += ws.centrality[u];
+				}
+				ret.centrality[u] *= scale;
+			}
+		});
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto betweenness(graph<N, E> const& g, betweenness_options const& options = {})
+	   -> betweenness_result {
+		return betweenness(csr_graph<N, E>(g, csr_layout::outgoing), options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_BETWEENNESS_HPP
@@ -0,0 +1,180 @@
+#ifndef GDWG_CONNECTED_COMPONENTS_HPP
+#define GDWG_CONNECTED_COMPONENTS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/scc.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace gdwg {
+	// component[u] is the weakly connected component of node id u, ids are numbered in order of
+	// each component's smallest node. sizes[c] is the number of nodes in component c.
+	struct components_result {
+		std::vector<component_id> component;
+		std::vector<std::size_t> sizes;
+	};
+
+	struct components_options {
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+		// edges per node linked before sampling for the giant component
+		std::size_t neighbour_rounds = 2;
+		std::size_t samples = 1024;
+		std::uint64_t seed = 6771;
+	};
+
+	namespace detail {
+		// Lock free union-find where a root only ever gets pointed at a smaller id, so concurrent
+		// links can't form a cycle. Relaxed ordering is enough: parents only ever decrease and the
+		// thread pool synchronises between phases.
+		class concurrent_union_find {
+		public:
+			explicit concurrent_union_find(std::size_t n)
+			: parent_(n) {
+				for (auto i = std::size_t{0}; i < n; ++i) {
+					parent_[i].store(static_cast<node_id>(i), std::memory_order_relaxed);
+				}
+			}
+
+			auto link(node_id u, node_id v) noexcept -> void {
+				auto p1 = load(u);
+				auto p2 = load(v);
+				while (p1 != p2) {
+					auto const high = std::max(p1, p2);
+					auto const low = std::min(p1, p2);
+					auto parent_high = load(high);
+					if (parent_high == low) {
+						return;
+					}
+					if (parent_high == high
+					    && parent_[high].compare_exchange_strong(parent_high,
+					                                             low,
+					                                             std::memory_order_relaxed))
+					{
+						return;
+					}
+					p1 = load(load(high));
+					p2 = load(low);
+				}
+			}
+
+			// point u straight at its root
+			auto compress(node_id u) noexcept -> void {
+				while (load(u) != load(load(u))) {
+					parent_[u].store(load(load(u)), std::memory_order_relaxed);
+				}
+			}
+
+			[[nodiscard]] auto find(node_id u) const noexcept -> node_id {
+				while (load(u) != u) {
+					u = load(u);
+				}
+				return u;
+			}
+
+			[[nodiscard]] auto load(node_id u) const noexcept -> node_id {
+				return parent_[u].load(std::memory_order_relaxed);
+			}
+
+		private:
+			std::vector<std::atomic<node_id>> parent_;
+		};
+	} // namespace detail
+
+	// Afforest: link the first few edges of every node, find the component most random nodes
+	// already belong to (the giant one in real graphs), then only finish the edges of nodes outside
+	// it. Edge direction is ignored; both incoming and outgoing edges are used so skipping the
+	// giant component's nodes never loses a link.
+	template<typename N, typename E>
+	auto weakly_connected_components(csr_graph<N, E> const& g,
+	                                 components_options const& options = {}) -> components_result {
+		if (!g.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::weakly_connected_components on a csr_graph "
+			                         "built without incoming edges");
+		}
+		auto const n = g.num_nodes();
+		auto ret = components_result{};
+		if (n == 0) {
+			return ret;
+		}
+		auto pool = detail::thread_pool(options.threads);
+		auto sets = detail::concurrent_union_find(n);
+		// the r-th neighbour of u, outgoing edges first
+		auto const neighbour = [&g](node_id u, std::size_t r) {
+			auto const out = g.out_degree(u);
+			return r < out ? g.out_targets(u)[r] : g.in_sources(u)[r - out];
+		};
+		auto const degree = [&g](node_id u) { return g.out_degree(u) + g.in_degree(u); };
+		auto const compress_all = [&] {
+			pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+				for (auto u = begin; u < end; ++u) {
+					sets.compress(static_cast<node_id>(u));
+				}
+			});
+		};
+
+		for (auto r = std::size_t{0}; r < options.neighbour_rounds; ++r) {
+			pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+				for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+					if (r < degree(u)) {
+						sets.link(u, neighbour(u, r));
+					}
+				}
+			});
+			compress_all();
+		}
+
+		auto rng = std::mt19937_64(options.seed);
+		auto pick = std::uniform_int_distribution<node_id>(0, static_cast<node_id>(n - 1));
+		auto counts = std::unordered_map<node_id, std::size_t>();
+		for (auto i = std::size_t{0}; i < options.samples; ++i) {
+			++counts[sets.load(pick(rng))];
+		}
+		auto const by_count = [](auto const& lhs, auto const& rhs) { return lhs.second < rhs.second; };
+		auto const giant = std::max_element(counts.begin(), counts.end(), by_count)->first;
+
+		pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+			for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+				if (sets.find(u) == giant) {
+					continue;
+				}
+				for (auto r = options.neighbour_rounds; r < degree(u); ++r) {
+					sets.link(u, neighbour(u, r));
+				}
+			}
+		});
+		compress_all();
+
+		// roots are the smallest node of their set, so a single pass numbers them in order
+		auto constexpr unassigned = std::numeric_limits<component_id>::max();
+		ret.component.assign(n, unassigned);
+		for (auto u = node_id{0}; u < n; ++u) {
+			auto const root = sets.load(u);
+			if (root == u) {
+				ret.component[u] = static_cast<component_id>(ret.sizes.size());
+				ret.sizes.push_back(0);
+			}
+			ret.component[u] = ret.component[root];
+			++ret.sizes[ret.component[u]];
+		}
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto weakly_connected_components(graph<N, E> const& g, components_options const& options = {})
+	   -> components_result {
+		return weakly_connected_components(csr_graph<N, E>(g), options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_CONNECTED_COMPONENTS_HPP
@@ -0,0 +1,519 @@
+#ifndef GDWG_CONTRACTION_HIERARCHY_HPP
+#define GDWG_CONTRACTION_HIERARCHY_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	namespace detail {
+		// middle node of an arc that is an edge of the original graph rather than a shortcut
+		inline constexpr auto no_middle = std::numeric_limits<node_id>::max();
+
+		template<typename E>
+		struct ch_arc {
+			node_id node;
+			E weight;
+			node_id middle;
+		};
+	} // namespace detail
+
+	// Contraction hierarchy over a static graph. Nodes are contracted one at a time in order of
+	// edge difference, adding a shortcut u -> w through v only when a bounded witness search finds
+	// no path from u to w at most as short. Afterwards every query is a bidirectional Dijkstra that
+	// only follows arcs going up in contraction order, which settles a few hundred nodes even on
+	// large road graphs. Parallel edges collapse to the lightest one and self loops are dropped.
+	template<typename N, typename E>
+	class contraction_hierarchy {
+	public:
+		// witness searches give up after settling this many nodes and keep the shortcut instead
+		static constexpr auto witness_settle_limit = std::size_t{500};
+
+		contraction_hierarchy() = default;
+
+		explicit contraction_hierarchy(graph<N, E> const& g)
+		: contraction_hierarchy(csr_graph<N, E>(g, csr_layout::outgoing)) {}
+
+		explicit contraction_hierarchy(csr_graph<N, E> const& g) {
+			static_assert(std::is_arithmetic_v<E>,
+			              "gdwg::contraction_hierarchy requires arithmetic edge weights");
+			nodes_ = g.nodes();
+			by_value_ = detail::ids_by_value(nodes_);
+			build(g);
+		}
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		// number of arcs added on top of the (deduplicated) original edges
+		[[nodiscard]] auto num_shortcuts() const noexcept -> std::size_t {
+			return num_shortcuts_;
+		}
+
+		// position of u in the contraction order, higher ranks were contracted later
+		[[nodiscard]] auto rank(node_id u) const noexcept -> std::uint32_t {
+			return rank_[u];
+		}
+
+		// the ids are those of the csr_graph it was built from
+		[[nodiscard]] auto find(N const& value) const -> std::optional<node_id> {
+			return detail::find_by_value(nodes_, by_value_, value);
+		}
+
+		// Upward bidirectional search. On success ws.path() gives the path through the hierarchy,
+		// which unpack turns back into a path of the original graph.
+		auto query(node_id src, node_id dst, search_workspace<E>& ws) const -> search_result<E> {
+			ws.start(nodes_.size(), src, dst, true);
+			auto const epoch = ws.epoch();
+			auto& fwd = ws.forward();
+			auto& bwd = ws.backward();
+			auto& stats = ws.mutable_stats();
+
+			fwd.label(src, E{}, src, epoch);
+			bwd.label(dst, E{}, dst, epoch);
+			if (src == dst) {
+				ws.finish(true, src);
+				return {true, E{}, stats};
+			}
+			fwd.push({E{}, E{}, src});
+			bwd.push({E{}, E{}, dst});
+			stats.pushed += 2;
+
+			auto found = false;
+			auto best = E{};
+			auto meet = dst;
+			while (!fwd.heap.empty() || !bwd.heap.empty()) {
+				auto const is_forward =
+				   !fwd.heap.empty() && (bwd.heap.empty() || fwd.top_key() <= bwd.top_key());
+				auto& self = is_forward ? fwd : bwd;
+				auto& other = is_forward ? bwd : fwd;
+				// unlike plain bidirectional dijkstra each side has to run until it alone can't
+				// beat the best path, since the apex can be anywhere above both ends
+				if (found && self.top_key() >= best) {
+					self.heap.clear();
+					continue;
+				}
+				auto const top = self.pop();
+				if (top.dist != self.dist[top.node] || self.is_settled(top.node, epoch)) {
+					continue;
+				}
+				self.settled[top.node] = epoch;
+				++stats.settled;
+
+				auto const& offsets = is_forward ? up_offsets_ : down_offsets_;
+				auto const& nodes = is_forward ? up_nodes_ : down_nodes_;
+				auto const& weights = is_forward ? up_weights_ : down_weights_;
+				for (auto k = offsets[top.node]; k < offsets[top.node + 1]; ++k) {
+					++stats.relaxed;
+					auto const v = nodes[k];
+					auto const d = top.dist + weights[k];
+					if (!self.is_reached(v, epoch) || d < self.dist[v]) {
+						self.label(v, d, top.node, epoch);
+						self.push({d, d, v});
+						++stats.pushed;
+						if (other.is_reached(v, epoch) && (!found || d + other.dist[v] < best)) {
+							found = true;
+							best = d + other.dist[v];
+							meet = v;
+						}
+					}
+				}
+			}
+			ws.finish(found, meet);
+			return {found, found ? best : E{}, stats};
+		}
+
+		// expands every shortcut in a path through the hierarchy, writing the original path to out
+		auto unpack(std::vector<node_id> const& hierarchy_path, std::vector<node_id>& out) const
+		   -> void {
+			out.clear();
+			if (hierarchy_path.empty()) {
+				return;
+			}
+			out.push_back(hierarchy_path.front());
+			auto pending = std::vector<std::pair<node_id, node_id>>();
+			for (auto i = hierarchy_path.size() - 1; i > 0; --i) {
+				pending.emplace_back(hierarchy_path[i - 1], hierarchy_path[i]);
+			}
+			while (!pending.empty()) {
+				auto const [from, to] = pending.back();
+				pending.pop_back();
+				auto const middle = arc_middle(from, to);
+				if (middle == detail::no_middle) {
+					out.push_back(to);
+				}
+				else {
+					pending.emplace_back(middle, to);
+					pending.emplace_back(from, middle);
+				}
+			}
+		}
+
+		// One off query by node value. Keep a search_workspace and use the id overload when
+		// answering many queries.
+		[[nodiscard]] auto query(N const& src, N const& dst) const -> path_result<N, E> {
+			auto const s = find(src);
+			auto const t = find(dst);
+			if (!s || !t) {
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::query if src "
+				                         "or dst node don't exist in the graph");
+			}
+			auto ws = search_workspace<E>(nodes_.size());
+			auto const result = query(*s, *t, ws);
+			auto ret = path_result<N, E>{result.found, result.distance, {}, result.stats};
+			auto hierarchy_path = std::vector<node_id>();
+			auto ids = std::vector<node_id>();
+			ws.path(hierarchy_path);
+			unpack(hierarchy_path, ids);
+			std::transform(ids.begin(), ids.end(), std::back_inserter(ret.nodes), [&](node_id u) {
+				return nodes_[u];
+			});
+			return ret;
+		}
+
+		// the original edges plus every shortcut, as a graph
+		[[nodiscard]] auto shortcut_graph() const -> graph<N, E> {
+			auto ret = graph<N, E>(nodes_.begin(), nodes_.end());
+			for (auto u = node_id{0}; u < nodes_.size(); ++u) {
+				for (auto k = up_offsets_[u]; k < up_offsets_[u + 1]; ++k) {
+					ret.insert_edge(nodes_[u], nodes_[up_nodes_[k]], up_weights_[k]);
+				}
+				for (auto k = down_offsets_[u]; k < down_offsets_[u + 1]; ++k) {
+					ret.insert_edge(nodes_[down_nodes_[k]], nodes_[u], down_weights_[k]);
+				}
+			}
+			return ret;
+		}
+
+		// Binary image of the preprocessed hierarchy in native byte order, so a service can load it
+		// at startup instead of contracting again. N and E have to be trivially copyable.
+		auto save(std::ostream& os) const -> void {
+			static_assert(std::is_trivially_copyable_v<N> && std::is_trivially_copyable_v<E>,
+			              "gdwg::contraction_hierarchy<N, E>::save requires trivially copyable N and E");
+			os.write(magic.data(), magic.size());
+			write_value(os, static_cast<std::uint32_t>(sizeof(N)));
+			write_value(os, static_cast<std::uint32_t>(sizeof(E)));
+			write_value(os, static_cast<std::uint64_t>(num_shortcuts_));
+			write_vector(os, nodes_);
+			write_vector(os, rank_);
+			write_vector(os, up_offsets_);
+			write_vector(os, up_nodes_);
+			write_vector(os, up_weights_);
+			write_vector(os, up_middles_);
+			write_vector(os, down_offsets_);
+			write_vector(os, down_nodes_);
+			write_vector(os, down_weights_);
+			write_vector(os, down_middles_);
+		}
+
+		[[nodiscard]] static auto load(std::istream& is) -> contraction_hierarchy {
+			static_assert(std::is_trivially_copyable_v<N> && std::is_trivially_copyable_v<E>,
+			              "gdwg::contraction_hierarchy<N, E>::load requires trivially copyable N and E");
+			auto header = std::array<char, magic.size()>();
+			is.read(header.data(), header.size());
+			auto ret = contraction_hierarchy();
+			if (!is || header != magic || read_value<std::uint32_t>(is) != sizeof(N)
+			    || read_value<std::uint32_t>(is) != sizeof(E))
+			{
+				throw_bad_stream();
+			}
+			ret.num_shortcuts_ = static_cast<std::size_t>(read_value<std::uint64_t>(is));
+			read_vector(is, ret.nodes_);
+			read_vector(is, ret.rank_);
+			read_vector(is, ret.up_offsets_);
+			read_vector(is, ret.up_nodes_);
+			read_vector(is, ret.up_weights_);
+			read_vector(is, ret.up_middles_);
+			read_vector(is, ret.down_offsets_);
+			read_vector(is, ret.down_nodes_);
+			read_vector(is, ret.down_weights_);
+			read_vector(is, ret.down_middles_);
+			auto const n = ret.nodes_.size();
+			if (!is || ret.rank_.size() != n || ret.up_offsets_.size() != n + 1
+			    || ret.down_offsets_.size() != n + 1 || ret.up_offsets_.back() != ret.up_nodes_.size()
+			    || ret.down_offsets_.back() != ret.down_nodes_.size())
+			{
+				throw_bad_stream();
+			}
+			ret.by_value_ = detail::ids_by_value(ret.nodes_);
+			return ret;
+		}
+
+	private:
+		static constexpr auto magic = std::array<char, 8>{'G', 'D', 'W', 'G', 'C', 'H', '0', '1'};
+
+		std::vector<N> nodes_;
+		std::vector<node_id> by_value_;
+		std::vector<std::uint32_t> rank_;
+		std::size_t num_shortcuts_ = 0;
+		// arcs u -> v with rank[u] < rank[v], stored at u and searched forwards
+		std::vector<std::size_t> up_offsets_ = std::vector<std::size_t>(1, 0);
+		std::vector<node_id> up_nodes_;
+		std::vector<E> up_weights_;
+		std::vector<node_id> up_middles_;
+		// arcs u -> v with rank[u] > rank[v], stored at v and searched backwards
+		std::vector<std::size_t> down_offsets_ = std::vector<std::size_t>(1, 0);
+		std::vector<node_id> down_nodes_;
+		std::vector<E> down_weights_;
+		std::vector<node_id> down_middles_;
+
+		// the remaining graph while contracting, arcs to contracted nodes are removed eagerly
+		struct builder {
+			std::vector<std::vector<detail::ch_arc<E>>> out;
+			std::vector<std::vector<detail::ch_arc<E>>> in;
+			std::vector<std::uint32_t> deleted_neighbours;
+			// witness search scratch space
+			std::vector<E> dist;
+			std::vector<std::uint32_t> stamp;
+			std::uint32_t epoch = 0;
+			std::vector<std::pair<E, node_id>> heap;
+
+			// keeps only the lightest arc between two nodes
+			auto add_arc(node_id from, node_id to, E weight, node_id middle) -> bool {
+				auto& row = out[from];
+				auto it = std::find_if(row.begin(), row.end(), [to](auto const& a) {
+					return a.node == to;
+				});
+				if (it == row.end()) {
+					row.push_back({to, weight, middle});
+					in[to].push_back({from, weight, middle});
+					return true;
+				}
+				if (weight < it->weight) {
+					*it = {to, weight, middle};
+					auto& col = in[to];
+					*std::find_if(col.begin(), col.end(), [from](auto const& a) {
+						return a.node == from;
+					}) = {from, weight, middle};
+				}
+				return false;
+			}
+
+			// bounded dijkstra from src that never passes through skip
+			auto witness_search(node_id src, node_id skip, E limit) -> void {
+				if (++epoch == 0) {
+					std::fill(stamp.begin(), stamp.end(), 0);
+					epoch = 1;
+				}
+				heap.clear();
+				dist[src] = E{};
+				stamp[src] = epoch;
+				heap.emplace_back(E{}, src);
+				auto settled = std::size_t{0};
+				while (!heap.empty() && settled < witness_settle_limit) {
+					std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+					auto const [d, u] = heap.back();
+					heap.pop_back();
+					if (d != dist[u]) {
+						continue;
+					}
+					if (d > limit) {
+						break;
+					}
+					++settled;
+					for (auto const& a : out[u]) {
+						if (a.node == skip) {
+							continue;
+						}
+						auto const nd = d + a.weight;
+						if (stamp[a.node] != epoch || nd < dist[a.node]) {
+							dist[a.node] = nd;
+							stamp[a.node] = epoch;
+							heap.emplace_back(nd, a.node);
+							std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+						}
+					}
+				}
+			}
+
+			// the shortcuts (u, w, weight) contracting v needs
+			auto shortcuts(node_id v, std::vector<std::tuple<node_id, node_id, E>>& ret) -> void {
+				ret.clear();
+				for (auto const& in_arc : in[v]) {
+					auto max_out = std::optional<E>();
+					for (auto const& out_arc : out[v]) {
+						if (out_arc.node != in_arc.node && (!max_out || *max_out < out_arc.weight)) {
+							max_out = out_arc.weight;
+						}
+					}
+					if (!max_out) {
+						continue;
+					}
+					witness_search(in_arc.node, v, in_arc.weight + *max_out);
+					for (auto const& out_arc : out[v]) {
+						if (out_arc.node == in_arc.node) {
+							continue;
+						}
+						auto const d = in_arc.weight + out_arc.weight;
+						if (stamp[out_arc.node] != epoch || d < dist[out_arc.node]) {
+							ret.emplace_back(in_arc.node, out_arc.node, d);
+						}
+					}
+				}
+			}
+		};
+
+		auto build(csr_graph<N, E> const& g) -> void {
+			auto const n = g.num_nodes();
+			auto b = builder{};
+			b.out.resize(n);
+			b.in.resize(n);
+			b.deleted_neighbours.assign(n, 0);
+			b.dist.resize(n);
+			b.stamp.assign(n, 0);
+			for (auto u = node_id{0}; u < n; ++u) {
+				auto const targets = g.out_targets(u);
+				auto const weights = g.out_weights(u);
+				for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+					if (weights[k] < E{}) {
+						throw std::runtime_error("Cannot build a gdwg::contraction_hierarchy over a "
+						                         "graph with negative edge weights");
+					}
+					if (targets[k] != u) {
+						b.add_arc(u, targets[k], weights[k], detail::no_middle);
+					}
+				}
+			}
+
+			auto pending = std::vector<std::tuple<node_id, node_id, E>>();
+			auto const priority = [&](node_id v) {
+				b.shortcuts(v, pending);
+				return static_cast<long>(pending.size()) - static_cast<long>(b.in[v].size())
+				       - static_cast<long>(b.out[v].size())
+				       + static_cast<long>(b.deleted_neighbours[v]);
+			};
+			using entry = std::pair<long, node_id>;
+			auto queue = std::priority_queue<entry, std::vector<entry>, std::greater<>>();
+			for (auto v = node_id{0}; v < n; ++v) {
+				queue.emplace(priority(v), v);
+			}
+
+			auto up = std::vector<std::vector<detail::ch_arc<E>>>(n);
+			auto down = std::vector<std::vector<detail::ch_arc<E>>>(n);
+			auto contracted = std::vector<bool>(n, false);
+			rank_.assign(n, 0);
+			auto order = std::uint32_t{0};
+			while (!queue.empty()) {
+				auto const v = queue.top().second;
+				queue.pop();
+				if (contracted[v]) {
+					continue;
+				}
+				// lazy update, the priority may have gone up since it was pushed
+				auto const current = priority(v);
+				if (!queue.empty() && current > queue.top().first) {
+					queue.emplace(current, v);
+					continue;
+				}
+				// priority() left v's shortcuts in pending
+				for (auto const& a : b.in[v]) {
+					auto& row = b.out[a.node];
+					std::erase_if(row, [v](auto const& x) { return x.node == v; });
+					++b.deleted_neighbours[a.node];
+				}
+				for (auto const& a : b.out[v]) {
+					auto& col = b.in[a.node];
+					std::erase_if(col, [v](auto const& x) { return x.node == v; });
+					++b.deleted_neighbours[a.node];
+				}
+				for (auto const& [from, to, weight] : pending) {
+					if (b.add_arc(from, to, weight, v)) {
+						++num_shortcuts_;
+					}
+				}
+				up[v] = std::move(b.out[v]);
+				down[v] = std::move(b.in[v]);
+				b.out[v].clear();
+				b.in[v].clear();
+				contracted[v] = true;
+				rank_[v] = order++;
+			}
+			flatten(up, up_offsets_, up_nodes_, up_weights_, up_middles_);
+			flatten(down, down_offsets_, down_nodes_, down_weights_, down_middles_);
+		}
+
+		static auto flatten(std::vector<std::vector<detail::ch_arc<E>>> const& rows,
+		                    std::vector<std::size_t>& offsets,
+		                    std::vector<node_id>& nodes,
+		                    std::vector<E>& weights,
+		                    std::vector<node_id>& middles) -> void {
+			offsets.assign(1, 0);
+			for (auto const& row : rows) {
+				for (auto const& a : row) {
+					nodes.push_back(a.node);
+					weights.push_back(a.weight);
+					middles.push_back(a.middle);
+				}
+				offsets.push_back(nodes.size());
+			}
+		}
+
+		// an arc is stored at whichever end was contracted first
+		[[nodiscard]] auto arc_middle(node_id from, node_id to) const -> node_id {
+			auto const lower = rank_[from] < rank_[to] ? from : to;
+			auto const other = lower == from ? to : from;
+			auto const& offsets = lower == from ? up_offsets_ : down_offsets_;
+			auto const& nodes = lower == from ? up_nodes_ : down_nodes_;
+			auto const& middles = lower == from ? up_middles_ : down_middles_;
+			auto const first = nodes.begin() + static_cast<std::ptrdiff_t>(offsets[lower]);
+			auto const last = nodes.begin() + static_cast<std::ptrdiff_t>(offsets[lower + 1]);
+			return middles[static_cast<std::size_t>(std::find(first, last, other) - nodes.begin())];
+		}
+
+		template<typename T>
+		static auto write_value(std::ostream& os, T const& value) -> void {
+			os.write(reinterpret_cast<char const*>(&value), sizeof(T)); // NOLINT
+		}
+
+		template<typename T>
+		static auto write_vector(std::ostream& os, std::vector<T> const& values) -> void {
+			write_value(os, static_cast<std::uint64_t>(values.size()));
+			os.write(reinterpret_cast<char const*>(values.data()), // NOLINT
+			         static_cast<std::streamsize>(values.size() * sizeof(T)));
+		}
+
+		template<typename T>
+		static auto read_value(std::istream& is) -> T {
+			auto ret = T{};
+			is.read(reinterpret_cast<char*>(&ret), sizeof(T)); // NOLINT
+			return ret;
+		}
+
+		template<typename T>
+		static auto read_vector(std::istream& is, std::vector<T>& values) -> void {
+			auto const size = read_value<std::uint64_t>(is);
+			// a corrupt length must not turn into a huge allocation
+			if (!is || size > std::numeric_limits<std::uint32_t>::max() * std::uint64_t{8}) {
+				throw_bad_stream();
+			}
+			values.resize(static_cast<std::size_t>(size));
+			is.read(reinterpret_cast<char*>(values.data()), // NOLINT
+			        static_cast<std::streamsize>(values.size() * sizeof(T)));
+		}
+
+		[[noreturn]] static auto throw_bad_stream() -> void {
+			throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::load on a stream "
+			                         "that doesn't hold a contraction hierarchy");
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CONTRACTION_HIERARCHY_HPP
@@ -0,0 +1,382 @@
+#ifndef GDWG_CRITICAL_PATH_HPP
+#define GDWG_CRITICAL_PATH_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/topological_sort.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Schedule of a DAG whose edge u -> v of weight w says v can't start until w after u starts
+	// (u's duration, or a lag). Indexed by node id: earliest[u] is the soonest u can start with
+	// the first tasks starting at 0, latest[u] the last it can start without pushing back the end
+	// of the project at length, and slack[u] the difference. path is one critical path, every
+	// node on it without slack, from a node starting at 0 to one starting at length.
+	template<typename E>
+	struct critical_path_result {
+		E length = E{};
+		std::vector<E> earliest;
+		std::vector<E> latest;
+		std::vector<E> slack;
+		std::vector<node_id> path;
+	};
+
+	namespace detail {
+		template<typename E>
+		auto check_durations(std::span<E const> weights, std::string const& what) -> void {
+			static_assert(std::is_arithmetic_v<E>,
+			              "gdwg::critical_path requires arithmetic edge weights");
+			if (std::any_of(weights.begin(), weights.end(), [](E const& w) { return w < E{}; })) {
+				throw std::runtime_error(what + " with negative edge weights");
+			}
+		}
+
+		// Walks back from the node starting last (the smallest id among ties) through predecessors
+		// whose edge is tight, again the smallest id first, until a node starting at 0.
+		template<typename E, typename Predecessors>
+		auto walk_critical_path(std::vector<E> const& earliest,
+		                        node_id last,
+		                        Predecessors predecessors) -> std::vector<node_id> {
+			auto ret = std::vector<node_id>{last};
+			for (auto v = last; earliest[v] != E{};) {
+				auto next = std::numeric_limits<node_id>::max();
+				predecessors(v, [&](node_id u, E const& w) {
+					if (earliest[u] + w == earliest[v] && u < next) {
+						next = u;
+					}
+				});
+				v = next;
+				ret.push_back(v);
+			}
+			std::reverse(ret.begin(), ret.end());
+			return ret;
+		}
+	} // namespace detail
+
+	// Longest paths in topological order, O(n + e): forwards for the earliest starts, backwards for
+	// how long the rest of the project takes from each node. Parallel edges count by the heaviest.
+	// Exact for integral weights; with floating point weights slack can be off by rounding.
+	template<typename N, typename E>
+	auto critical_path(csr_graph<N, E> const& g) -> critical_path_result<E> {
+		detail::check_durations(g.weights(), "Cannot call gdwg::critical_path on a graph");
+		auto const sorted = topological_sort(g);
+		if (!sorted.is_dag) {
+			throw std::runtime_error("Cannot call gdwg::critical_path on a graph that has a cycle");
+		}
+		auto const n = g.num_nodes();
+		auto ret = critical_path_result<E>{E{}, std::vector<E>(n, E{}), {}, {}, {}};
+		// the longest path from every node to the end
+		auto tail = std::vector<E>(n, E{});
+		for (auto const u : sorted.order) {
+			auto const targets = g.out_targets(u);
+			auto const weights = g.out_weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				auto& start = ret.earliest[targets[k]];
+				start = std::max(start, ret.earliest[u] + weights[k]);
+			}
+		}
+		for (auto i = sorted.order.rbegin(); i != sorted.order.rend(); ++i) {
+			auto const targets = g.out_targets(*i);
+			auto const weights = g.out_weights(*i);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				tail[*i] = std::max(tail[*i], weights[k] + tail[targets[k]]);
+			}
+		}
+		if (n == 0) {
+			return ret;
+		}
+		auto const last =
+		   static_cast<node_id>(std::max_element(ret.earliest.begin(), ret.earliest.end())
+		                        - ret.earliest.begin());
+		ret.length = ret.earliest[last];
+		ret.latest.resize(n);
+		ret.slack.resize(n);
+		for (auto u = node_id{0}; u < n; ++u) {
+			ret.latest[u] = ret.length - tail[u];
+			ret.slack[u] = ret.latest[u] - ret.earliest[u];
+		}
+		// a snapshot without incoming edges has no reverse rows, so predecessors come from a scan
+		auto predecessors = std::vector<std::vector<std::pair<node_id, E>>>();
+		if (!g.has_incoming()) {
+			predecessors.resize(n);
+			auto const sources = g.edge_sources();
+			for (auto k = std::size_t{0}; k < sources.size(); ++k) {
+				predecessors[g.targets()[k]].emplace_back(sources[k], g.weights()[k]);
+			}
+		}
+		ret.path = detail::walk_critical_path(ret.earliest, last, [&](node_id v, auto&& visit) {
+			if (g.has_incoming()) {
+				auto const sources = g.in_sources(v);
+				auto const weights = g.in_weights(v);
+				for (auto k = std::size_t{0}; k < sources.size(); ++k) {
+					visit(sources[k], weights[k]);
+				}
+				return;
+			}
+			for (auto const& [u, w] : predecessors[v]) {
+				visit(u, w);
+			}
+		});
+		return ret;
+	}
+
+	// ids index graph::nodes()
+	template<typename N, typename E>
+	auto critical_path(graph<N, E> const& g) -> critical_path_result<E> {
+		return critical_path(csr_graph<N, E>(g));
+	}
+
+	// Keeps the schedule of a DAG up to date while edge weights change. Changing src -> dst only
+	// recomputes earliest starts downstream of dst and the time left after each node upstream of
+	// src, each in topological order and stopping wherever a value comes out the same, so a change
+	// off the critical path costs about the part of the plan it reaches rather than O(n + e).
+	// latest starts are read from the time left and the project length, which is kept in an
+	// ordered set so a longer or shorter project doesn't touch every node. The graph must only be
+	// modified through this object while it is alive.
+	template<typename N, typename E>
+	class incremental_critical_path {
+	public:
+		explicit incremental_critical_path(graph<N, E>& g)
+		: graph_{g} {
+			auto const view = csr_graph<N, E>(g);
+			detail::check_durations(view.weights(),
+			                        "Cannot construct gdwg::incremental_critical_path over a graph");
+			auto const sorted = topological_sort(view);
+			if (!sorted.is_dag) {
+				throw std::runtime_error("Cannot construct gdwg::incremental_critical_path over a "
+				                         "graph that has a cycle");
+			}
+			auto const n = view.num_nodes();
+			values_ = view.nodes();
+			out_.resize(n);
+			in_.resize(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				index_.emplace_hint(index_.end(), values_[u], u);
+				auto const targets = view.out_targets(u);
+				auto const weights = view.out_weights(u);
+				for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+					out_[u].emplace_back(targets[k], weights[k]);
+					in_[targets[k]].emplace_back(u, weights[k]);
+				}
+			}
+			ord_.resize(n);
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				ord_[sorted.order[i]] = static_cast<std::uint32_t>(i);
+			}
+			earliest_.assign(n, E{});
+			tail_.assign(n, E{});
+			for (auto const u : sorted.order) {
+				for (auto const& [v, w] : out_[u]) {
+					earliest_[v] = std::max(earliest_[v], earliest_[u] + w);
+				}
+			}
+			for (auto i = sorted.order.rbegin(); i != sorted.order.rend(); ++i) {
+				for (auto const& [v, w] : out_[*i]) {
+					tail_[*i] = std::max(tail_[*i], w + tail_[v]);
+				}
+			}
+			for (auto u = node_id{0}; u < n; ++u) {
+				if (out_[u].empty()) {
+					starts_.emplace(earliest_[u], u);
+				}
+			}
+			queued_.assign(n, 0);
+		}
+
+		// Changes the weight of the edge src -> dst from old_weight to new_weight, merging it into
+		// an edge that already has new_weight. Returns false if there's no such edge.
+		auto change_weight(N const& src, N const& dst, E const& old_weight, E const& new_weight)
+		   -> bool {
+			auto const x = lookup(src, "change_weight");
+			auto const y = lookup(dst, "change_weight");
+			if (new_weight < E{}) {
+				throw std::runtime_error("Cannot call gdwg::incremental_critical_path<N, "
+				                         "E>::change_weight with a negative weight");
+			}
+			last_updated_ = 0;
+			auto const it = graph_.find(src, dst, old_weight);
+			if (it == graph_.end()) {
+				return false;
+			}
+			if (old_weight == new_weight) {
+				return true;
+			}
+			graph_.erase_edge(it);
+			auto const merged = !graph_.insert_edge(src, dst, new_weight);
+			auto const change = [&](std::vector<std::pair<node_id, E>>& list, node_id v) {
+				auto const entry = std::find(list.begin(), list.end(), std::make_pair(v, old_weight));
+				if (merged) {
+					list.erase(entry);
+				}
+				else {
+					entry->second = new_weight;
+				}
+			};
+			change(out_[x], y);
+			change(in_[y], x);
+			update_earliest(y);
+			update_tail(x);
+			return true;
+		}
+
+		[[nodiscard]] auto earliest(N const& value) const -> E {
+			return earliest_[lookup(value, "earliest")];
+		}
+
+		[[nodiscard]] auto latest(N const& value) const -> E {
+			return length() - tail_[lookup(value, "latest")];
+		}
+
+		[[nodiscard]] auto slack(N const& value) const -> E {
+			auto const u = lookup(value, "slack");
+			return length() - tail_[u] - earliest_[u];
+		}
+
+		[[nodiscard]] auto length() const noexcept -> E {
+			return starts_.empty() ? E{} : std::prev(starts_.end())->first;
+		}
+
+		// the same path critical_path would give for the graph as it is now
+		[[nodiscard]] auto path() const -> std::vector<N> {
+			auto ret = std::vector<N>();
+			if (starts_.empty()) {
+				return ret;
+			}
+			// a node ahead of a sink over free edges can share its start and have a smaller id
+			auto const last = static_cast<node_id>(
+			   std::find(earliest_.begin(), earliest_.end(), length()) - earliest_.begin());
+			auto const ids = detail::walk_critical_path(earliest_, last, [&](node_id v, auto&& visit) {
+				for (auto const& [u, w] : in_[v]) {
+					visit(u, w);
+				}
+			});
+			std::transform(ids.begin(), ids.end(), std::back_inserter(ret), [&](node_id u) {
+				return values_[u];
+			});
+			return ret;
+		}
+
+		// how many nodes the last change_weight recomputed, for tuning
+		[[nodiscard]] auto last_updated() const noexcept -> std::size_t {
+			return last_updated_;
+		}
+
+		[[nodiscard]] auto underlying() const noexcept -> graph<N, E> const& {
+			return graph_;
+		}
+
+	private:
+		graph<N, E>& graph_;
+		std::vector<N> values_;
+		std::map<N, node_id> index_;
+		std::vector<std::vector<std::pair<node_id, E>>> out_;
+		std::vector<std::vector<std::pair<node_id, E>>> in_;
+		// ord_[u] is u's position in a topological order, which changing weights never breaks
+		std::vector<std::uint32_t> ord_;
+		std::vector<E> earliest_;
+		// the longest path from each node to the end
+		std::vector<E> tail_;
+		// nodes without outgoing edges by earliest start, the last one gives the length. Other
+		// nodes never start later than some sink, and changing weights never adds or removes one.
+		std::set<std::pair<E, node_id>> starts_;
+		// scratch space kept between changes
+		std::vector<std::uint32_t> queued_;
+		std::vector<std::pair<std::uint32_t, node_id>> heap_;
+		std::uint32_t epoch_ = 0;
+		std::size_t last_updated_ = 0;
+
+		[[nodiscard]] auto lookup(N const& value, char const* caller) const -> node_id {
+			auto const it = index_.find(value);
+			if (it == index_.end()) {
+				throw std::runtime_error(std::string("Cannot call gdwg::incremental_critical_path<N, "
+				                                     "E>::")
+				                         + caller + " on a node that doesn't exist in the graph");
+			}
+			return it->second;
+		}
+
+		auto next_epoch() -> void {
+			if (++epoch_ == 0) {
+				std::fill(queued_.begin(), queued_.end(), 0);
+				epoch_ = 1;
+			}
+		}
+
+		// Recomputes y and whatever changes downstream of it. Nodes come off the heap in
+		// topological order, so every predecessor that changed is final by the time a node is.
+		auto update_earliest(node_id y) -> void {
+			next_epoch();
+			heap_.assign(1, {ord_[y], y});
+			queued_[y] = epoch_;
+			while (!heap_.empty()) {
+				std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+				auto const v = heap_.back().second;
+				heap_.pop_back();
+				++last_updated_;
+				auto start = E{};
+				for (auto const& [u, w] : in_[v]) {
+					start = std::max(start, earliest_[u] + w);
+				}
+				if (start == earliest_[v]) {
+					continue;
+				}
+				if (out_[v].empty()) {
+					starts_.erase({earliest_[v], v});
+					starts_.emplace(start, v);
+				}
+				earliest_[v] = start;
+				for (auto const& [next, ignored] : out_[v]) {
+					if (queued_[next] != epoch_) {
+						queued_[next] = epoch_;
+						heap_.emplace_back(ord_[next], next);
+						std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+					}
+				}
+			}
+		}
+
+		// the same upstream of x, in reverse topological order
+		auto update_tail(node_id x) -> void {
+			next_epoch();
+			heap_.assign(1, {ord_[x], x});
+			queued_[x] = epoch_;
+			while (!heap_.empty()) {
+				std::pop_heap(heap_.begin(), heap_.end());
+				auto const u = heap_.back().second;
+				heap_.pop_back();
+				++last_updated_;
+				auto rest = E{};
+				for (auto const& [v, w] : out_[u]) {
+					rest = std::max(rest, w + tail_[v]);
+				}
+				if (rest == tail_[u]) {
+					continue;
+				}
+				tail_[u] = rest;
+				for (auto const& [prev, ignored] : in_[u]) {
+					if (queued_[prev] != epoch_) {
+						queued_[prev] = epoch_;
+						heap_.emplace_back(ord_[prev], prev);
+						std::push_heap(heap_.begin(), heap_.end());
+					}
+				}
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CRITICAL_PATH_HPP
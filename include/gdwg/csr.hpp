@@ -0,0 +1,305 @@
+#ifndef GDWG_CSR_HPP
+#define GDWG_CSR_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace gdwg {
+	// dense id of a node inside a csr_graph, a node's id is its position in graph::nodes() unless
+	// the snapshot was reordered
+	using node_id = std::uint32_t;
+
+	namespace detail {
+		// ids in ascending order of their values, empty when that is the identity
+		template<typename N>
+		auto ids_by_value(std::vector<N> const& nodes) -> std::vector<node_id> {
+			auto ret = std::vector<node_id>();
+			if (std::is_sorted(nodes.begin(), nodes.end())) {
+				return ret;
+			}
+			ret.resize(nodes.size());
+			std::iota(ret.begin(), ret.end(), node_id{0});
+			std::sort(ret.begin(), ret.end(), [&nodes](node_id lhs, node_id rhs) {
+				return nodes[lhs] < nodes[rhs];
+			});
+			return ret;
+		}
+
+		// binary search for the id of value, by_value as given by ids_by_value
+		template<typename N>
+		auto find_by_value(std::vector<N> const& nodes,
+		                   std::vector<node_id> const& by_value,
+		                   N const& value) -> std::optional<node_id> {
+			if (by_value.empty()) {
+				auto const it = std::lower_bound(nodes.begin(), nodes.end(), value);
+				if (it == nodes.end() || value < *it) {
+					return std::nullopt;
+				}
+				return static_cast<node_id>(it - nodes.begin());
+			}
+			auto const it = std::lower_bound(
+			   by_value.begin(),
+			   by_value.end(),
+			   value,
+			   [&nodes](node_id lhs, N const& rhs) { return nodes[lhs] < rhs; });
+			if (it == by_value.end() || value < nodes[*it]) {
+				return std::nullopt;
+			}
+			return *it;
+		}
+	} // namespace detail
+
+	// which adjacency arrays a csr_graph builds, incoming edges are only needed by the algorithms
+	// that search or pull backwards
+	enum class csr_layout { outgoing, both };
+
+	// Read only compressed sparse row snapshot of a graph. Nodes get dense ids in ascending order of
+	// N and the outgoing edges of each node are stored contiguously in the same (dst, weight) order
+	// the graph iterator uses, so parallel edges stay next to each other. The snapshot does not
+	// follow later changes to the graph. A reordered copy numbers its nodes in any other order,
+	// keeping every row sorted by target id, and still finds nodes by value.
+	template<typename N, typename E>
+	class csr_graph {
+	public:
+		csr_graph() = default;
+
+		// O(n + e) build, reading the graph's node and edge sets directly so no N is copied per edge
+		explicit csr_graph(graph<N, E> const& g, csr_layout layout = csr_layout::both) {
+			nodes_.reserve(g.nodes_.size());
+			auto index = std::unordered_map<N const*, node_id>();
+			index.reserve(g.nodes_.size());
+			for (auto const& node_ptr : g.nodes_) {
+				index.emplace(node_ptr.get(), static_cast<node_id>(nodes_.size()));
+				nodes_.push_back(*node_ptr);
+			}
+
+			// edges are already sorted by source so each row is filled in order
+			out_offsets_.assign(nodes_.size() + 1, 0);
+			out_targets_.reserve(g.edges_.size());
+			out_weights_.reserve(g.edges_.size());
+			for (auto const& edge_ptr : g.edges_) {
+				++out_offsets_[index.find(edge_ptr->source)->second + 1];
+				out_targets_.push_back(index.find(edge_ptr->dest)->second);
+				out_weights_.push_back(edge_ptr->weight);
+			}
+			for (auto i = std::size_t{0}; i < nodes_.size(); ++i) {
+				out_offsets_[i + 1] += out_offsets_[i];
+			}
+
+			if (layout == csr_layout::both) {
+				build_incoming();
+			}
+		}
+
+		// A copy where node i is node order[i] of this snapshot, the incoming edges rebuilt if this
+		// has them. Rows are sorted again by their new target ids, parallel edges keeping their
+		// weight order.
+		[[nodiscard]] auto reordered(std::vector<node_id> const& order) const -> csr_graph {
+			auto const n = nodes_.size();
+			constexpr auto unset = std::numeric_limits<node_id>::max();
+			auto position = std::vector<node_id>(n, unset);
+			if (order.size() != n) {
+				throw std::runtime_error("Cannot call gdwg::csr_graph<N, E>::reordered with an order "
+				                         "that isn't a permutation of the node ids");
+			}
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				if (order[i] >= n || position[order[i]] != unset) {
+					throw std::runtime_error("Cannot call gdwg::csr_graph<N, E>::reordered with an "
+					                         "order that isn't a permutation of the node ids");
+				}
+				position[order[i]] = static_cast<node_id>(i);
+			}
+
+			auto ret = csr_graph();
+			ret.nodes_.reserve(n);
+			ret.out_offsets_.assign(n + 1, 0);
+			ret.out_targets_.reserve(out_targets_.size());
+			ret.out_weights_.reserve(out_weights_.size());
+			auto row = std::vector<std::size_t>();
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				auto const u = order[i];
+				ret.nodes_.push_back(nodes_[u]);
+				row.resize(out_degree(u));
+				std::iota(row.begin(), row.end(), out_offsets_[u]);
+				std::stable_sort(row.begin(), row.end(), [&](std::size_t lhs, std::size_t rhs) {
+					return position[out_targets_[lhs]] < position[out_targets_[rhs]];
+				});
+				for (auto const k : row) {
+					ret.out_targets_.push_back(position[out_targets_[k]]);
+					ret.out_weights_.push_back(out_weights_[k]);
+				}
+				ret.out_offsets_[i + 1] = ret.out_targets_.size();
+			}
+			ret.by_value_.resize(n);
+			for (auto k = std::size_t{0}; k < n; ++k) {
+				ret.by_value_[k] = position[by_value_.empty() ? k : by_value_[k]];
+			}
+			if (std::is_sorted(ret.by_value_.begin(), ret.by_value_.end())) {
+				ret.by_value_.clear();
+			}
+			if (has_incoming_) {
+				ret.build_incoming();
+			}
+			return ret;
+		}
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		[[nodiscard]] auto num_edges() const noexcept -> std::size_t {
+			return out_targets_.size();
+		}
+
+		[[nodiscard]] auto has_incoming() const noexcept -> bool {
+			return has_incoming_;
+		}
+
+		// the node values in id order
+		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> const& {
+			return nodes_;
+		}
+
+		[[nodiscard]] auto node(node_id id) const -> N const& {
+			return nodes_[id];
+		}
+
+		// binary search for the id of value, O(log(n))
+		[[nodiscard]] auto find(N const& value) const -> std::optional<node_id> {
+			return detail::find_by_value(nodes_, by_value_, value);
+		}
+
+		[[nodiscard]] auto id(N const& value) const -> node_id {
+			auto ret = find(value);
+			if (!ret) {
+				throw std::runtime_error("Cannot call gdwg::csr_graph<N, E>::id on a node that doesn't "
+				                         "exist in the graph");
+			}
+			return *ret;
+		}
+
+		// Outgoing edges, edge k of node u lives at out_offset(u) + k in the flat edge arrays
+		[[nodiscard]] auto out_degree(node_id u) const noexcept -> std::size_t {
+			return out_offsets_[u + 1] - out_offsets_[u];
+		}
+		[[nodiscard]] auto out_offset(node_id u) const noexcept -> std::size_t {
+			return out_offsets_[u];
+		}
+		[[nodiscard]] auto out_targets(node_id u) const noexcept -> std::span<node_id const> {
+			return {out_targets_.data() + out_offsets_[u], out_degree(u)};
+		}
+		[[nodiscard]] auto out_weights(node_id u) const noexcept -> std::span<E const> {
+			return {out_weights_.data() + out_offsets_[u], out_degree(u)};
+		}
+
+		// Incoming edges, only available when built with csr_layout::both. in_edges gives the
+		// position of each incoming edge in the outgoing edge arrays.
+		[[nodiscard]] auto in_degree(node_id v) const noexcept -> std::size_t {
+			return in_offsets_[v + 1] - in_offsets_[v];
+		}
+		[[nodiscard]] auto in_offset(node_id v) const noexcept -> std::size_t {
+			return in_offsets_[v];
+		}
+		[[nodiscard]] auto in_sources(node_id v) const noexcept -> std::span<node_id const> {
+			return {in_sources_.data() + in_offsets_[v], in_degree(v)};
+		}
+		[[nodiscard]] auto in_weights(node_id v) const noexcept -> std::span<E const> {
+			return {in_weights_.data() + in_offsets_[v], in_degree(v)};
+		}
+		[[nodiscard]] auto in_edges(node_id v) const noexcept -> std::span<std::size_t const> {
+			return {in_edges_.data() + in_offsets_[v], in_degree(v)};
+		}
+
+		// the flat arrays, for kernels that walk every edge at once
+		[[nodiscard]] auto out_offsets() const noexcept -> std::span<std::size_t const> {
+			return out_offsets_;
+		}
+		[[nodiscard]] auto targets() const noexcept -> std::span<node_id const> {
+			return out_targets_;
+		}
+		[[nodiscard]] auto weights() const noexcept -> std::span<E const> {
+			return out_weights_;
+		}
+		[[nodiscard]] auto in_offsets() const noexcept -> std::span<std::size_t const> {
+			return in_offsets_;
+		}
+		[[nodiscard]] auto sources() const noexcept -> std::span<node_id const> {
+			return in_sources_;
+		}
+		[[nodiscard]] auto incoming_weights() const noexcept -> std::span<E const> {
+			return in_weights_;
+		}
+
+		// source of every edge in the flat arrays, the row array of the coordinate format
+		[[nodiscard]] auto edge_sources() const -> std::vector<node_id> {
+			auto ret = std::vector<node_id>(out_targets_.size());
+			for (auto u = node_id{0}; u < nodes_.size(); ++u) {
+				std::fill(ret.begin() + static_cast<std::ptrdiff_t>(out_offsets_[u]),
+				          ret.begin() + static_cast<std::ptrdiff_t>(out_offsets_[u + 1]),
+				          u);
+			}
+			return ret;
+		}
+
+		// positions of every edge in the flat arrays in ascending weight, equal weights keep the
+		// (src, dst) order of the graph iterator
+		[[nodiscard]] auto edges_by_weight() const -> std::vector<std::size_t> {
+			auto ret = std::vector<std::size_t>(out_targets_.size());
+			std::iota(ret.begin(), ret.end(), std::size_t{0});
+			std::stable_sort(ret.begin(), ret.end(), [this](std::size_t lhs, std::size_t rhs) {
+				return out_weights_[lhs] < out_weights_[rhs];
+			});
+			return ret;
+		}
+
+	private:
+		std::vector<N> nodes_;
+		std::vector<std::size_t> out_offsets_ = std::vector<std::size_t>(1, 0);
+		std::vector<node_id> out_targets_;
+		std::vector<E> out_weights_;
+		std::vector<std::size_t> in_offsets_;
+		std::vector<node_id> in_sources_;
+		std::vector<E> in_weights_;
+		std::vector<std::size_t> in_edges_;
+		bool has_incoming_ = false;
+		// ids in ascending order of N, left empty while that is the identity
+		std::vector<node_id> by_value_;
+
+		// counting sort of the outgoing edges by destination, sources stay ascending in each row
+		auto build_incoming() -> void {
+			auto const n = nodes_.size();
+			has_incoming_ = true;
+			in_offsets_.assign(n + 1, 0);
+			for (auto const v : out_targets_) {
+				++in_offsets_[v + 1];
+			}
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				in_offsets_[i + 1] += in_offsets_[i];
+			}
+			in_sources_.resize(out_targets_.size());
+			in_weights_.resize(out_targets_.size());
+			in_edges_.resize(out_targets_.size());
+			auto next = std::vector<std::size_t>(in_offsets_.begin(), in_offsets_.end() - 1);
+			for (auto u = node_id{0}; u < n; ++u) {
+				for (auto k = out_offsets_[u]; k < out_offsets_[u + 1]; ++k) {
+					auto const pos = next[out_targets_[k]]++;
+					in_sources_[pos] = u;
+					in_weights_[pos] = out_weights_[k];
+					in_edges_[pos] = k;
+				}
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CSR_HPP
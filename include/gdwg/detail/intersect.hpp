@@ -0,0 +1,107 @@
+#ifndef GDWG_DETAIL_INTERSECT_HPP
+#define GDWG_DETAIL_INTERSECT_HPP
+
+#include "gdwg/csr.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace gdwg::detail {
+	// lists this many times longer than the other are searched instead of merged
+	inline constexpr auto galloping_ratio = std::size_t{32};
+
+	// Branch free merge, the two indices advance on comparisons rather than on a taken branch
+	template<typename F>
+	auto merge_intersect(std::span<node_id const> a, std::span<node_id const> b, F& emit) -> void {
+		auto i = std::size_t{0};
+		auto j = std::size_t{0};
+		while (i < a.size() && j < b.size()) {
+			auto const x = a[i];
+			auto const y = b[j];
+			if (x == y) {
+				emit(x);
+			}
+			i += static_cast<std::size_t>(x <= y);
+			j += static_cast<std::size_t>(y <= x);
+		}
+	}
+
+	// Every element of the short list is looked up in the long one by doubling the step from the
+	// last match and then binary searching, O(|small| log(|large| / |small|))
+	template<typename F>
+	auto galloping_intersect(std::span<node_id const> small, std::span<node_id const> large, F& emit)
+	   -> void {
+		auto low = std::size_t{0};
+		for (auto const x : small) {
+			auto step = std::size_t{1};
+			auto high = low;
+			while (high < large.size() && large[high] < x) {
+				low = high + 1;
+				high += step;
+				step *= 2;
+			}
+			high = std::min(high, large.size());
+			auto const first = large.begin() + static_cast<std::ptrdiff_t>(low);
+			auto const last = large.begin() + static_cast<std::ptrdiff_t>(high);
+			low = static_cast<std::size_t>(std::lower_bound(first, last, x) - large.begin());
+			if (low == large.size()) {
+				return;
+			}
+			if (large[low] == x) {
+				emit(x);
+				++low;
+			}
+		}
+	}
+
+	// Calls emit(x) for every x in both a and b, which must be strictly ascending. Lists of similar
+	// length are compared four against four with SSE2 where available, an all pairs compare of the
+	// two blocks through three rotations, and the list whose block ends first moves on.
+	template<typename F>
+	auto intersect(std::span<node_id const> a, std::span<node_id const> b, F&& emit) -> void {
+		if (a.size() > b.size()) {
+			std::swap(a, b);
+		}
+		if (a.empty()) {
+			return;
+		}
+		if (b.size() > galloping_ratio * a.size()) {
+			galloping_intersect(a, b, emit);
+			return;
+		}
+		auto i = std::size_t{0};
+		auto j = std::size_t{0};
+#if defined(__SSE2__)
+		while (i + 4 <= a.size() && j + 4 <= b.size()) {
+			auto const va = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a.data() + i));
+			auto const vb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b.data() + j));
+			auto match = _mm_cmpeq_epi32(va, vb);
+			match = _mm_or_si128(match,
+			                     _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+			match = _mm_or_si128(match,
+			                     _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+			match = _mm_or_si128(match,
+			                     _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+			auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(match)));
+			while (mask != 0) {
+				emit(a[i + static_cast<std::size_t>(std::countr_zero(mask))]);
+				mask &= mask - 1;
+			}
+			auto const a_last = a[i + 3];
+			auto const b_last = b[j + 3];
+			i += a_last <= b_last ? 4 : 0;
+			j += b_last <= a_last ? 4 : 0;
+		}
+#endif
+		merge_intersect(a.subspan(i), b.subspan(j), emit);
+	}
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_INTERSECT_HPP
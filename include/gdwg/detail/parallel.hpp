@@ -0,0 +1,144 @@
+#ifndef GDWG_DETAIL_PARALLEL_HPP
+#define GDWG_DETAIL_PARALLEL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gdwg::detail {
+	// padded so per thread accumulators don't share a cache line
+	template<typename T>
+	struct alignas(64) padded {
+		T value{};
+	};
+
+	// 0 means use every hardware thread
+	inline auto resolve_threads(std::size_t threads) -> std::size_t {
+		if (threads != 0) {
+			return threads;
+		}
+		return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	// Fixed set of worker threads for the parallel algorithms. Iterative algorithms keep one pool
+	// for the whole run instead of starting threads every round. The calling thread takes part in
+	// every job, so a pool of size 1 runs everything inline without any worker threads.
+	class thread_pool {
+	public:
+		explicit thread_pool(std::size_t threads = 0)
+		: size_{resolve_threads(threads)} {
+			workers_.reserve(size_ - 1);
+			for (auto id = std::size_t{1}; id < size_; ++id) {
+				workers_.emplace_back([this, id] { work(id); });
+			}
+		}
+
+		thread_pool(thread_pool const&) = delete;
+		auto operator=(thread_pool const&) -> thread_pool& = delete;
+		thread_pool(thread_pool&&) = delete;
+		auto operator=(thread_pool&&) -> thread_pool& = delete;
+
+		~thread_pool() {
+			{
+				auto lock = std::lock_guard(mutex_);
+				stop_ = true;
+			}
+			wake_.notify_all();
+			for (auto& worker : workers_) {
+				worker.join();
+			}
+		}
+
+		// threads taking part in a job, including the caller
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return size_;
+		}
+
+		// Runs fn(thread, begin, end) on size() contiguous slices of [0, count) and waits for all of
+		// them. The first exception thrown by any slice is rethrown here.
+		template<typename F>
+		auto parallel_for(std::size_t count, F&& fn) -> void {
+			if (size_ == 1 || count <= 1) {
+				fn(std::size_t{0}, std::size_t{0}, count);
+				return;
+			}
+			auto const slice = [&, count](std::size_t id) {
+				auto const begin = count * id / size_;
+				auto const end = count * (id + 1) / size_;
+				if (begin < end) {
+					fn(id, begin, end);
+				}
+			};
+			{
+				auto lock = std::lock_guard(mutex_);
+				job_ = slice;
+				pending_ = size_ - 1;
+				error_ = nullptr;
+				++generation_;
+			}
+			wake_.notify_all();
+			try {
+				slice(0);
+			} catch (...) {
+				record_error();
+			}
+			auto lock = std::unique_lock(mutex_);
+			done_.wait(lock, [this] { return pending_ == 0; });
+			job_ = nullptr;
+			if (error_) {
+				std::rethrow_exception(error_);
+			}
+		}
+
+	private:
+		std::size_t size_;
+		std::vector<std::thread> workers_;
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+		std::function<void(std::size_t)> job_;
+		std::size_t generation_ = 0;
+		std::size_t pending_ = 0;
+		std::exception_ptr error_;
+		bool stop_ = false;
+
+		auto work(std::size_t id) -> void {
+			auto seen = std::size_t{0};
+			while (true) {
+				{
+					auto lock = std::unique_lock(mutex_);
+					wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+					if (stop_) {
+						return;
+					}
+					seen = generation_;
+				}
+				// job_ stays put until every worker has reported back
+				try {
+					job_(id);
+				} catch (...) {
+					record_error();
+				}
+				{
+					auto lock = std::lock_guard(mutex_);
+					--pending_;
+				}
+				done_.notify_one();
+			}
+		}
+
+		auto record_error() -> void {
+			auto lock = std::lock_guard(mutex_);
+			if (!error_) {
+				error_ = std::current_exception();
+			}
+		}
+	};
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_PARALLEL_HPP
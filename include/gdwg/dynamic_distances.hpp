@@ -0,0 +1,379 @@
+#ifndef GDWG_DYNAMIC_DISTANCES_HPP
+#define GDWG_DYNAMIC_DISTANCES_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// what the last update through a dynamic_distances cost, added up over every source
+	struct distance_update_stats {
+		// nodes whose distance was looked at again, the affected region
+		std::size_t touched = 0;
+		// nodes whose distance ended up different
+		std::size_t changed = 0;
+		std::size_t relaxed = 0;
+	};
+
+	// Shortest distances from a set of source nodes, kept up to date while edges come and go with
+	// Ramalingam and Reps' algorithms. An edge that shortens a path starts a Dijkstra at its
+	// target that only goes where distances drop. Erasing an edge that a node's distance relied
+	// on first collects the nodes left without any other shortest path, in order of distance, then
+	// gives those alone new distances from the rest with a Dijkstra seeded at their boundary.
+	// Either way the work is bounded by the part of the graph whose distances change. Weights must
+	// be positive, so the edges along shortest paths never form a cycle, and the graph must only be
+	// modified through this object while it is alive.
+	template<typename N, typename E>
+	class dynamic_distances {
+	public:
+		dynamic_distances(graph<N, E>& g, std::vector<N> const& sources)
+		: graph_{g} {
+			static_assert(std::is_arithmetic_v<E>,
+			              "gdwg::dynamic_distances requires arithmetic edge weights");
+			auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+			auto const positive = [](E const& w) { return E{} < w; };
+			if (!std::all_of(view.weights().begin(), view.weights().end(), positive)) {
+				throw std::runtime_error("Cannot construct gdwg::dynamic_distances over a graph with "
+				                         "non-positive edge weights");
+			}
+			auto const n = view.num_nodes();
+			values_ = view.nodes();
+			out_.resize(n);
+			in_.resize(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				index_.emplace_hint(index_.end(), values_[u], u);
+				auto const targets = view.out_targets(u);
+				auto const weights = view.out_weights(u);
+				for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+					out_[u].emplace_back(targets[k], weights[k]);
+					in_[targets[k]].emplace_back(u, weights[k]);
+				}
+			}
+			stamp_.assign(n, 0);
+			for (auto const& source : sources) {
+				auto const it = index_.find(source);
+				if (it == index_.end()) {
+					throw std::runtime_error("Cannot construct gdwg::dynamic_distances from a source "
+					                         "that doesn't exist in the graph");
+				}
+				if (std::none_of(trees_.begin(), trees_.end(), [&](tree const& t) {
+					    return t.source == it->second;
+				    }))
+				{
+					add_tree(it->second);
+				}
+			}
+		}
+
+		// the distance from source to value, empty if value can't be reached
+		[[nodiscard]] auto distance(N const& source, N const& value) const -> std::optional<E> {
+			auto const s = lookup(source, "distance");
+			auto const u = lookup(value, "distance");
+			auto const t = std::find_if(trees_.begin(), trees_.end(), [s](tree const& candidate) {
+				return candidate.source == s;
+			});
+			if (t == trees_.end()) {
+				throw std::runtime_error("Cannot call gdwg::dynamic_distances<N, E>::distance from a "
+				                         "node that isn't a source");
+			}
+			if (t->reached[u] == 0) {
+				return std::nullopt;
+			}
+			return t->dist[u];
+		}
+
+		[[nodiscard]] auto sources() const -> std::vector<N> {
+			auto ret = std::vector<N>();
+			for (auto const& t : trees_) {
+				ret.push_back(values_[t.source]);
+			}
+			return ret;
+		}
+
+		// a new node has no edges, so no source reaches it yet
+		auto insert_node(N const& value) -> bool {
+			if (!graph_.insert_node(value)) {
+				return false;
+			}
+			auto u = node_id{0};
+			if (free_.empty()) {
+				u = static_cast<node_id>(values_.size());
+				values_.push_back(value);
+				out_.emplace_back();
+				in_.emplace_back();
+				stamp_.push_back(0);
+				for (auto& t : trees_) {
+					t.dist.emplace_back();
+					t.reached.push_back(0);
+				}
+			}
+			else {
+				u = free_.back();
+				free_.pop_back();
+				values_[u] = value;
+			}
+			index_.emplace(value, u);
+			return true;
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (!(E{} < weight)) {
+				throw std::runtime_error("Cannot call gdwg::dynamic_distances<N, E>::insert_edge with "
+				                         "a non-positive weight");
+			}
+			stats_ = {};
+			if (!graph_.insert_edge(src, dst, weight)) {
+				return false;
+			}
+			auto const u = index_.find(src)->second;
+			auto const v = index_.find(dst)->second;
+			out_[u].emplace_back(v, weight);
+			in_[v].emplace_back(u, weight);
+			for (auto& t : trees_) {
+				if (t.reached[u] == 0) {
+					continue;
+				}
+				auto const candidate = t.dist[u] + weight;
+				if (t.reached[v] == 0 || candidate < t.dist[v]) {
+					heap_.clear();
+					lower(t, v, candidate);
+					settle(t);
+				}
+			}
+			return true;
+		}
+
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			stats_ = {};
+			if (!graph_.erase_edge(src, dst, weight)) {
+				return false;
+			}
+			auto const u = index_.find(src)->second;
+			auto const v = index_.find(dst)->second;
+			unlink(u, v, weight);
+			for (auto& t : trees_) {
+				remove_edge(t, u, v, weight);
+			}
+			return true;
+		}
+
+		// Every edge of the node is erased one at a time first, so distances through it are
+		// repaired like any other erase. A source that is erased stops being one.
+		auto erase_node(N const& value) -> bool {
+			stats_ = {};
+			auto const it = index_.find(value);
+			if (it == index_.end()) {
+				return false;
+			}
+			auto const u = it->second;
+			std::erase_if(trees_, [u](tree const& t) { return t.source == u; });
+			auto total = distance_update_stats{};
+			auto const erase_one = [&](node_id from, node_id to, E const& weight) {
+				unlink(from, to, weight);
+				for (auto& t : trees_) {
+					remove_edge(t, from, to, weight);
+				}
+				total.touched += stats_.touched;
+				total.changed += stats_.changed;
+				total.relaxed += stats_.relaxed;
+				stats_ = {};
+			};
+			while (!in_[u].empty()) {
+				auto const [from, weight] = in_[u].back();
+				erase_one(from, u, weight);
+			}
+			while (!out_[u].empty()) {
+				auto const [to, weight] = out_[u].back();
+				erase_one(u, to, weight);
+			}
+			graph_.erase_node(value);
+			for (auto& t : trees_) {
+				t.reached[u] = 0;
+			}
+			index_.erase(it);
+			free_.push_back(u);
+			stats_ = total;
+			return true;
+		}
+
+		// the cost of the last insert_edge, erase_edge or erase_node
+		[[nodiscard]] auto last_update() const noexcept -> distance_update_stats {
+			return stats_;
+		}
+
+		[[nodiscard]] auto underlying() const noexcept -> graph<N, E> const& {
+			return graph_;
+		}
+
+	private:
+		// distances from one source, indexed like values_
+		struct tree {
+			node_id source;
+			std::vector<E> dist;
+			std::vector<char> reached;
+		};
+		using entry = std::pair<E, node_id>;
+
+		graph<N, E>& graph_;
+		std::vector<N> values_;
+		std::map<N, node_id> index_;
+		// every edge with its weight, parallel edges included
+		std::vector<std::vector<std::pair<node_id, E>>> out_;
+		std::vector<std::vector<std::pair<node_id, E>>> in_;
+		std::vector<node_id> free_;
+		std::vector<tree> trees_;
+		distance_update_stats stats_;
+		// scratch space kept between updates
+		std::vector<entry> heap_;
+		std::vector<std::uint32_t> stamp_;
+		std::uint32_t epoch_ = 0;
+		std::vector<node_id> affected_;
+
+		[[nodiscard]] auto lookup(N const& value, char const* caller) const -> node_id {
+			auto const it = index_.find(value);
+			if (it == index_.end()) {
+				throw std::runtime_error(std::string("Cannot call gdwg::dynamic_distances<N, E>::")
+				                         + caller + " on a node that doesn't exist in the graph");
+			}
+			return it->second;
+		}
+
+		auto add_tree(node_id source) -> void {
+			auto& t = trees_.emplace_back();
+			t.source = source;
+			t.dist.resize(values_.size());
+			t.reached.assign(values_.size(), 0);
+			heap_.clear();
+			lower(t, source, E{});
+			settle(t);
+			stats_ = {};
+		}
+
+		auto unlink(node_id u, node_id v, E const& weight) -> void {
+			auto const edge = [&](node_id target) {
+				return [target, &weight](std::pair<node_id, E> const& e) {
+					return e.first == target && e.second == weight;
+				};
+			};
+			out_[u].erase(std::find_if(out_[u].begin(), out_[u].end(), edge(v)));
+			in_[v].erase(std::find_if(in_[v].begin(), in_[v].end(), edge(u)));
+		}
+
+		auto next_epoch() -> std::uint32_t {
+			if (++epoch_ == 0) {
+				std::fill(stamp_.begin(), stamp_.end(), 0);
+				epoch_ = 1;
+			}
+			return epoch_;
+		}
+
+		auto lower(tree& t, node_id v, E const& d) -> void {
+			t.dist[v] = d;
+			t.reached[v] = 1;
+			heap_.emplace_back(d, v);
+			std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+		}
+
+		// Dijkstra from whatever is on the heap, only following edges that lower a distance
+		auto settle(tree& t) -> void {
+			while (!heap_.empty()) {
+				std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+				auto const [d, x] = heap_.back();
+				heap_.pop_back();
+				if (d != t.dist[x]) {
+					continue;
+				}
+				++stats_.touched;
+				++stats_.changed;
+				for (auto const& [y, w] : out_[x]) {
+					++stats_.relaxed;
+					if (t.reached[y] == 0 || d + w < t.dist[y]) {
+						lower(t, y, d + w);
+					}
+				}
+			}
+		}
+
+		// whether some edge into y that isn't from an affected node still gives y its distance
+		[[nodiscard]] auto supported(tree const& t, node_id y, std::uint32_t affected) const -> bool {
+			return std::any_of(in_[y].begin(), in_[y].end(), [&](std::pair<node_id, E> const& e) {
+				auto const& [x, w] = e;
+				return t.reached[x] != 0 && stamp_[x] != affected && t.dist[x] + w == t.dist[y];
+			});
+		}
+
+		// u -> v with weight is already gone from the adjacency
+		auto remove_edge(tree& t, node_id u, node_id v, E const& weight) -> void {
+			if (v == t.source || t.reached[u] == 0 || t.dist[u] + weight != t.dist[v]) {
+				return;
+			}
+			// Candidates leave the heap in order of distance, so every edge along a shortest path
+			// into one comes from a node that is already known to be affected or not. Affected
+			// nodes carry the epoch's stamp, queued ones the one after it.
+			auto const affected = next_epoch();
+			auto const queued = next_epoch();
+			affected_.clear();
+			heap_.assign(1, entry{t.dist[v], v});
+			stamp_[v] = queued;
+			while (!heap_.empty()) {
+				std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+				auto const y = heap_.back().second;
+				heap_.pop_back();
+				++stats_.touched;
+				if (supported(t, y, affected)) {
+					continue;
+				}
+				stamp_[y] = affected;
+				affected_.push_back(y);
+				for (auto const& [z, w] : out_[y]) {
+					++stats_.relaxed;
+					if (t.reached[z] != 0 && stamp_[z] != affected && stamp_[z] != queued
+					    && z != t.source && t.dist[y] + w == t.dist[z])
+					{
+						stamp_[z] = queued;
+						heap_.emplace_back(t.dist[z], z);
+						std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+					}
+				}
+			}
+
+			// the rest kept their distances, so the affected nodes start from their best edge in
+			for (auto const y : affected_) {
+				t.reached[y] = 0;
+			}
+			for (auto const y : affected_) {
+				auto best = std::optional<E>();
+				for (auto const& [x, w] : in_[y]) {
+					if (t.reached[x] != 0 && (!best || t.dist[x] + w < *best)) {
+						best = t.dist[x] + w;
+					}
+				}
+				if (best) {
+					t.dist[y] = *best;
+					t.reached[y] = 1;
+					heap_.emplace_back(*best, y);
+					std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+				}
+			}
+			// every affected node changes, and settle would count them a second time
+			auto const touched = stats_.touched;
+			auto const changed = stats_.changed;
+			settle(t);
+			stats_.touched = touched;
+			stats_.changed = changed + affected_.size();
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_DYNAMIC_DISTANCES_HPP
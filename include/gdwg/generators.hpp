@@ -0,0 +1,69 @@
+#ifndef GDWG_GENERATORS_HPP
+#define GDWG_GENERATORS_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace gdwg {
+	// Parameters of a recursive matrix (R-MAT) graph. The defaults are the Graph500 ones, which
+	// give the skewed degree distribution of real social and web graphs.
+	struct rmat_options {
+		// 2^scale nodes
+		unsigned scale = 10;
+		// edge_factor * 2^scale edges are drawn, duplicates collapse
+		std::size_t edge_factor = 16;
+		double a = 0.57;
+		double b = 0.19;
+		double c = 0.19;
+		// weights are drawn uniformly from [1, max_weight]
+		int max_weight = 1;
+		std::uint64_t seed = 1;
+	};
+
+	// Nodes are 0 .. 2^scale - 1. The same options always give the same graph.
+	template<typename E = int>
+	auto rmat_graph(rmat_options const& options = {}) -> graph<int, E> {
+		auto const n = 1 << options.scale;
+		auto rng = std::mt19937_64(options.seed);
+		auto quadrant = std::uniform_real_distribution<double>(0.0, 1.0);
+		auto weight = std::uniform_int_distribution<int>(1, std::max(1, options.max_weight));
+		using value_type = typename graph<int, E>::value_type;
+		auto edges = std::vector<value_type>(options.edge_factor * static_cast<std::size_t>(n));
+		for (auto& e : edges) {
+			auto from = 0;
+			auto to = 0;
+			for (auto bit = 1 << (options.scale - 1); bit > 0; bit >>= 1) {
+				auto const r = quadrant(rng);
+				if (r >= options.a + options.b + options.c) {
+					from |= bit;
+					to |= bit;
+				}
+				else if (r >= options.a + options.b) {
+					from |= bit;
+				}
+				else if (r >= options.a) {
+					to |= bit;
+				}
+			}
+			e = value_type{from, to, static_cast<E>(weight(rng))};
+		}
+		// sorted so insert_edges can append
+		std::sort(edges.begin(), edges.end(), [](value_type const& lhs, value_type const& rhs) {
+			return std::tie(lhs.from, lhs.to, lhs.weight) < std::tie(rhs.from, rhs.to, rhs.weight);
+		});
+		auto nodes = std::vector<int>(static_cast<std::size_t>(n));
+		std::iota(nodes.begin(), nodes.end(), 0);
+		auto ret = graph<int, E>(nodes.begin(), nodes.end());
+		ret.insert_edges(edges.begin(), edges.end());
+		return ret;
+	}
+} // namespace gdwg
+
+#endif // GDWG_GENERATORS_HPP
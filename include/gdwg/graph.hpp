@@ -16,6 +16,11 @@
 
 // This will not compile straight away
 namespace gdwg {
+	// dense snapshot of a graph used by the algorithm headers, declared here so it can read the
+	// internal node and edge sets directly
+	template<typename N, typename E>
+	class csr_graph;
+
 	template<typename N, typename E>
 	class graph {
 	public:
@@ -118,6 +123,34 @@ namespace gdwg {
 			return edges_.emplace(std::make_shared<edge>(n_edge)).second;
 		}
 
+		// bulk insert a range of value_type edges, returns how many of them were new. Each edge is
+		// placed using the previous one as a hint so a range already sorted the way the iterator
+		// orders edges is inserted in amortised constant time per edge instead of log(e)
+		template<typename InputIt>
+		auto insert_edges(InputIt first, InputIt last) -> std::size_t {
+			auto count = std::size_t{0};
+			auto hint = edges_.end();
+			N* source_node = nullptr;
+			for (; first != last; ++first) {
+				auto const& value = *first;
+				// consecutive edges usually share a source so only look it up when it changes
+				if (source_node == nullptr || !(*source_node == value.from)) {
+					auto source_it = nodes_.find(value.from);
+					source_node = source_it == nodes_.end() ? nullptr : source_it->get();
+				}
+				auto dest_it = nodes_.find(value.to);
+				if (source_node == nullptr || dest_it == nodes_.end()) {
+					throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edges when either "
+					                         "src or dst node does not exist");
+				}
+				auto const size = edges_.size();
+				struct edge n_edge = {source_node, dest_it->get(), value.weight};
+				hint = std::next(edges_.emplace_hint(hint, std::make_shared<edge>(n_edge)));
+				count += edges_.size() - size;
+			}
+			return count;
+		}
+
 		// replace a node, checks if new_data exist and is_node(old_data) is false
 		auto replace_node(N const& old_data, N const& new_data) -> bool {
 			if (!is_node(old_data)) {
@@ -400,6 +433,8 @@ namespace gdwg {
 		// edges are just a set of the struct edge
 		std::set<std::shared_ptr<edge>, edge_comp> edges_;
 
+		friend class csr_graph<N, E>;
+
 		// function to swap two graphs
 		auto swap(graph<N, E>& other) noexcept -> void {
 			std::swap(nodes_, other.nodes_);
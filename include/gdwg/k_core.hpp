@@ -0,0 +1,273 @@
+#ifndef GDWG_K_CORE_HPP
+#define GDWG_K_CORE_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace gdwg {
+	// which edges a node's degree counts when peeling
+	enum class degree_mode { in, out, total };
+
+	// core[u] is the core number of node id u, the largest k such that u is in the k-core.
+	// degeneracy is the largest core number in the graph.
+	struct core_result {
+		std::vector<std::size_t> core;
+		std::size_t degeneracy = 0;
+	};
+
+	struct core_options {
+		degree_mode mode = degree_mode::total;
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+	};
+
+	namespace detail {
+		template<typename N, typename E>
+		auto check_core_layout(csr_graph<N, E> const& g, degree_mode mode, char const* message)
+		   -> void {
+			if (mode != degree_mode::in && !g.has_incoming()) {
+				throw std::runtime_error(message);
+			}
+		}
+
+		// degree of every node under mode, self loops left out
+		template<typename N, typename E>
+		auto core_degrees(csr_graph<N, E> const& g, degree_mode mode) -> std::vector<std::size_t> {
+			auto ret = std::vector<std::size_t>(g.num_nodes(), 0);
+			for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+				for (auto const v : g.out_targets(u)) {
+					if (u == v) {
+						continue;
+					}
+					if (mode != degree_mode::out) {
+						++ret[v];
+					}
+					if (mode != degree_mode::in) {
+						++ret[u];
+					}
+				}
+			}
+			return ret;
+		}
+
+		// calls fn(v) once for every edge whose degree at v drops when u is removed
+		template<typename N, typename E, typename F>
+		auto for_each_dependent(csr_graph<N, E> const& g, degree_mode mode, node_id u, F&& fn)
+		   -> void {
+			if (mode != degree_mode::out) {
+				for (auto const v : g.out_targets(u)) {
+					if (v != u) {
+						fn(v);
+					}
+				}
+			}
+			if (mode != degree_mode::in) {
+				for (auto const v : g.in_sources(u)) {
+					if (v != u) {
+						fn(v);
+					}
+				}
+			}
+		}
+	} // namespace detail
+
+	// Batagelj-Zaversnik peeling in O(n + e). Nodes sit in an array sorted by current degree with
+	// the start of every degree's bucket kept alongside, so taking the lowest node and moving a
+	// neighbour down one bucket are both a swap. Parallel edges count once each and self loops
+	// are ignored. Only degree_mode::in works on a csr_graph without incoming edges.
+	template<typename N, typename E>
+	auto core_numbers(csr_graph<N, E> const& g, degree_mode mode = degree_mode::total)
+	   -> core_result {
+		detail::check_core_layout(g,
+		                          mode,
+		                          "Cannot call gdwg::core_numbers on a csr_graph built without "
+		                          "incoming edges");
+		auto const n = g.num_nodes();
+		auto ret = core_result{};
+		ret.core = detail::core_degrees(g, mode);
+		auto& degree = ret.core;
+		auto const max_degree = n == 0 ? 0 : *std::max_element(degree.begin(), degree.end());
+
+		auto bucket = std::vector<std::size_t>(max_degree + 2, 0);
+		for (auto const d : degree) {
+			++bucket[d + 1];
+		}
+		for (auto d = std::size_t{0}; d <= max_degree; ++d) {
+			bucket[d + 1] += bucket[d];
+		}
+		auto position = std::vector<std::size_t>(n);
+		auto order = std::vector<node_id>(n);
+		{
+			auto next = std::vector<std::size_t>(bucket.begin(), bucket.end() - 1);
+			for (auto u = node_id{0}; u < n; ++u) {
+				position[u] = next[degree[u]]++;
+				order[position[u]] = u;
+			}
+		}
+
+		for (auto i = std::size_t{0}; i < n; ++i) {
+			auto const u = order[i];
+			detail::for_each_dependent(g, mode, u, [&](node_id v) {
+				if (degree[v] <= degree[u]) {
+					return;
+				}
+				// swap v with the first node of its bucket, then shrink the bucket past it
+				auto const d = degree[v];
+				auto const first = bucket[d];
+				auto const w = order[first];
+				std::swap(order[first], order[position[v]]);
+				position[w] = position[v];
+				position[v] = first;
+				++bucket[d];
+				--degree[v];
+			});
+			ret.degeneracy = std::max(ret.degeneracy, degree[u]);
+		}
+		return ret;
+	}
+
+	// Level synchronous peeling for large graphs. For k = 0, 1, ... the nodes left with degree k
+	// are removed in parallel rounds, neighbours drop with atomic decrements and join the next
+	// round when they reach k. A decrement that overshoots below k is put back, so every node
+	// ends up removed at exactly its core number.
+	template<typename N, typename E>
+	auto parallel_core_numbers(csr_graph<N, E> const& g, core_options const& options = {})
+	   -> core_result {
+		detail::check_core_layout(g,
+		                          options.mode,
+		                          "Cannot call gdwg::parallel_core_numbers on a csr_graph built "
+		                          "without incoming edges");
+		auto const n = g.num_nodes();
+		auto pool = detail::thread_pool(options.threads);
+		auto const threads = pool.size();
+		auto ret = core_result{};
+		ret.core.assign(n, 0);
+		auto degree = std::vector<std::atomic<std::size_t>>(n);
+		{
+			auto const initial = detail::core_degrees(g, options.mode);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				degree[u].store(initial[u], std::memory_order_relaxed);
+			}
+		}
+		auto remaining = std::vector<node_id>(n);
+		for (auto u = node_id{0}; u < n; ++u) {
+			remaining[u] = u;
+		}
+		// nodes reached through next are still in remaining until the next split
+		auto removed = std::vector<char>(n, 0);
+		auto kept = std::vector<std::vector<node_id>>(threads);
+		auto frontier = std::vector<std::vector<node_id>>(threads);
+		auto next = std::vector<std::vector<node_id>>(threads);
+
+		for (auto k = std::size_t{0}; !remaining.empty(); ++k) {
+			// split the nodes still there into this level's first round and the rest
+			auto const size = remaining.size();
+			pool.parallel_for(size, [&](std::size_t t, std::size_t begin, std::size_t end) {
+				for (auto i = begin; i < end; ++i) {
+					auto const u = remaining[i];
+					if (removed[u] != 0) {
+						continue;
+					}
+					auto const low = degree[u].load(std::memory_order_relaxed) <= k;
+					(low ? frontier[t] : kept[t]).push_back(u);
+				}
+			});
+			remaining.clear();
+			for (auto& part : kept) {
+				remaining.insert(remaining.end(), part.begin(), part.end());
+				part.clear();
+			}
+
+			auto active = true;
+			while (active) {
+				pool.parallel_for(threads, [&](std::size_t, std::size_t first, std::size_t last) {
+					for (auto t = first; t < last; ++t) {
+						for (auto const u : frontier[t]) {
+							ret.core[u] = k;
+							removed[u] = 1;
+							detail::for_each_dependent(g, options.mode, u, [&](node_id v) {
+								if (degree[v].load(std::memory_order_relaxed) <= k) {
+									return;
+								}
+								auto const old = degree[v].fetch_sub(1, std::memory_order_relaxed);
+								if (old == k + 1) {
+									next[t].push_back(v);
+								}
+								else if (old <= k) {
+									degree[v].fetch_add(1, std::memory_order_relaxed);
+								}
+							});
+						}
+						frontier[t].clear();
+					}
+				});
+				active = false;
+				for (auto t = std::size_t{0}; t < threads; ++t) {
+					active = active || !next[t].empty();
+					frontier[t].swap(next[t]);
+				}
+			}
+		}
+		ret.degeneracy = n == 0 ? 0 : *std::max_element(ret.core.begin(), ret.core.end());
+		return ret;
+	}
+
+	namespace detail {
+		// in-degrees are counted from the outgoing edges, so that mode needs no incoming arrays
+		inline auto core_layout(degree_mode mode) -> csr_layout {
+			return mode == degree_mode::in ? csr_layout::outgoing : csr_layout::both;
+		}
+	} // namespace detail
+
+	template<typename N, typename E>
+	auto core_numbers(graph<N, E> const& g, degree_mode mode = degree_mode::total) -> core_result {
+		return core_numbers(csr_graph<N, E>(g, detail::core_layout(mode)), mode);
+	}
+
+	template<typename N, typename E>
+	auto parallel_core_numbers(graph<N, E> const& g, core_options const& options = {})
+	   -> core_result {
+		return parallel_core_numbers(csr_graph<N, E>(g, detail::core_layout(options.mode)), options);
+	}
+
+	// The k-core of g as a graph of its own: every node with core number at least k and every edge
+	// of g between two of them, self loops and parallel edges included.
+	template<typename N, typename E>
+	auto k_core(graph<N, E> const& g, std::size_t k, degree_mode mode = degree_mode::total)
+	   -> graph<N, E> {
+		auto const view = csr_graph<N, E>(g, detail::core_layout(mode));
+		auto const cores = core_numbers(view, mode);
+		auto nodes = std::vector<N>();
+		for (auto u = node_id{0}; u < view.num_nodes(); ++u) {
+			if (cores.core[u] >= k) {
+				nodes.push_back(view.node(u));
+			}
+		}
+		auto ret = graph<N, E>(nodes.begin(), nodes.end());
+		// the csr rows are already in graph order, so insert_edges only ever appends
+		auto edges = std::vector<typename graph<N, E>::value_type>();
+		for (auto u = node_id{0}; u < view.num_nodes(); ++u) {
+			if (cores.core[u] < k) {
+				continue;
+			}
+			auto const out = view.out_targets(u);
+			auto const weights = view.out_weights(u);
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				if (cores.core[out[i]] >= k) {
+					edges.push_back({view.node(u), view.node(out[i]), weights[i]});
+				}
+			}
+		}
+		ret.insert_edges(edges.begin(), edges.end());
+		return ret;
+	}
+} // namespace gdwg
+
+#endif // GDWG_K_CORE_HPP
@@ -0,0 +1,187 @@
+#ifndef GDWG_K_SHORTEST_PATHS_HPP
+#define GDWG_K_SHORTEST_PATHS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// a path over a csr_graph, costs[i] is the distance from the first node to nodes[i]
+	template<typename E>
+	struct ranked_path {
+		E distance = E{};
+		std::vector<node_id> nodes;
+		std::vector<E> costs;
+	};
+
+	namespace detail {
+		// Dijkstra from src to dst that skips nodes stamped in blocked and, out of spur only, the
+		// edges to the targets listed in cut. Nothing about the graph is changed or copied.
+		template<typename N, typename E>
+		auto masked_dijkstra(csr_graph<N, E> const& g,
+		                     node_id src,
+		                     node_id dst,
+		                     search_workspace<E>& ws,
+		                     std::vector<std::uint32_t> const& blocked,
+		                     std::uint32_t stamp,
+		                     std::vector<node_id> const& cut) -> search_result<E> {
+			ws.start(g.num_nodes(), src, dst, false);
+			auto const epoch = ws.epoch();
+			auto& fwd = ws.forward();
+			auto& stats = ws.mutable_stats();
+			fwd.label(src, E{}, src, epoch);
+			fwd.push({E{}, E{}, src});
+			++stats.pushed;
+			while (!fwd.heap.empty()) {
+				auto const top = fwd.pop();
+				if (top.dist != fwd.dist[top.node] || fwd.is_settled(top.node, epoch)) {
+					continue;
+				}
+				fwd.settled[top.node] = epoch;
+				++stats.settled;
+				if (top.node == dst) {
+					ws.finish(true, dst);
+					return {true, top.dist, stats};
+				}
+				auto const targets = g.out_targets(top.node);
+				auto const weights = g.out_weights(top.node);
+				for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+					auto const v = targets[k];
+					if (blocked[v] == stamp
+					    || (top.node == src && std::find(cut.begin(), cut.end(), v) != cut.end()))
+					{
+						continue;
+					}
+					++stats.relaxed;
+					auto const d = top.dist + weights[k];
+					if (!fwd.is_reached(v, epoch) || d < fwd.dist[v]) {
+						fwd.label(v, d, top.node, epoch);
+						fwd.push({d, d, v});
+						++stats.pushed;
+					}
+				}
+			}
+			ws.finish(false, dst);
+			return {false, E{}, stats};
+		}
+	} // namespace detail
+
+	// Yen's algorithm for the k shortest loopless paths from src to dst, shortest first. Paths are
+	// sequences of nodes, so parallel edges give one path over the lightest of them. Every spur
+	// search masks the root path's nodes and the next hops of the paths already found that share
+	// the root, and all of them run in the same workspace. Weights must not be negative.
+	template<typename N, typename E>
+	auto k_shortest_paths(csr_graph<N, E> const& g,
+	                      node_id src,
+	                      node_id dst,
+	                      std::size_t k,
+	                      search_workspace<E>& ws) -> std::vector<ranked_path<E>> {
+		static_assert(std::is_arithmetic_v<E>,
+		              "gdwg::k_shortest_paths requires arithmetic edge weights");
+		auto const negative = [](E const& w) { return w < E{}; };
+		if (std::any_of(g.weights().begin(), g.weights().end(), negative)) {
+			throw std::runtime_error("Cannot call gdwg::k_shortest_paths on a graph with negative "
+			                         "edge weights");
+		}
+		auto ret = std::vector<ranked_path<E>>();
+		if (k == 0) {
+			return ret;
+		}
+		auto blocked = std::vector<std::uint32_t>(g.num_nodes(), 0);
+		auto stamp = std::uint32_t{1};
+		auto cut = std::vector<node_id>();
+		auto spur_nodes = std::vector<node_id>();
+
+		auto const first = detail::masked_dijkstra(g, src, dst, ws, blocked, stamp, cut);
+		if (!first.found) {
+			return ret;
+		}
+		auto path = ranked_path<E>{first.distance, {}, {}};
+		ws.path(path.nodes);
+		for (auto const u : path.nodes) {
+			path.costs.push_back(*ws.distance(u));
+		}
+		ret.push_back(std::move(path));
+
+		// ordered by (distance, nodes), which also drops a path found from two different spurs
+		auto const by_length = [](ranked_path<E> const& lhs, ranked_path<E> const& rhs) {
+			return std::tie(lhs.distance, lhs.nodes) < std::tie(rhs.distance, rhs.nodes);
+		};
+		auto candidates = std::set<ranked_path<E>, decltype(by_length)>(by_length);
+		while (ret.size() < k) {
+			auto const& last = ret.back();
+			for (auto j = std::size_t{0}; j + 1 < last.nodes.size(); ++j) {
+				auto const spur = last.nodes[j];
+				++stamp;
+				for (auto i = std::size_t{0}; i < j; ++i) {
+					blocked[last.nodes[i]] = stamp;
+				}
+				cut.clear();
+				for (auto const& found : ret) {
+					if (found.nodes.size() > j + 1
+					    && std::equal(last.nodes.begin(),
+					                  last.nodes.begin() + static_cast<std::ptrdiff_t>(j + 1),
+					                  found.nodes.begin()))
+					{
+						cut.push_back(found.nodes[j + 1]);
+					}
+				}
+				auto const result = detail::masked_dijkstra(g, spur, dst, ws, blocked, stamp, cut);
+				if (!result.found) {
+					continue;
+				}
+				auto candidate = ranked_path<E>{};
+				candidate.nodes.assign(last.nodes.begin(),
+				                       last.nodes.begin() + static_cast<std::ptrdiff_t>(j));
+				candidate.costs.assign(last.costs.begin(),
+				                       last.costs.begin() + static_cast<std::ptrdiff_t>(j));
+				ws.path(spur_nodes);
+				for (auto const u : spur_nodes) {
+					candidate.nodes.push_back(u);
+					candidate.costs.push_back(last.costs[j] + *ws.distance(u));
+				}
+				candidate.distance = candidate.costs.back();
+				candidates.insert(std::move(candidate));
+			}
+			if (candidates.empty()) {
+				break;
+			}
+			ret.push_back(std::move(candidates.extract(candidates.begin()).value()));
+		}
+		return ret;
+	}
+
+	// One off k shortest paths over a graph, see the overload above for repeated queries
+	template<typename N, typename E>
+	auto k_shortest_paths(graph<N, E> const& g, N const& src, N const& dst, std::size_t k)
+	   -> std::vector<path_result<N, E>> {
+		if (!g.is_node(src) || !g.is_node(dst)) {
+			throw std::runtime_error("Cannot call gdwg::k_shortest_paths if src or dst node don't "
+			                         "exist in the graph");
+		}
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		auto ws = search_workspace<E>(view.num_nodes());
+		auto ret = std::vector<path_result<N, E>>();
+		for (auto const& path : k_shortest_paths(view, view.id(src), view.id(dst), k, ws)) {
+			auto& out = ret.emplace_back();
+			out.found = true;
+			out.distance = path.distance;
+			for (auto const u : path.nodes) {
+				out.nodes.push_back(view.node(u));
+			}
+		}
+		return ret;
+	}
+} // namespace gdwg
+
+#endif // GDWG_K_SHORTEST_PATHS_HPP
@@ -0,0 +1,257 @@
+#ifndef GDWG_LANDMARKS_HPP
+#define GDWG_LANDMARKS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	enum class landmark_selection {
+		// the nodes with the most edges
+		degree,
+		// each landmark is the node furthest from the ones before it, starting from the node with
+		// the most edges, so unreached parts of the graph get one first
+		farthest,
+	};
+
+	struct landmark_options {
+		std::size_t landmarks = 16;
+		landmark_selection selection = landmark_selection::farthest;
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+	};
+
+	// what a landmark_oracle knows about the distance from src to dst without searching
+	template<typename E>
+	struct distance_bounds {
+		// false when some landmark proves dst can't be reached from src
+		bool reachable = true;
+		E lower = E{};
+		// empty when no landmark lies on a path from src to dst
+		std::optional<E> upper;
+	};
+
+	namespace detail {
+		// Dijkstra from src over outgoing edges, or over incoming ones when backward, into dist
+		template<typename N, typename E>
+		auto landmark_dijkstra(csr_graph<N, E> const& g,
+		                       node_id src,
+		                       bool backward,
+		                       std::vector<E>& dist,
+		                       std::vector<std::pair<E, node_id>>& heap) -> void {
+			auto constexpr unreached = std::numeric_limits<E>::max();
+			std::fill(dist.begin(), dist.end(), unreached);
+			dist[src] = E{};
+			heap.assign(1, {E{}, src});
+			while (!heap.empty()) {
+				std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+				auto const [d, u] = heap.back();
+				heap.pop_back();
+				if (d != dist[u]) {
+					continue;
+				}
+				auto const targets = backward ? g.in_sources(u) : g.out_targets(u);
+				auto const weights = backward ? g.in_weights(u) : g.out_weights(u);
+				for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+					auto const v = targets[k];
+					if (d + weights[k] < dist[v]) {
+						dist[v] = d + weights[k];
+						heap.emplace_back(dist[v], v);
+						std::push_heap(heap.begin(), heap.end(), std::greater<>());
+					}
+				}
+			}
+		}
+	} // namespace detail
+
+	// Landmark (ALT) distance oracle. Shortest distances to and from a few landmarks are stored per
+	// node, and the triangle inequality turns them into bounds on the distance between any two
+	// nodes: d(src, dst) is at least d(l, dst) - d(l, src) and d(src, l) - d(dst, l), and at most
+	// d(src, l) + d(l, dst), for every landmark l. A query reads 2 x landmarks distances laid out
+	// next to each other, and the lower bound doubles as an A* heuristic. Weights must not be
+	// negative.
+	template<typename N, typename E>
+	class landmark_oracle {
+	public:
+		explicit landmark_oracle(graph<N, E> const& g, landmark_options const& options = {})
+		: landmark_oracle(csr_graph<N, E>(g), options) {}
+
+		// The landmark searches run in parallel, one per thread at a time. Farthest selection
+		// needs each landmark's forward distances to pick the next, so only the backward searches
+		// are left to run in parallel at the end.
+		explicit landmark_oracle(csr_graph<N, E> const& g, landmark_options const& options = {}) {
+			static_assert(std::is_arithmetic_v<E>,
+			              "gdwg::landmark_oracle requires arithmetic edge weights");
+			if (!g.has_incoming()) {
+				throw std::runtime_error("Cannot build a gdwg::landmark_oracle over a csr_graph built "
+				                         "without incoming edges");
+			}
+			auto const negative = [](E const& w) { return w < E{}; };
+			if (std::any_of(g.weights().begin(), g.weights().end(), negative)) {
+				throw std::runtime_error("Cannot build a gdwg::landmark_oracle over a graph with "
+				                         "negative edge weights");
+			}
+			nodes_ = g.nodes();
+			by_value_ = detail::ids_by_value(nodes_);
+			auto const n = g.num_nodes();
+			auto const k = std::min(options.landmarks, n);
+			from_.assign(n * k, unreached);
+			to_.assign(n * k, unreached);
+			auto pool = detail::thread_pool(options.threads);
+			auto dist = std::vector<std::vector<E>>(pool.size(), std::vector<E>(n));
+			auto heaps = std::vector<std::vector<std::pair<E, node_id>>>(pool.size());
+			// the searches of landmark index l, backward into to_ and forward into from_
+			auto const search = [&](std::size_t thread, std::size_t l, bool backward) {
+				detail::landmark_dijkstra(g, landmarks_[l], backward, dist[thread], heaps[thread]);
+				auto& out = backward ? to_ : from_;
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					out[u * k + l] = dist[thread][u];
+				}
+			};
+			auto const run = [&](std::size_t count, auto&& job) {
+				pool.parallel_for(count, [&](std::size_t thread, std::size_t begin, std::size_t end) {
+					for (auto i = begin; i < end; ++i) {
+						job(thread, i);
+					}
+				});
+			};
+
+			auto by_degree = std::vector<node_id>(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				by_degree[u] = u;
+			}
+			auto const degree = [&g](node_id u) { return g.out_degree(u) + g.in_degree(u); };
+			std::stable_sort(by_degree.begin(), by_degree.end(), [&](node_id lhs, node_id rhs) {
+				return degree(lhs) > degree(rhs);
+			});
+			if (options.selection == landmark_selection::degree) {
+				by_degree.resize(k);
+				landmarks_ = std::move(by_degree);
+				run(2 * k, [&](std::size_t thread, std::size_t i) {
+					search(thread, i / 2, i % 2 == 1);
+				});
+				return;
+			}
+
+			// closest[u] is u's distance from the nearest landmark so far
+			auto closest = std::vector<E>(n, unreached);
+			for (auto l = std::size_t{0}; l < k; ++l) {
+				if (l == 0) {
+					landmarks_.push_back(by_degree.front());
+				}
+				else {
+					// an unreached node is as far as it gets, ties go to the higher degree
+					auto best = by_degree.front();
+					for (auto const u : by_degree) {
+						if (closest[best] < closest[u]) {
+							best = u;
+						}
+					}
+					landmarks_.push_back(best);
+				}
+				search(0, l, false);
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					closest[u] = std::min(closest[u], from_[u * k + l]);
+				}
+			}
+			run(k, [&](std::size_t thread, std::size_t l) { search(thread, l, true); });
+		}
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		// node ids of the landmarks, in the order they were picked
+		[[nodiscard]] auto landmarks() const noexcept -> std::vector<node_id> const& {
+			return landmarks_;
+		}
+
+		// the ids are those of the csr_graph it was built from
+		[[nodiscard]] auto find(N const& value) const -> std::optional<node_id> {
+			return detail::find_by_value(nodes_, by_value_, value);
+		}
+
+		[[nodiscard]] auto bounds(node_id src, node_id dst) const noexcept -> distance_bounds<E> {
+			auto ret = distance_bounds<E>{};
+			if (src == dst) {
+				ret.upper = E{};
+				return ret;
+			}
+			auto const k = landmarks_.size();
+			for (auto l = std::size_t{0}; l < k; ++l) {
+				auto const from_src = from_[src * k + l];
+				auto const from_dst = from_[dst * k + l];
+				auto const to_src = to_[src * k + l];
+				auto const to_dst = to_[dst * k + l];
+				// l reaches src but not dst, or dst reaches l but src doesn't
+				if ((from_src != unreached && from_dst == unreached)
+				    || (to_dst != unreached && to_src == unreached))
+				{
+					return {false, E{}, std::nullopt};
+				}
+				if (from_src != unreached && from_src < from_dst) {
+					ret.lower = std::max(ret.lower, from_dst - from_src);
+				}
+				if (to_dst != unreached && to_dst < to_src) {
+					ret.lower = std::max(ret.lower, to_src - to_dst);
+				}
+				if (to_src != unreached && from_dst != unreached
+				    && (!ret.upper || to_src + from_dst < *ret.upper))
+				{
+					ret.upper = to_src + from_dst;
+				}
+			}
+			return ret;
+		}
+
+		[[nodiscard]] auto bounds(N const& src, N const& dst) const -> distance_bounds<E> {
+			auto const s = find(src);
+			auto const t = find(dst);
+			if (!s || !t) {
+				throw std::runtime_error("Cannot call gdwg::landmark_oracle<N, E>::bounds if src or "
+				                         "dst node don't exist in the graph");
+			}
+			return bounds(*s, *t);
+		}
+
+		// An A* heuristic towards dst for the csr_graph overload of astar. Nodes that provably
+		// can't reach dst get 0 rather than being cut off, which keeps it admissible.
+		[[nodiscard]] auto heuristic(node_id dst) const {
+			return [this, dst](node_id u) {
+				auto const b = bounds(u, dst);
+				return b.reachable ? b.lower : E{};
+			};
+		}
+
+		// the same over node values, for the graph overload of astar
+		[[nodiscard]] auto heuristic_to(N const& dst) const {
+			auto const t = find(dst);
+			if (!t) {
+				throw std::runtime_error("Cannot call gdwg::landmark_oracle<N, E>::heuristic_to on a "
+				                         "node that doesn't exist in the graph");
+			}
+			return [this, to = heuristic(*t)](N const& value) { return to(*find(value)); };
+		}
+
+	private:
+		static constexpr auto unreached = std::numeric_limits<E>::max();
+		std::vector<N> nodes_;
+		std::vector<node_id> by_value_;
+		std::vector<node_id> landmarks_;
+		// from_[u * landmarks + l] is d(landmark l, u) and to_[u * landmarks + l] is d(u, landmark l)
+		std::vector<E> from_;
+		std::vector<E> to_;
+	};
+} // namespace gdwg
+
+#endif // GDWG_LANDMARKS_HPP
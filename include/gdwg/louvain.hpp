@@ -0,0 +1,334 @@
+#ifndef GDWG_LOUVAIN_HPP
+#define GDWG_LOUVAIN_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace gdwg {
+	using community_id = std::uint32_t;
+
+	struct louvain_options {
+		// above 1 favours more, smaller communities
+		double resolution = 1.0;
+		// a level stops moving nodes once a full pass gains less modularity than this
+		double tolerance = 1e-7;
+		std::size_t max_levels = 32;
+	};
+
+	// community[u] is the community of node id u after this level, ids are dense and numbered in
+	// order of each community's smallest node
+	struct louvain_level {
+		std::vector<community_id> community;
+		std::size_t communities = 0;
+		double modularity = 0.0;
+	};
+
+	// community is the last level's assignment
+	struct louvain_result {
+		std::vector<community_id> community;
+		std::vector<louvain_level> levels;
+	};
+
+	namespace detail {
+		// Open addressing map from community to the weight joining a node to it, sized for the
+		// node's degree and cleared through the list of used slots, so a node costs its degree.
+		class community_accumulator {
+		public:
+			auto reset(std::size_t degree) -> void {
+				for (auto const slot : used_) {
+					keys_[slot] = empty;
+				}
+				used_.clear();
+				auto const capacity = std::bit_ceil(std::max<std::size_t>(2 * degree, 8));
+				if (capacity > keys_.size()) {
+					keys_.assign(capacity, empty);
+					weights_.resize(capacity);
+				}
+				mask_ = keys_.size() - 1;
+			}
+
+			auto add(community_id c, double weight) -> void {
+				// Fibonacci hashing spreads the dense community ids over the table
+				auto slot = (std::size_t{c} * 0x9E3779B97F4A7C15ULL) & mask_;
+				while (keys_[slot] != empty && keys_[slot] != c) {
+					slot = (slot + 1) & mask_;
+				}
+				if (keys_[slot] == empty) {
+					keys_[slot] = c;
+					weights_[slot] = 0.0;
+					used_.push_back(slot);
+				}
+				weights_[slot] += weight;
+			}
+
+			[[nodiscard]] auto get(community_id c) const -> double {
+				auto slot = (std::size_t{c} * 0x9E3779B97F4A7C15ULL) & mask_;
+				while (keys_[slot] != empty) {
+					if (keys_[slot] == c) {
+						return weights_[slot];
+					}
+					slot = (slot + 1) & mask_;
+				}
+				return 0.0;
+			}
+
+			template<typename F>
+			auto for_each(F&& fn) const -> void {
+				for (auto const slot : used_) {
+					fn(keys_[slot], weights_[slot]);
+				}
+			}
+
+		private:
+			static constexpr auto empty = std::numeric_limits<community_id>::max();
+			std::vector<community_id> keys_;
+			std::vector<double> weights_;
+			std::vector<std::size_t> used_;
+			std::size_t mask_ = 0;
+		};
+
+		// weighted degree with edges read as undirected, a self loop adds its weight twice
+		template<typename N, typename E>
+		auto undirected_degrees(csr_graph<N, E> const& g) -> std::vector<double> {
+			auto ret = std::vector<double>(g.num_nodes(), 0.0);
+			for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+				auto const out = g.out_targets(u);
+				auto const weights = g.out_weights(u);
+				for (auto i = std::size_t{0}; i < out.size(); ++i) {
+					ret[u] += static_cast<double>(weights[i]);
+					ret[out[i]] += static_cast<double>(weights[i]);
+				}
+			}
+			return ret;
+		}
+
+		template<typename N, typename E>
+		auto modularity_of(csr_graph<N, E> const& g,
+		                   std::vector<community_id> const& community,
+		                   double resolution,
+		                   std::vector<double> const& degree,
+		                   double two_m) -> double {
+			auto inside = 0.0;
+			auto total = std::vector<double>(g.num_nodes(), 0.0);
+			for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+				total[community[u]] += degree[u];
+				auto const out = g.out_targets(u);
+				auto const weights = g.out_weights(u);
+				for (auto i = std::size_t{0}; i < out.size(); ++i) {
+					if (community[out[i]] == community[u]) {
+						inside += 2.0 * static_cast<double>(weights[i]);
+					}
+				}
+			}
+			auto ret = inside / two_m;
+			for (auto const t : total) {
+				ret -= resolution * (t / two_m) * (t / two_m);
+			}
+			return ret;
+		}
+
+		// Local moving: every node in turn goes to the neighbouring community with the best
+		// modularity gain, repeated until a pass gains less than tolerance. Returns whether any
+		// node ended up away from its own singleton community.
+		template<typename N, typename E>
+		auto louvain_move(csr_graph<N, E> const& g,
+		                  louvain_options const& options,
+		                  std::vector<community_id>& community) -> bool {
+			auto const n = g.num_nodes();
+			auto const degree = undirected_degrees(g);
+			auto total = degree;
+			auto two_m = 0.0;
+			for (auto const k : degree) {
+				two_m += k;
+			}
+			community.resize(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				community[u] = u;
+			}
+			if (two_m == 0.0) {
+				return false;
+			}
+			auto accumulator = community_accumulator();
+			auto quality = modularity_of(g, community, options.resolution, degree, two_m);
+			auto moved = false;
+			while (true) {
+				for (auto u = node_id{0}; u < n; ++u) {
+					accumulator.reset(g.out_degree(u) + g.in_degree(u));
+					auto const out = g.out_targets(u);
+					auto const out_weights = g.out_weights(u);
+					for (auto i = std::size_t{0}; i < out.size(); ++i) {
+						if (out[i] != u) {
+							accumulator.add(community[out[i]], static_cast<double>(out_weights[i]));
+						}
+					}
+					auto const in = g.in_sources(u);
+					auto const in_weights = g.in_weights(u);
+					for (auto i = std::size_t{0}; i < in.size(); ++i) {
+						if (in[i] != u) {
+							accumulator.add(community[in[i]], static_cast<double>(in_weights[i]));
+						}
+					}
+					auto const current = community[u];
+					auto const scale = options.resolution * degree[u] / two_m;
+					total[current] -= degree[u];
+					auto best = current;
+					auto best_gain = accumulator.get(current) - total[current] * scale;
+					accumulator.for_each([&](community_id c, double weight) {
+						auto const gain = weight - total[c] * scale;
+						if (gain > best_gain) {
+							best = c;
+							best_gain = gain;
+						}
+					});
+					total[best] += degree[u];
+					community[u] = best;
+				}
+				auto const next = modularity_of(g, community, options.resolution, degree, two_m);
+				auto const gain = next - quality;
+				quality = next;
+				if (gain > 0.0) {
+					moved = true;
+				}
+				if (gain < options.tolerance) {
+					break;
+				}
+			}
+			return moved;
+		}
+
+		// renumbers communities densely in order of their smallest node, returns how many there are
+		inline auto compact_communities(std::vector<community_id>& community) -> std::size_t {
+			constexpr auto unassigned = std::numeric_limits<community_id>::max();
+			auto dense = std::vector<community_id>(community.size(), unassigned);
+			auto count = community_id{0};
+			for (auto& c : community) {
+				if (dense[c] == unassigned) {
+					dense[c] = count++;
+				}
+				c = dense[c];
+			}
+			return count;
+		}
+
+		// One node per community and one edge per ordered pair of communities carrying the summed
+		// weight, built through insert_edges from sorted input.
+		template<typename N, typename E>
+		auto aggregate(csr_graph<N, E> const& g,
+		               std::vector<community_id> const& community,
+		               std::size_t communities) -> graph<community_id, double> {
+			auto edges = std::vector<std::tuple<community_id, community_id, double>>();
+			edges.reserve(g.num_edges());
+			for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+				auto const out = g.out_targets(u);
+				auto const weights = g.out_weights(u);
+				for (auto i = std::size_t{0}; i < out.size(); ++i) {
+					edges.emplace_back(community[u], community[out[i]], static_cast<double>(weights[i]));
+				}
+			}
+			std::sort(edges.begin(), edges.end(), [](auto const& lhs, auto const& rhs) {
+				return std::tie(std::get<0>(lhs), std::get<1>(lhs))
+				       < std::tie(std::get<0>(rhs), std::get<1>(rhs));
+			});
+			using value_type = graph<community_id, double>::value_type;
+			auto merged = std::vector<value_type>();
+			for (auto const& [from, to, weight] : edges) {
+				if (!merged.empty() && merged.back().from == from && merged.back().to == to) {
+					merged.back().weight += weight;
+				}
+				else {
+					merged.push_back({from, to, weight});
+				}
+			}
+			auto nodes = std::vector<community_id>(communities);
+			for (auto c = community_id{0}; c < communities; ++c) {
+				nodes[c] = c;
+			}
+			auto ret = graph<community_id, double>(nodes.begin(), nodes.end());
+			ret.insert_edges(merged.begin(), merged.end());
+			return ret;
+		}
+	} // namespace detail
+
+	// Newman's modularity of an assignment of node ids to communities, edges read as undirected
+	// with their weights as affinities. 0 for a graph without weight.
+	template<typename N, typename E>
+	auto modularity(csr_graph<N, E> const& g,
+	                std::vector<community_id> const& community,
+	                double resolution = 1.0) -> double {
+		auto const degree = detail::undirected_degrees(g);
+		auto two_m = 0.0;
+		for (auto const k : degree) {
+			two_m += k;
+		}
+		return two_m == 0.0 ? 0.0 : detail::modularity_of(g, community, resolution, degree, two_m);
+	}
+
+	// Multi-level Louvain. Each level moves nodes between communities until modularity stops
+	// improving, then the communities become the nodes of the next level's graph. Edges are read
+	// as undirected, so u -> v and v -> u add up, and weights must not be negative.
+	template<typename N, typename E>
+	auto louvain(csr_graph<N, E> const& g, louvain_options const& options = {}) -> louvain_result {
+		if (!g.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::louvain on a csr_graph built without incoming "
+			                         "edges");
+		}
+		static_assert(std::is_arithmetic_v<E>, "gdwg::louvain requires arithmetic edge weights");
+		auto const negative = [](E const& w) { return w < E{}; };
+		if (std::any_of(g.weights().begin(), g.weights().end(), negative)) {
+			throw std::runtime_error("Cannot call gdwg::louvain on a graph with negative edge "
+			                         "weights");
+		}
+		auto ret = louvain_result{};
+		ret.community.resize(g.num_nodes());
+		for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+			ret.community[u] = u;
+		}
+		// community maps the nodes of the current level onto the next level's nodes
+		auto community = std::vector<community_id>();
+		auto const finish_level = [&] {
+			auto const communities = detail::compact_communities(community);
+			for (auto& c : ret.community) {
+				c = community[c];
+			}
+			ret.levels.push_back({ret.community, communities, 0.0});
+			ret.levels.back().modularity = modularity(g, ret.community, options.resolution);
+			return communities;
+		};
+
+		// the first level is always reported, even when nothing moves
+		auto moved = detail::louvain_move(g, options, community);
+		auto communities = finish_level();
+		auto level_graph = csr_graph<community_id, double>();
+		if (moved) {
+			level_graph = csr_graph<community_id, double>(
+			   detail::aggregate(g, community, communities));
+		}
+		while (moved && ret.levels.size() < options.max_levels) {
+			moved = detail::louvain_move(level_graph, options, community);
+			if (!moved) {
+				break;
+			}
+			communities = finish_level();
+			level_graph = csr_graph<community_id, double>(
+			   detail::aggregate(level_graph, community, communities));
+		}
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto louvain(graph<N, E> const& g, louvain_options const& options = {}) -> louvain_result {
+		return louvain(csr_graph<N, E>(g), options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_LOUVAIN_HPP
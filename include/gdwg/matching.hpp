@@ -0,0 +1,311 @@
+#ifndef GDWG_MATCHING_HPP
+#define GDWG_MATCHING_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// edges are positions in the flat edge arrays of the csr_graph, one per matched pair and in
+	// order of their source
+	template<typename E>
+	struct matching_result {
+		std::vector<std::size_t> edges;
+		E total_weight = E{};
+	};
+
+	template<typename N, typename E>
+	struct matching {
+		std::vector<typename graph<N, E>::value_type> edges;
+		E total_weight = E{};
+	};
+
+	namespace detail {
+		inline constexpr auto unmatched = std::numeric_limits<node_id>::max();
+
+		// Sources of edges make up the left side and targets the right one, a node can't be both
+		template<typename N, typename E>
+		auto check_bipartite(csr_graph<N, E> const& g, char const* message) -> void {
+			auto target = std::vector<char>(g.num_nodes(), 0);
+			for (auto const v : g.targets()) {
+				target[v] = 1;
+			}
+			for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+				if (g.out_degree(u) != 0 && target[u] != 0) {
+					throw std::runtime_error(message);
+				}
+			}
+		}
+
+		// the lightest edge of every matched source, rows are sorted by (dst, weight)
+		template<typename N, typename E>
+		auto to_matching_result(csr_graph<N, E> const& g, std::vector<node_id> const& mate)
+		   -> matching_result<E> {
+			auto ret = matching_result<E>{};
+			for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+				if (g.out_degree(u) == 0 || mate[u] == unmatched) {
+					continue;
+				}
+				auto const targets = g.out_targets(u);
+				auto const k = static_cast<std::size_t>(
+				   std::lower_bound(targets.begin(), targets.end(), mate[u]) - targets.begin());
+				ret.edges.push_back(g.out_offset(u) + k);
+				ret.total_weight += g.weights()[g.out_offset(u) + k];
+			}
+			return ret;
+		}
+
+		template<typename N, typename E>
+		auto to_matching(csr_graph<N, E> const& g, matching_result<E> const& result)
+		   -> matching<N, E> {
+			auto ret = matching<N, E>{{}, result.total_weight};
+			auto const sources = g.edge_sources();
+			ret.edges.reserve(result.edges.size());
+			for (auto const k : result.edges) {
+				ret.edges.push_back({g.node(sources[k]), g.node(g.targets()[k]), g.weights()[k]});
+			}
+			return ret;
+		}
+	} // namespace detail
+
+	// Maximum cardinality matching of a bipartite graph whose edges run from one side to the
+	// other, in O(e sqrt(n)). After a greedy start every phase layers the graph with a breadth
+	// first search from the unmatched sources, then augments along vertex disjoint shortest paths
+	// with depth first searches that keep their place in every row, so a phase costs O(e). Weights
+	// are ignored and a matched pair reports its lightest edge.
+	template<typename N, typename E>
+	auto hopcroft_karp(csr_graph<N, E> const& g) -> matching_result<E> {
+		detail::check_bipartite(g,
+		                        "Cannot call gdwg::hopcroft_karp on a graph where a node is both a "
+		                        "source and a target");
+		auto const n = g.num_nodes();
+		auto const offsets = g.out_offsets();
+		auto const targets = g.targets();
+		auto mate = std::vector<node_id>(n, detail::unmatched);
+		auto left = std::vector<node_id>();
+		for (auto u = node_id{0}; u < n; ++u) {
+			if (g.out_degree(u) == 0) {
+				continue;
+			}
+			left.push_back(u);
+			for (auto const v : g.out_targets(u)) {
+				if (mate[v] == detail::unmatched) {
+					mate[u] = v;
+					mate[v] = u;
+					break;
+				}
+			}
+		}
+
+		constexpr auto infinite = std::numeric_limits<std::size_t>::max();
+		auto layer = std::vector<std::size_t>(n, infinite);
+		auto next = std::vector<std::size_t>(n, 0);
+		auto queue = std::vector<node_id>();
+		// the source at every depth of the search and the edge it took
+		auto path = std::vector<std::pair<node_id, node_id>>();
+		while (true) {
+			queue.clear();
+			for (auto const u : left) {
+				layer[u] = mate[u] == detail::unmatched ? 0 : infinite;
+				if (layer[u] == 0) {
+					queue.push_back(u);
+				}
+			}
+			// the layer of the sources that reach an unmatched target first
+			auto limit = infinite;
+			for (auto i = std::size_t{0}; i < queue.size(); ++i) {
+				auto const u = queue[i];
+				if (layer[u] >= limit) {
+					break;
+				}
+				for (auto const v : g.out_targets(u)) {
+					auto const w = mate[v];
+					if (w == detail::unmatched) {
+						limit = std::min(limit, layer[u]);
+					}
+					else if (layer[w] == infinite) {
+						layer[w] = layer[u] + 1;
+						queue.push_back(w);
+					}
+				}
+			}
+			if (limit == infinite) {
+				break;
+			}
+
+			for (auto const u : left) {
+				next[u] = offsets[u];
+			}
+			for (auto const root : left) {
+				if (mate[root] != detail::unmatched) {
+					continue;
+				}
+				path.assign(1, {root, detail::unmatched});
+				while (!path.empty()) {
+					auto const u = path.back().first;
+					if (next[u] == offsets[u + 1]) {
+						// nothing more to find from u this phase
+						layer[u] = infinite;
+						path.pop_back();
+						continue;
+					}
+					auto const v = targets[next[u]++];
+					auto const w = mate[v];
+					path.back().second = v;
+					if (w == detail::unmatched && layer[u] == limit) {
+						for (auto const& [x, y] : path) {
+							mate[x] = y;
+							mate[y] = x;
+						}
+						break;
+					}
+					if (w != detail::unmatched && layer[w] == layer[u] + 1) {
+						path.emplace_back(w, detail::unmatched);
+					}
+				}
+			}
+		}
+		return detail::to_matching_result(g, mate);
+	}
+
+	// Maximum weight matching of a bipartite graph whose edges run from one side to the other,
+	// with the shortest augmenting path form of the Hungarian algorithm on a dense matrix of the
+	// heaviest edge between every pair. Pairs without an edge weigh 0, so a source can always be
+	// left unmatched and edges that aren't positive are never used. O(l^2 r) time and O(l r)
+	// memory for l and r nodes on the smaller and larger side, meant for small dense instances.
+	template<typename N, typename E>
+	auto hungarian(csr_graph<N, E> const& g) -> matching_result<E> {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::hungarian requires arithmetic edge weights");
+		detail::check_bipartite(g,
+		                        "Cannot call gdwg::hungarian on a graph where a node is both a "
+		                        "source and a target");
+		auto const n = g.num_nodes();
+		auto sources = std::vector<node_id>();
+		auto sinks = std::vector<node_id>();
+		auto column = std::vector<std::size_t>(n, 0);
+		{
+			auto target = std::vector<char>(n, 0);
+			for (auto const v : g.targets()) {
+				target[v] = 1;
+			}
+			for (auto u = node_id{0}; u < n; ++u) {
+				if (g.out_degree(u) != 0) {
+					sources.push_back(u);
+				}
+				else if (target[u] != 0) {
+					column[u] = sinks.size();
+					sinks.push_back(u);
+				}
+			}
+		}
+		// rows go on the smaller side so every row can be assigned
+		auto const transposed = sources.size() > sinks.size();
+		auto const rows = transposed ? sinks.size() : sources.size();
+		auto const cols = transposed ? sources.size() : sinks.size();
+		constexpr auto none = std::numeric_limits<std::size_t>::max();
+		auto best = std::vector<std::size_t>(rows * cols, none);
+		auto const weights = g.weights();
+		for (auto i = std::size_t{0}; i < sources.size(); ++i) {
+			auto const u = sources[i];
+			auto const out = g.out_targets(u);
+			for (auto k = std::size_t{0}; k < out.size(); ++k) {
+				auto const e = g.out_offset(u) + k;
+				auto const j = column[out[k]];
+				auto& cell = transposed ? best[j * cols + i] : best[i * cols + j];
+				if (E{} < weights[e] && (cell == none || weights[cell] < weights[e])) {
+					cell = e;
+				}
+			}
+		}
+		auto const cost = [&](std::size_t i, std::size_t j) -> E {
+			auto const e = best[i * cols + j];
+			return e == none ? E{} : E{} - weights[e];
+		};
+
+		// potentials row_potential/col_potential, col_row[j] is the row assigned to column j,
+		// with index 0 standing for no row or column
+		auto row_potential = std::vector<E>(rows + 1, E{});
+		auto col_potential = std::vector<E>(cols + 1, E{});
+		auto col_row = std::vector<std::size_t>(cols + 1, 0);
+		auto way = std::vector<std::size_t>(cols + 1, 0);
+		auto slack = std::vector<E>(cols + 1);
+		auto used = std::vector<char>(cols + 1);
+		for (auto i = std::size_t{1}; i <= rows; ++i) {
+			col_row[0] = i;
+			auto j0 = std::size_t{0};
+			std::fill(slack.begin(), slack.end(), std::numeric_limits<E>::max());
+			std::fill(used.begin(), used.end(), 0);
+			do {
+				used[j0] = 1;
+				auto const i0 = col_row[j0];
+				auto delta = std::numeric_limits<E>::max();
+				auto j1 = std::size_t{0};
+				for (auto j = std::size_t{1}; j <= cols; ++j) {
+					if (used[j] != 0) {
+						continue;
+					}
+					auto const reduced = cost(i0 - 1, j - 1) - row_potential[i0] - col_potential[j];
+					if (reduced < slack[j]) {
+						slack[j] = reduced;
+						way[j] = j0;
+					}
+					if (slack[j] < delta) {
+						delta = slack[j];
+						j1 = j;
+					}
+				}
+				for (auto j = std::size_t{0}; j <= cols; ++j) {
+					if (used[j] != 0) {
+						row_potential[col_row[j]] += delta;
+						col_potential[j] -= delta;
+					}
+					else {
+						slack[j] -= delta;
+					}
+				}
+				j0 = j1;
+			} while (col_row[j0] != 0);
+			do {
+				auto const j1 = way[j0];
+				col_row[j0] = col_row[j1];
+				j0 = j1;
+			} while (j0 != 0);
+		}
+
+		auto ret = matching_result<E>{};
+		for (auto j = std::size_t{1}; j <= cols; ++j) {
+			if (col_row[j] == 0) {
+				continue;
+			}
+			auto const i = col_row[j] - 1;
+			auto const e = best[i * cols + (j - 1)];
+			if (e != none) {
+				ret.edges.push_back(e);
+				ret.total_weight += weights[e];
+			}
+		}
+		std::sort(ret.edges.begin(), ret.edges.end());
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto hopcroft_karp(graph<N, E> const& g) -> matching<N, E> {
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		return detail::to_matching(view, hopcroft_karp(view));
+	}
+
+	template<typename N, typename E>
+	auto hungarian(graph<N, E> const& g) -> matching<N, E> {
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		return detail::to_matching(view, hungarian(view));
+	}
+} // namespace gdwg
+
+#endif // GDWG_MATCHING_HPP
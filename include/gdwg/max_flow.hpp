@@ -0,0 +1,390 @@
+#ifndef GDWG_MAX_FLOW_HPP
+#define GDWG_MAX_FLOW_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// flow[k] is the flow on edge k of the csr_graph's flat edge arrays, source_side[u] is true for
+	// the nodes on the source side of a minimum cut
+	template<typename E>
+	struct flow_result {
+		E value = E{};
+		std::vector<E> flow;
+		std::vector<bool> source_side;
+	};
+
+	template<typename N, typename E>
+	struct edge_flow {
+		N from;
+		N to;
+		E capacity;
+		E flow;
+	};
+
+	// edges are in graph iterator order, the two sides of the cut are in ascending order
+	template<typename N, typename E>
+	struct network_flow {
+		E value = E{};
+		std::vector<edge_flow<N, E>> edges;
+		std::vector<N> source_side;
+		std::vector<N> sink_side;
+	};
+
+	namespace detail {
+		// Residual network with one arc per ordered pair of adjacent nodes, so parallel edges are
+		// summed and u -> v, v -> u share a pair of arcs. Rows are sorted by head.
+		template<typename E>
+		class push_relabel {
+		public:
+			template<typename N>
+			push_relabel(csr_graph<N, E> const& g, node_id source, node_id sink)
+			: n_{g.num_nodes()}
+			, source_{source}
+			, sink_{sink} {
+				offsets_.assign(n_ + 1, 0);
+				auto row = std::vector<std::pair<node_id, E>>();
+				for (auto u = node_id{0}; u < n_; ++u) {
+					row.clear();
+					auto const out = g.out_targets(u);
+					auto const weights = g.out_weights(u);
+					for (auto i = std::size_t{0}; i < out.size(); ++i) {
+						if (out[i] != u) {
+							row.emplace_back(out[i], weights[i]);
+						}
+					}
+					for (auto const v : g.in_sources(u)) {
+						if (v != u) {
+							row.emplace_back(v, E{});
+						}
+					}
+					std::sort(row.begin(), row.end(), [](auto const& lhs, auto const& rhs) {
+						return lhs.first < rhs.first;
+					});
+					for (auto const& [v, capacity] : row) {
+						if (head_.size() > offsets_[u] && head_.back() == v) {
+							capacity_.back() += capacity;
+						}
+						else {
+							head_.push_back(v);
+							capacity_.push_back(capacity);
+						}
+					}
+					offsets_[u + 1] = head_.size();
+				}
+				residual_ = capacity_;
+				reverse_.resize(head_.size());
+				for (auto u = node_id{0}; u < n_; ++u) {
+					for (auto a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+						reverse_[a] = arc(head_[a], u);
+					}
+				}
+			}
+
+			// Highest label push-relabel. Phase one only discharges nodes that can still reach the
+			// sink and ends with a maximum preflow, phase two returns the leftover excess to the
+			// source so the result is a proper flow.
+			auto solve() -> void {
+				label_.assign(n_, 0);
+				excess_.assign(n_, E{});
+				current_.assign(offsets_.begin(), offsets_.end() - 1);
+				active_.resize(2 * n_ + 1);
+				for (auto a = offsets_[source_]; a < offsets_[source_ + 1]; ++a) {
+					auto const delta = residual_[a];
+					residual_[a] = E{};
+					residual_[reverse_[a]] += delta;
+					excess_[head_[a]] += delta;
+				}
+				discharge_all(sink_, source_, n_, true);
+				value_ = excess_[sink_];
+				discharge_all(source_, sink_, 2 * n_, false);
+			}
+
+			[[nodiscard]] auto value() const noexcept -> E {
+				return value_;
+			}
+
+			// net flow from u to v, zero when it runs the other way or the nodes aren't adjacent
+			[[nodiscard]] auto net_flow(node_id u, node_id v) const -> E {
+				auto const a = arc(u, v);
+				if (a == offsets_[u + 1] || !(residual_[a] < capacity_[a])) {
+					return E{};
+				}
+				return capacity_[a] - residual_[a];
+			}
+
+			// nodes reachable from the source in the residual network
+			[[nodiscard]] auto source_side() const -> std::vector<bool> {
+				auto ret = std::vector<bool>(n_, false);
+				auto queue = std::vector<node_id>{source_};
+				ret[source_] = true;
+				for (auto i = std::size_t{0}; i < queue.size(); ++i) {
+					auto const u = queue[i];
+					for (auto a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+						if (E{} < residual_[a] && !ret[head_[a]]) {
+							ret[head_[a]] = true;
+							queue.push_back(head_[a]);
+						}
+					}
+				}
+				return ret;
+			}
+
+		private:
+			std::size_t n_;
+			node_id source_;
+			node_id sink_;
+			std::vector<std::size_t> offsets_;
+			std::vector<node_id> head_;
+			std::vector<E> capacity_;
+			std::vector<E> residual_;
+			std::vector<std::size_t> reverse_;
+			E value_ = E{};
+
+			std::vector<std::size_t> label_;
+			std::vector<E> excess_;
+			std::vector<std::size_t> current_;
+			// active nodes by label, entries go stale when a node is relabelled and are skipped
+			std::vector<std::vector<node_id>> active_;
+			std::size_t highest_ = 0;
+			// every node below the label limit, by label, for the gap heuristic
+			std::vector<node_id> next_;
+			std::vector<node_id> previous_;
+			std::vector<node_id> first_;
+			std::vector<std::size_t> count_;
+			std::size_t work_ = 0;
+
+			[[nodiscard]] auto arc(node_id u, node_id v) const -> std::size_t {
+				auto const first = head_.begin() + static_cast<std::ptrdiff_t>(offsets_[u]);
+				auto const last = head_.begin() + static_cast<std::ptrdiff_t>(offsets_[u + 1]);
+				return static_cast<std::size_t>(std::lower_bound(first, last, v) - head_.begin());
+			}
+
+			auto activate(node_id u) -> void {
+				active_[label_[u]].push_back(u);
+				highest_ = std::max(highest_, label_[u]);
+			}
+
+			auto link(node_id u) -> void {
+				auto const d = label_[u];
+				next_[u] = first_[d];
+				previous_[u] = static_cast<node_id>(n_);
+				if (first_[d] != n_) {
+					previous_[first_[d]] = u;
+				}
+				first_[d] = u;
+				++count_[d];
+			}
+
+			auto unlink(node_id u) -> void {
+				auto const d = label_[u];
+				if (previous_[u] != n_) {
+					next_[previous_[u]] = next_[u];
+				}
+				else {
+					first_[d] = next_[u];
+				}
+				if (next_[u] != n_) {
+					previous_[next_[u]] = previous_[u];
+				}
+				--count_[d];
+			}
+
+			// exact distances to target by a backwards search of the residual network, nodes that
+			// can't reach it get the label limit
+			auto global_relabel(node_id target, node_id other, std::size_t limit, bool gap) -> void {
+				label_.assign(n_, limit);
+				label_[target] = 0;
+				auto queue = std::vector<node_id>{target};
+				for (auto i = std::size_t{0}; i < queue.size(); ++i) {
+					auto const v = queue[i];
+					for (auto a = offsets_[v]; a < offsets_[v + 1]; ++a) {
+						auto const u = head_[a];
+						if (u != other && label_[u] == limit && E{} < residual_[reverse_[a]]) {
+							label_[u] = label_[v] + 1;
+							queue.push_back(u);
+						}
+					}
+				}
+				for (auto& bucket : active_) {
+					bucket.clear();
+				}
+				highest_ = 0;
+				if (gap) {
+					next_.assign(n_, static_cast<node_id>(n_));
+					previous_.assign(n_, static_cast<node_id>(n_));
+					first_.assign(n_ + 1, static_cast<node_id>(n_));
+					count_.assign(n_ + 1, 0);
+				}
+				for (auto u = node_id{0}; u < n_; ++u) {
+					current_[u] = offsets_[u];
+					if (label_[u] >= limit || u == target) {
+						continue;
+					}
+					if (gap) {
+						link(u);
+					}
+					if (E{} < excess_[u]) {
+						activate(u);
+					}
+				}
+				work_ = 0;
+			}
+
+			// nothing above an empty label can reach the target any more
+			auto close_gap(std::size_t empty, std::size_t limit) -> void {
+				for (auto d = empty + 1; d < limit; ++d) {
+					while (first_[d] != n_) {
+						auto const u = first_[d];
+						unlink(u);
+						label_[u] = limit;
+					}
+				}
+			}
+
+			auto relabel(node_id u, std::size_t limit, bool gap) -> void {
+				auto const old = label_[u];
+				auto lowest = limit;
+				for (auto a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+					if (E{} < residual_[a]) {
+						lowest = std::min(lowest, label_[head_[a]] + 1);
+					}
+				}
+				work_ += offsets_[u + 1] - offsets_[u] + 12;
+				current_[u] = offsets_[u];
+				if (gap) {
+					unlink(u);
+					if (count_[old] == 0) {
+						close_gap(old, limit);
+						lowest = limit;
+					}
+				}
+				label_[u] = std::min(lowest, limit);
+				if (gap && label_[u] < limit) {
+					link(u);
+				}
+			}
+
+			auto discharge_all(node_id target, node_id other, std::size_t limit, bool gap) -> void {
+				auto const threshold = n_ + head_.size();
+				global_relabel(target, other, limit, gap);
+				while (true) {
+					while (highest_ > 0 && active_[highest_].empty()) {
+						--highest_;
+					}
+					if (active_[highest_].empty()) {
+						return;
+					}
+					auto const u = active_[highest_].back();
+					active_[highest_].pop_back();
+					if (label_[u] != highest_ || !(E{} < excess_[u])) {
+						continue;
+					}
+					discharge(u, target, other, limit, gap);
+					if (E{} < excess_[u] && label_[u] < limit) {
+						activate(u);
+					}
+					if (work_ > threshold) {
+						global_relabel(target, other, limit, gap);
+					}
+				}
+			}
+
+			auto discharge(node_id u, node_id target, node_id other, std::size_t limit, bool gap)
+			   -> void {
+				while (E{} < excess_[u]) {
+					if (current_[u] == offsets_[u + 1]) {
+						relabel(u, limit, gap);
+						// relabelling once is enough, the node goes back on the stack above
+						return;
+					}
+					auto const a = current_[u];
+					auto const v = head_[a];
+					if (!(E{} < residual_[a]) || label_[u] != label_[v] + 1) {
+						++current_[u];
+						continue;
+					}
+					auto const delta = std::min(excess_[u], residual_[a]);
+					residual_[a] -= delta;
+					residual_[reverse_[a]] += delta;
+					excess_[u] -= delta;
+					if (v != target && v != other && !(E{} < excess_[v]) && label_[v] < limit) {
+						activate(v);
+					}
+					excess_[v] += delta;
+				}
+			}
+		};
+	} // namespace detail
+
+	// Maximum flow from source to sink, reading each edge weight as a capacity. Parallel edges add
+	// up and self loops are ignored. The flow between a pair of nodes is handed out to their
+	// parallel edges in the (dst, weight) order of the graph, smallest capacity first.
+	template<typename N, typename E>
+	auto max_flow(csr_graph<N, E> const& g, node_id source, node_id sink) -> flow_result<E> {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::max_flow requires arithmetic edge weights");
+		if (!g.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::max_flow on a csr_graph built without "
+			                         "incoming edges");
+		}
+		if (source == sink) {
+			throw std::runtime_error("Cannot call gdwg::max_flow with the same source and sink");
+		}
+		if (std::any_of(g.weights().begin(), g.weights().end(), [](E const& w) { return w < E{}; })) {
+			throw std::runtime_error("Cannot call gdwg::max_flow on a graph with negative edge "
+			                         "weights");
+		}
+		auto network = detail::push_relabel<E>(g, source, sink);
+		network.solve();
+
+		auto ret = flow_result<E>{network.value(), std::vector<E>(g.num_edges()), {}};
+		ret.source_side = network.source_side();
+		for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+			auto const out = g.out_targets(u);
+			auto const weights = g.out_weights(u);
+			auto remaining = E{};
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				if (i == 0 || out[i] != out[i - 1]) {
+					remaining = out[i] == u ? E{} : network.net_flow(u, out[i]);
+				}
+				auto const flow = std::min(remaining, weights[i]);
+				ret.flow[g.out_offset(u) + i] = flow;
+				remaining -= flow;
+			}
+		}
+		return ret;
+	}
+
+	// One off maximum flow and minimum cut over a graph, see the overload above
+	template<typename N, typename E>
+	auto max_flow(graph<N, E> const& g, N const& source, N const& sink) -> network_flow<N, E> {
+		if (!g.is_node(source) || !g.is_node(sink)) {
+			throw std::runtime_error("Cannot call gdwg::max_flow if src or dst node don't exist in "
+			                         "the graph");
+		}
+		auto const view = csr_graph<N, E>(g);
+		auto const result = max_flow(view, view.id(source), view.id(sink));
+		auto ret = network_flow<N, E>{};
+		ret.value = result.value;
+		ret.edges.reserve(view.num_edges());
+		for (auto u = node_id{0}; u < view.num_nodes(); ++u) {
+			auto const out = view.out_targets(u);
+			auto const weights = view.out_weights(u);
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				ret.edges.push_back(
+				   {view.node(u), view.node(out[i]), weights[i], result.flow[view.out_offset(u) + i]});
+			}
+			(result.source_side[u] ? ret.source_side : ret.sink_side).push_back(view.node(u));
+		}
+		return ret;
+	}
+} // namespace gdwg
+
+#endif // GDWG_MAX_FLOW_HPP
@@ -0,0 +1,472 @@
+#ifndef GDWG_MIN_COST_FLOW_HPP
+#define GDWG_MIN_COST_FLOW_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// The default projection from an edge weight to a capacity and a cost per unit of flow, for
+	// weights like std::pair<int, int> or std::tuple whose first two members are exactly that.
+	// Any type with the same two members works in its place.
+	struct capacity_cost_pair {
+		template<typename E>
+		constexpr auto capacity(E const& weight) const {
+			return std::get<0>(weight);
+		}
+		template<typename E>
+		constexpr auto cost(E const& weight) const {
+			return std::get<1>(weight);
+		}
+	};
+
+	template<typename E, typename Projection>
+	using projected_capacity_t =
+	   std::decay_t<decltype(std::declval<Projection const&>().capacity(std::declval<E const&>()))>;
+
+	template<typename E, typename Projection>
+	using projected_cost_t =
+	   std::decay_t<decltype(std::declval<Projection const&>().cost(std::declval<E const&>()))>;
+
+	// flow[k] is the flow on edge k of the csr_graph's flat edge arrays. The total cost has the
+	// common type of capacities and costs, so fractional flows keep their fractional cost.
+	template<typename C, typename K>
+	struct min_cost_flow_result {
+		C value = C{};
+		std::common_type_t<C, K> cost = {};
+		std::vector<C> flow;
+	};
+
+	template<typename N, typename E, typename C>
+	struct edge_cost_flow {
+		N from;
+		N to;
+		E weight;
+		C flow;
+	};
+
+	// edges are in graph iterator order
+	template<typename N, typename E, typename C, typename K>
+	struct min_cost_network_flow {
+		C value = C{};
+		std::common_type_t<C, K> cost = {};
+		std::vector<edge_cost_flow<N, E, C>> edges;
+	};
+
+	namespace detail {
+		// Primal network simplex over a spanning tree rooted at an artificial node, with the tree
+		// kept as parent pointers, a preorder thread and subtree sizes. Arcs enter by block search
+		// (the most negative reduced cost among the next block of about sqrt(arcs) arcs) and the
+		// leaving arc is picked so the tree stays strongly feasible, which rules out cycling.
+		// Every arc is separate, so parallel edges with different costs stay apart.
+		template<typename C>
+		class network_simplex {
+		public:
+			using cost_type = std::int64_t;
+
+			explicit network_simplex(std::size_t num_nodes)
+			: n_{num_nodes} {}
+
+			auto add_arc(node_id from, node_id to, C capacity, cost_type cost) -> std::size_t {
+				source_.push_back(from);
+				target_.push_back(to);
+				capacity_.push_back(capacity);
+				cost_.push_back(cost);
+				return source_.size() - 1;
+			}
+
+			// A minimum cost circulation. Every node starts on an artificial tree arc to the root
+			// and every other arc at its lower bound, which is feasible since nothing is supplied.
+			auto solve() -> void {
+				auto const arcs = source_.size();
+				root_ = n_;
+				for (auto u = std::size_t{0}; u < n_; ++u) {
+					add_arc(static_cast<node_id>(u), static_cast<node_id>(root_), infinite, 0);
+				}
+				flow_.assign(source_.size(), C{});
+				state_.assign(source_.size(), lower);
+				parent_.assign(n_ + 1, none);
+				pred_.assign(n_ + 1, none);
+				up_.assign(n_ + 1, 1);
+				thread_.assign(n_ + 1, 0);
+				reverse_thread_.assign(n_ + 1, 0);
+				successors_.assign(n_ + 1, 1);
+				last_successor_.assign(n_ + 1, 0);
+				potential_.assign(n_ + 1, 0);
+				successors_[root_] = n_ + 1;
+				last_successor_[root_] = n_ == 0 ? root_ : n_ - 1;
+				thread_[root_] = 0;
+				reverse_thread_[0] = root_;
+				for (auto u = std::size_t{0}; u < n_; ++u) {
+					parent_[u] = root_;
+					pred_[u] = arcs + u;
+					state_[arcs + u] = tree;
+					thread_[u] = u + 1;
+					reverse_thread_[u + 1] = u;
+					last_successor_[u] = u;
+				}
+
+				auto const block = std::max<std::size_t>(
+				   10,
+				   static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(arcs)))));
+				auto next = std::size_t{0};
+				while (find_entering_arc(arcs, block, next)) {
+					find_join_node();
+					auto const change = find_leaving_arc();
+					change_flow(change);
+					if (change) {
+						update_tree();
+						update_potential();
+					}
+				}
+			}
+
+			[[nodiscard]] auto flow(std::size_t arc) const -> C {
+				return flow_[arc];
+			}
+
+		private:
+			static constexpr auto none = std::numeric_limits<std::size_t>::max();
+			static constexpr auto infinite = std::numeric_limits<C>::max();
+			// arc states, the sign a reduced cost is taken with when looking for an entering arc
+			static constexpr signed char upper = -1;
+			static constexpr signed char tree = 0;
+			static constexpr signed char lower = 1;
+
+			std::size_t n_;
+			std::size_t root_ = 0;
+			std::vector<node_id> source_;
+			std::vector<node_id> target_;
+			std::vector<C> capacity_;
+			std::vector<cost_type> cost_;
+			std::vector<C> flow_;
+			std::vector<signed char> state_;
+			// the tree: parent, the arc to it, whether that arc points up, the next node in
+			// preorder and the one before, subtree size and last node of the subtree in preorder
+			std::vector<std::size_t> parent_;
+			std::vector<std::size_t> pred_;
+			std::vector<signed char> up_;
+			std::vector<std::size_t> thread_;
+			std::vector<std::size_t> reverse_thread_;
+			std::vector<std::size_t> successors_;
+			std::vector<std::size_t> last_successor_;
+			std::vector<cost_type> potential_;
+			std::vector<std::size_t> dirty_;
+			// the current pivot
+			std::size_t in_arc_ = 0;
+			std::size_t join_ = 0;
+			std::size_t u_in_ = 0;
+			std::size_t v_in_ = 0;
+			std::size_t u_out_ = 0;
+			C delta_ = C{};
+
+			auto find_entering_arc(std::size_t arcs, std::size_t block, std::size_t& next) -> bool {
+				auto best = cost_type{0};
+				auto count = block;
+				for (auto i = std::size_t{0}; i < arcs; ++i) {
+					auto const e = next + i < arcs ? next + i : next + i - arcs;
+					auto const reduced = state_[e]
+					                     * (cost_[e] + potential_[source_[e]] - potential_[target_[e]]);
+					if (reduced < best) {
+						best = reduced;
+						in_arc_ = e;
+					}
+					if (--count == 0) {
+						if (best < 0) {
+							next = e + 1 == arcs ? 0 : e + 1;
+							return true;
+						}
+						count = block;
+					}
+				}
+				return best < 0;
+			}
+
+			auto find_join_node() -> void {
+				auto u = std::size_t{source_[in_arc_]};
+				auto v = std::size_t{target_[in_arc_]};
+				while (u != v) {
+					if (successors_[u] < successors_[v]) {
+						u = parent_[u];
+					}
+					else {
+						v = parent_[v];
+					}
+				}
+				join_ = u;
+			}
+
+			[[nodiscard]] auto room(std::size_t u, bool increase) const -> C {
+				auto const e = pred_[u];
+				if (!increase) {
+					return flow_[e];
+				}
+				return capacity_[e] == infinite ? infinite : capacity_[e] - flow_[e];
+			}
+
+			// the tree arc with the least room on the cycle, the last one met on the way round
+			// from the join node on ties
+			auto find_leaving_arc() -> bool {
+				auto const forward = state_[in_arc_] == lower;
+				auto const first = std::size_t{forward ? source_[in_arc_] : target_[in_arc_]};
+				auto const second = std::size_t{forward ? target_[in_arc_] : source_[in_arc_]};
+				delta_ = capacity_[in_arc_];
+				auto result = 0;
+				for (auto u = first; u != join_; u = parent_[u]) {
+					auto const d = room(u, up_[u] < 0);
+					if (d < delta_) {
+						delta_ = d;
+						u_out_ = u;
+						result = 1;
+					}
+				}
+				for (auto u = second; u != join_; u = parent_[u]) {
+					auto const d = room(u, up_[u] > 0);
+					if (d <= delta_) {
+						delta_ = d;
+						u_out_ = u;
+						result = 2;
+					}
+				}
+				u_in_ = result == 1 ? first : second;
+				v_in_ = result == 1 ? second : first;
+				return result != 0;
+			}
+
+			auto change_flow(bool change) -> void {
+				if (C{} < delta_) {
+					auto const value = state_[in_arc_] == lower ? delta_ : C{} - delta_;
+					flow_[in_arc_] += value;
+					for (auto u = std::size_t{source_[in_arc_]}; u != join_; u = parent_[u]) {
+						flow_[pred_[u]] += up_[u] > 0 ? C{} - value : value;
+					}
+					for (auto u = std::size_t{target_[in_arc_]}; u != join_; u = parent_[u]) {
+						flow_[pred_[u]] += up_[u] > 0 ? value : C{} - value;
+					}
+				}
+				if (change) {
+					state_[in_arc_] = tree;
+					state_[pred_[u_out_]] = flow_[pred_[u_out_]] == C{} ? lower : upper;
+				}
+				else {
+					state_[in_arc_] = static_cast<signed char>(-state_[in_arc_]);
+				}
+			}
+
+			// Hangs the subtree of u_in below v_in by the entering arc, reversing the stem of
+			// nodes between u_in and u_out whose parents change
+			auto update_tree() -> void {
+				auto const old_reverse_thread = reverse_thread_[u_out_];
+				auto const old_successors = successors_[u_out_];
+				auto const old_last_successor = last_successor_[u_out_];
+				auto const v_out = parent_[u_out_];
+				if (u_in_ == u_out_) {
+					parent_[u_in_] = v_in_;
+					pred_[u_in_] = in_arc_;
+					up_[u_in_] = u_in_ == source_[in_arc_] ? 1 : -1;
+					if (thread_[v_in_] != u_out_) {
+						auto after = thread_[old_last_successor];
+						thread_[old_reverse_thread] = after;
+						reverse_thread_[after] = old_reverse_thread;
+						after = thread_[v_in_];
+						thread_[v_in_] = u_out_;
+						reverse_thread_[u_out_] = v_in_;
+						thread_[old_last_successor] = after;
+						reverse_thread_[after] = old_last_successor;
+					}
+				}
+				else {
+					auto const thread_continue = old_reverse_thread == v_in_
+					                                ? thread_[old_last_successor]
+					                                : thread_[v_in_];
+					auto stem = u_in_;
+					auto parent_stem = v_in_;
+					auto last = last_successor_[u_in_];
+					auto after = thread_[last];
+					thread_[v_in_] = u_in_;
+					dirty_.assign(1, v_in_);
+					while (stem != u_out_) {
+						auto const next_stem = parent_[stem];
+						thread_[last] = next_stem;
+						dirty_.push_back(last);
+						auto const before = reverse_thread_[stem];
+						thread_[before] = after;
+						reverse_thread_[after] = before;
+						parent_[stem] = parent_stem;
+						parent_stem = stem;
+						stem = next_stem;
+						last = last_successor_[stem] == last_successor_[parent_stem]
+						          ? reverse_thread_[parent_stem]
+						          : last_successor_[stem];
+						after = thread_[last];
+					}
+					parent_[u_out_] = parent_stem;
+					thread_[last] = thread_continue;
+					reverse_thread_[thread_continue] = last;
+					last_successor_[u_out_] = last;
+					if (old_reverse_thread != v_in_) {
+						thread_[old_reverse_thread] = after;
+						reverse_thread_[after] = old_reverse_thread;
+					}
+					for (auto const u : dirty_) {
+						reverse_thread_[thread_[u]] = u;
+					}
+					auto count = std::size_t{0};
+					auto const stem_last = last_successor_[u_out_];
+					for (auto u = u_out_, p = parent_[u]; u != u_in_; u = p, p = parent_[u]) {
+						pred_[u] = pred_[p];
+						up_[u] = static_cast<signed char>(-up_[p]);
+						count += successors_[u] - successors_[p];
+						successors_[u] = count;
+						last_successor_[p] = stem_last;
+					}
+					pred_[u_in_] = in_arc_;
+					up_[u_in_] = u_in_ == source_[in_arc_] ? 1 : -1;
+					successors_[u_in_] = old_successors;
+				}
+
+				auto const up_limit = last_successor_[join_] == v_in_ ? join_ : none;
+				auto const last_out = last_successor_[u_out_];
+				for (auto u = v_in_; u != none && last_successor_[u] == v_in_; u = parent_[u]) {
+					last_successor_[u] = last_out;
+				}
+				if (join_ != old_reverse_thread && v_in_ != old_reverse_thread) {
+					for (auto u = v_out; u != up_limit && last_successor_[u] == old_last_successor;
+					     u = parent_[u])
+					{
+						last_successor_[u] = old_reverse_thread;
+					}
+				}
+				else if (last_out != old_last_successor) {
+					for (auto u = v_out; u != up_limit && last_successor_[u] == old_last_successor;
+					     u = parent_[u])
+					{
+						last_successor_[u] = last_out;
+					}
+				}
+				for (auto u = v_in_; u != join_; u = parent_[u]) {
+					successors_[u] += old_successors;
+				}
+				for (auto u = v_out; u != join_; u = parent_[u]) {
+					successors_[u] -= old_successors;
+				}
+			}
+
+			// the moved subtree shifts its potentials so the entering arc's reduced cost is zero
+			auto update_potential() -> void {
+				auto const sigma = potential_[v_in_] - potential_[u_in_]
+				                   - (up_[u_in_] > 0 ? cost_[in_arc_] : -cost_[in_arc_]);
+				auto const end = thread_[last_successor_[u_in_]];
+				for (auto u = u_in_; u != end; u = thread_[u]) {
+					potential_[u] += sigma;
+				}
+			}
+		};
+	} // namespace detail
+
+	// Minimum cost flow from source to sink by the primal network simplex method. Sends limit
+	// units, or as many as the network carries if that's less, at the least total cost.
+	// projection.capacity(w) and projection.cost(w) read the capacity and the cost per unit of
+	// flow of an edge, and every edge is an arc of its own, parallel edges with different costs
+	// included. The flow is solved as a circulation with a return arc from sink to source that
+	// pays more per unit than any path costs, so the value comes first and the cost second.
+	// Costs must be integral and may be negative, in which case flow also goes round cycles of
+	// negative cost (self loops included) wherever that saves something.
+	template<typename N,
+	         typename E,
+	         typename Projection = capacity_cost_pair,
+	         typename C = projected_capacity_t<E, Projection>,
+	         typename K = projected_cost_t<E, Projection>>
+	auto min_cost_flow(csr_graph<N, E> const& g,
+	                   node_id source,
+	                   node_id sink,
+	                   C limit = std::numeric_limits<C>::max(),
+	                   Projection const& projection = {}) -> min_cost_flow_result<C, K> {
+		static_assert(std::is_arithmetic_v<C> && std::is_signed_v<C>,
+		              "gdwg::min_cost_flow requires signed arithmetic capacities");
+		static_assert(std::is_integral_v<K>, "gdwg::min_cost_flow requires integral costs");
+		using cost_type = typename detail::network_simplex<C>::cost_type;
+		if (source == sink) {
+			throw std::runtime_error("Cannot call gdwg::min_cost_flow with the same source and sink");
+		}
+		auto const weights = g.weights();
+		auto const sources = g.edge_sources();
+		auto network = detail::network_simplex<C>(g.num_nodes());
+		auto arc = std::vector<std::size_t>(g.num_edges());
+		// more than any simple path or cycle can cost
+		auto big = cost_type{1};
+		auto out_of_source = C{};
+		for (auto k = std::size_t{0}; k < g.num_edges(); ++k) {
+			auto const capacity = projection.capacity(weights[k]);
+			auto const cost = static_cast<cost_type>(projection.cost(weights[k]));
+			if (capacity < C{}) {
+				throw std::runtime_error("Cannot call gdwg::min_cost_flow on a graph with negative "
+				                         "capacities");
+			}
+			big += cost < 0 ? -cost : cost;
+			if (sources[k] == source && g.targets()[k] != source) {
+				out_of_source = std::numeric_limits<C>::max() - out_of_source < capacity
+				                   ? std::numeric_limits<C>::max()
+				                   : out_of_source + capacity;
+			}
+			arc[k] = network.add_arc(sources[k], g.targets()[k], capacity, cost);
+		}
+		auto const value_arc = network.add_arc(sink,
+		                                       source,
+		                                       std::max(C{}, std::min(limit, out_of_source)),
+		                                       -big);
+		network.solve();
+
+		auto ret = min_cost_flow_result<C, K>{network.flow(value_arc), {}, {}};
+		using total_type = std::common_type_t<C, K>;
+		ret.flow.resize(g.num_edges());
+		for (auto k = std::size_t{0}; k < g.num_edges(); ++k) {
+			ret.flow[k] = network.flow(arc[k]);
+			ret.cost += static_cast<total_type>(ret.flow[k])
+			            * static_cast<total_type>(projection.cost(weights[k]));
+		}
+		return ret;
+	}
+
+	// One off minimum cost flow over a graph, see the overload above
+	template<typename N,
+	         typename E,
+	         typename Projection = capacity_cost_pair,
+	         typename C = projected_capacity_t<E, Projection>,
+	         typename K = projected_cost_t<E, Projection>>
+	auto min_cost_flow(graph<N, E> const& g,
+	                   N const& source,
+	                   N const& sink,
+	                   C limit = std::numeric_limits<C>::max(),
+	                   Projection const& projection = {}) -> min_cost_network_flow<N, E, C, K> {
+		if (!g.is_node(source) || !g.is_node(sink)) {
+			throw std::runtime_error("Cannot call gdwg::min_cost_flow if src or dst node don't exist "
+			                         "in the graph");
+		}
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		auto const result = min_cost_flow(view, view.id(source), view.id(sink), limit, projection);
+		auto ret = min_cost_network_flow<N, E, C, K>{result.value, result.cost, {}};
+		ret.edges.reserve(view.num_edges());
+		for (auto u = node_id{0}; u < view.num_nodes(); ++u) {
+			auto const out = view.out_targets(u);
+			auto const weights = view.out_weights(u);
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				ret.edges.push_back(
+				   {view.node(u), view.node(out[i]), weights[i], result.flow[view.out_offset(u) + i]});
+			}
+		}
+		return ret;
+	}
+} // namespace gdwg
+
+#endif // GDWG_MIN_COST_FLOW_HPP
@@ -0,0 +1,139 @@
+#ifndef GDWG_PAGERANK_HPP
+#define GDWG_PAGERANK_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace gdwg {
+	struct pagerank_options {
+		double damping = 0.85;
+		// stop once the L1 change between two iterations drops below this
+		double tolerance = 1e-10;
+		std::size_t max_iterations = 100;
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+	};
+
+	// rank[u] is the score of node id u (the u-th node of graph::nodes()), the scores sum to 1.
+	// residuals[i] is the L1 change made by iteration i.
+	struct pagerank_result {
+		std::vector<double> rank;
+		std::size_t iterations = 0;
+		std::vector<double> residuals;
+		bool converged = false;
+	};
+
+	// Power iteration over the incoming edges, so each node pulls from its in-neighbours and no two
+	// threads ever write the same entry. Threads get slices of nodes with roughly equal numbers of
+	// incoming edges. Parallel edges count as separate links and the rank of nodes without
+	// outgoing edges is spread evenly over every node.
+	template<typename N, typename E>
+	auto pagerank(csr_graph<N, E> const& g, pagerank_options const& options = {})
+	   -> pagerank_result {
+		if (!g.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::pagerank on a csr_graph built without "
+			                         "incoming edges");
+		}
+		if (options.damping < 0.0 || options.damping > 1.0) {
+			throw std::runtime_error("Cannot call gdwg::pagerank with a damping factor outside "
+			                         "[0, 1]");
+		}
+		auto const n = g.num_nodes();
+		auto ret = pagerank_result{};
+		if (n == 0) {
+			ret.converged = true;
+			return ret;
+		}
+
+		auto pool = detail::thread_pool(options.threads);
+		auto const threads = pool.size();
+		// slice boundaries balanced on incoming edges rather than nodes
+		auto const in_offsets = g.in_offsets();
+		auto bounds = std::vector<std::size_t>(threads + 1, n);
+		bounds[0] = 0;
+		for (auto t = std::size_t{1}; t < threads; ++t) {
+			auto const target = g.num_edges() * t / threads;
+			bounds[t] = static_cast<std::size_t>(
+			   std::lower_bound(in_offsets.begin(), in_offsets.end() - 1, target) - in_offsets.begin());
+			bounds[t] = std::max(bounds[t], bounds[t - 1]);
+		}
+
+		auto inverse_degree = std::vector<double>(n);
+		for (auto u = node_id{0}; u < n; ++u) {
+			auto const degree = g.out_degree(u);
+			inverse_degree[u] = degree == 0 ? 0.0 : 1.0 / static_cast<double>(degree);
+		}
+		auto const uniform = 1.0 / static_cast<double>(n);
+		ret.rank.assign(n, uniform);
+		auto next = std::vector<double>(n);
+		auto contribution = std::vector<double>(n);
+		auto dangling = std::vector<detail::padded<double>>(threads);
+		auto residual = std::vector<detail::padded<double>>(threads);
+		auto const sources = g.sources();
+
+		auto const for_each_slice = [&](auto&& fn) {
+			pool.parallel_for(threads, [&](std::size_t, std::size_t first, std::size_t last) {
+				for (auto t = first; t < last; ++t) {
+					fn(t, bounds[t], bounds[t + 1]);
+				}
+			});
+		};
+
+		while (ret.iterations < options.max_iterations) {
+			// contiguous loops so the compiler can vectorise them
+			for_each_slice([&](std::size_t t, std::size_t begin, std::size_t end) {
+				auto sum = 0.0;
+				for (auto u = begin; u < end; ++u) {
+					contribution[u] = ret.rank[u] * inverse_degree[u];
+					sum += inverse_degree[u] == 0.0 ? ret.rank[u] : 0.0;
+				}
+				dangling[t].value = sum;
+			});
+			auto dangling_sum = 0.0;
+			for (auto const& d : dangling) {
+				dangling_sum += d.value;
+			}
+			auto const base = (1.0 - options.damping) * uniform
+			                  + options.damping * dangling_sum * uniform;
+
+			for_each_slice([&](std::size_t t, std::size_t begin, std::size_t end) {
+				auto change = 0.0;
+				for (auto v = begin; v < end; ++v) {
+					auto pulled = 0.0;
+					for (auto k = in_offsets[v]; k < in_offsets[v + 1]; ++k) {
+						pulled += contribution[sources[k]];
+					}
+					next[v] = base + options.damping * pulled;
+					change += std::abs(next[v] - ret.rank[v]);
+				}
+				residual[t].value = change;
+			});
+			auto total = 0.0;
+			for (auto const& r : residual) {
+				total += r.value;
+			}
+			ret.rank.swap(next);
+			ret.residuals.push_back(total);
+			++ret.iterations;
+			if (total < options.tolerance) {
+				ret.converged = true;
+				break;
+			}
+		}
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto pagerank(graph<N, E> const& g, pagerank_options const& options = {}) -> pagerank_result {
+		return pagerank(csr_graph<N, E>(g), options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_PAGERANK_HPP
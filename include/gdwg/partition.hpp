@@ -0,0 +1,880 @@
+#ifndef GDWG_PARTITION_HPP
+#define GDWG_PARTITION_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	using part_id = std::uint32_t;
+
+	struct partition_options {
+		// every part may hold at most (1 + imbalance) times its share of the nodes
+		double imbalance = 0.03;
+		// coarsening stops once there are at most this many nodes per part
+		std::size_t coarsen_to = 20;
+		// greedy bisections tried at every split of the coarsest graph, the smallest cut wins
+		std::size_t initial_tries = 4;
+		// FM passes per level, each stops early once it no longer lowers the cut
+		std::size_t refinement_passes = 8;
+		std::uint64_t seed = 6771;
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+	};
+
+	// part[u] is the part of node id u (the u-th node of graph::nodes()), sizes[p] the number of
+	// nodes in part p. cut is the summed weight of the edges between different parts.
+	struct partition_result {
+		std::vector<part_id> part;
+		double cut = 0.0;
+		std::vector<std::size_t> sizes;
+		// graphs in the hierarchy, the input included
+		std::size_t levels = 0;
+	};
+
+	namespace detail {
+		// One level of the hierarchy: an undirected graph without self loops where u -> v and
+		// v -> u were merged into one edge each way, and every node weighs as much as the nodes of
+		// the input it stands for.
+		struct partition_level {
+			std::vector<std::size_t> offsets;
+			std::vector<node_id> targets;
+			std::vector<double> weights;
+			std::vector<std::size_t> node_weights;
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return node_weights.size();
+			}
+		};
+
+		// The input as the finest level. Nodes without edges to other nodes can't change the cut,
+		// so they're left out and their ids written to isolated, to be placed last wherever
+		// there's room. Without them as ballast the parts of the rest may be uneven, which gives
+		// refinement slack to move nodes it would otherwise have to climb for.
+		template<typename N, typename E>
+		auto make_partition_level(csr_graph<N, E> const& g,
+		                          std::vector<node_id>& kept,
+		                          std::vector<node_id>& isolated,
+		                          thread_pool& pool) -> partition_level {
+			auto const sources = g.edge_sources();
+			auto const targets = g.targets();
+			auto const weights = g.weights();
+			auto degree = std::vector<std::size_t>(g.num_nodes(), 0);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				if (sources[k] != targets[k]) {
+					++degree[sources[k]];
+					++degree[targets[k]];
+				}
+			}
+			// the compact id of every node kept
+			auto compact = std::vector<node_id>(g.num_nodes());
+			for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+				compact[u] = static_cast<node_id>(kept.size());
+				(degree[u] == 0 ? isolated : kept).push_back(u);
+			}
+			auto const n = kept.size();
+			auto ret = partition_level{std::vector<std::size_t>(n + 1, 0), {}, {}, {}};
+			ret.node_weights.assign(n, 1);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				ret.offsets[u + 1] = ret.offsets[u] + degree[kept[u]];
+			}
+			auto edges = std::vector<std::pair<node_id, double>>(ret.offsets[n]);
+			auto next = std::vector<std::size_t>(ret.offsets.begin(), ret.offsets.end() - 1);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				if (sources[k] != targets[k]) {
+					auto const u = compact[sources[k]];
+					auto const v = compact[targets[k]];
+					auto const w = static_cast<double>(weights[k]);
+					edges[next[u]++] = {v, w};
+					edges[next[v]++] = {u, w};
+				}
+			}
+			// rows sorted and merged in place, then squeezed together
+			auto length = std::vector<std::size_t>(n, 0);
+			pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+				for (auto u = begin; u < end; ++u) {
+					auto const first = edges.begin() + static_cast<std::ptrdiff_t>(ret.offsets[u]);
+					auto const last = edges.begin() + static_cast<std::ptrdiff_t>(ret.offsets[u + 1]);
+					std::sort(first, last, [](auto const& lhs, auto const& rhs) {
+						return lhs.first < rhs.first;
+					});
+					auto out = first;
+					for (auto it = first; it != last; ++it) {
+						if (out != first && std::prev(out)->first == it->first) {
+							std::prev(out)->second += it->second;
+						}
+						else {
+							*out++ = *it;
+						}
+					}
+					length[u] = static_cast<std::size_t>(out - first);
+				}
+			});
+			auto write = std::size_t{0};
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				for (auto k = ret.offsets[u]; k < ret.offsets[u] + length[u]; ++k) {
+					ret.targets.push_back(edges[k].first);
+					ret.weights.push_back(edges[k].second);
+				}
+				ret.offsets[u] = write;
+				write += length[u];
+			}
+			ret.offsets[n] = write;
+			return ret;
+		}
+
+		// the same value for u -> v and v -> u, so both ends agree on how to break a tie
+		inline auto pair_hash(node_id u, node_id v, std::uint64_t seed) noexcept -> std::uint64_t {
+			auto x = (std::uint64_t{std::min(u, v)} << 32 | std::max(u, v)) ^ seed;
+			x ^= x >> 33;
+			x *= 0xFF51AFD7ED558CCDULL;
+			x ^= x >> 33;
+			x *= 0xC4CEB9FE1A85EC53ULL;
+			x ^= x >> 33;
+			return x;
+		}
+
+		// Heavy edge matching in rounds: every unmatched node proposes to the neighbour behind its
+		// heaviest edge that's still free, and pairs proposing to each other match. Nodes only
+		// write their own proposal and the smaller node of a pair writes the match, so the threads
+		// never conflict and the matching doesn't depend on how many there are. Returns the coarse
+		// node of every node and how many coarse nodes there are.
+		inline auto heavy_edge_matching(partition_level const& level,
+		                                std::size_t max_node_weight,
+		                                std::uint64_t seed,
+		                                thread_pool& pool)
+		   -> std::pair<std::vector<node_id>, std::size_t> {
+			auto const n = level.size();
+			constexpr auto none = std::numeric_limits<node_id>::max();
+			auto match = std::vector<node_id>(n, none);
+			auto proposal = std::vector<node_id>(n, none);
+			for (auto round = 0; round < 4; ++round) {
+				pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+					for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+						proposal[u] = none;
+						if (match[u] != none) {
+							continue;
+						}
+						auto best_weight = 0.0;
+						auto best_hash = std::uint64_t{0};
+						for (auto k = level.offsets[u]; k < level.offsets[u + 1]; ++k) {
+							auto const v = level.targets[k];
+							if (match[v] != none
+							    || level.node_weights[u] + level.node_weights[v] > max_node_weight)
+							{
+								continue;
+							}
+							auto const w = level.weights[k];
+							if (proposal[u] != none && w < best_weight) {
+								continue;
+							}
+							auto const hash = pair_hash(u, v, seed + static_cast<std::uint64_t>(round));
+							if (proposal[u] == none || w > best_weight || hash > best_hash) {
+								proposal[u] = v;
+								best_weight = w;
+								best_hash = hash;
+							}
+						}
+					}
+				});
+				pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+					for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+						auto const v = proposal[u];
+						if (v != none && u < v && proposal[v] == u) {
+							match[u] = v;
+							match[v] = u;
+						}
+					}
+				});
+			}
+			// Nodes left over are mostly leaves of a hub whose one partner is taken, or isolated.
+			// Those sharing a heaviest neighbour, and isolated nodes among themselves, are paired
+			// two hops apart so a star still halves.
+			auto& anchor = proposal;
+			pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+				for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+					anchor[u] = match[u] != none ? none : static_cast<node_id>(n);
+					if (match[u] != none) {
+						continue;
+					}
+					auto best_weight = 0.0;
+					for (auto k = level.offsets[u]; k < level.offsets[u + 1]; ++k) {
+						if (anchor[u] == n || level.weights[k] > best_weight) {
+							anchor[u] = level.targets[k];
+							best_weight = level.weights[k];
+						}
+					}
+				}
+			});
+			auto bucket = std::vector<std::size_t>(n + 2, 0);
+			for (auto u = node_id{0}; u < n; ++u) {
+				if (anchor[u] != none) {
+					++bucket[anchor[u] + 1];
+				}
+			}
+			for (auto a = std::size_t{0}; a <= n; ++a) {
+				bucket[a + 1] += bucket[a];
+			}
+			auto grouped = std::vector<node_id>(bucket[n + 1]);
+			for (auto u = node_id{0}; u < n; ++u) {
+				if (anchor[u] != none) {
+					grouped[bucket[anchor[u]]++] = u;
+				}
+			}
+			for (auto k = std::size_t{0}; k + 1 < grouped.size(); ++k) {
+				auto const u = grouped[k];
+				auto const v = grouped[k + 1];
+				if (anchor[u] == anchor[v]
+				    && level.node_weights[u] + level.node_weights[v] <= max_node_weight)
+				{
+					match[u] = v;
+					match[v] = u;
+					++k;
+				}
+			}
+			auto coarse = std::vector<node_id>(n);
+			auto count = node_id{0};
+			for (auto u = node_id{0}; u < n; ++u) {
+				if (match[u] == none || match[u] > u) {
+					coarse[u] = count++;
+				}
+				else {
+					coarse[u] = coarse[match[u]];
+				}
+			}
+			return {std::move(coarse), std::size_t{count}};
+		}
+
+		// The next level, one node per coarse node and edges between them summed. Each thread
+		// builds the rows of a contiguous run of coarse nodes into its own buffers, which are then
+		// copied into place.
+		inline auto contract(partition_level const& level,
+		                     std::vector<node_id> const& coarse,
+		                     std::size_t count,
+		                     thread_pool& pool) -> partition_level {
+			auto const n = level.size();
+			// the one or two nodes making up every coarse node
+			auto members = std::vector<std::pair<node_id, node_id>>(
+			   count,
+			   {std::numeric_limits<node_id>::max(), std::numeric_limits<node_id>::max()});
+			for (auto u = node_id{0}; u < n; ++u) {
+				auto& m = members[coarse[u]];
+				(m.first == std::numeric_limits<node_id>::max() ? m.first : m.second) = u;
+			}
+			auto ret = partition_level{std::vector<std::size_t>(count + 1, 0), {}, {}, {}};
+			ret.node_weights.resize(count);
+			auto const threads = pool.size();
+			auto buffers = std::vector<std::vector<std::pair<node_id, double>>>(threads);
+			auto firsts = std::vector<std::size_t>(threads, count);
+			pool.parallel_for(count, [&](std::size_t thread, std::size_t begin, std::size_t end) {
+				auto& buffer = buffers[thread];
+				firsts[thread] = begin;
+				// where each coarse neighbour sits in the current row
+				auto slot = std::vector<std::size_t>(count, std::numeric_limits<std::size_t>::max());
+				for (auto c = begin; c < end; ++c) {
+					auto const row = buffer.size();
+					auto const add = [&](node_id u) {
+						ret.node_weights[c] += level.node_weights[u];
+						for (auto k = level.offsets[u]; k < level.offsets[u + 1]; ++k) {
+							auto const d = coarse[level.targets[k]];
+							if (d == c) {
+								continue;
+							}
+							if (slot[d] == std::numeric_limits<std::size_t>::max() || slot[d] < row) {
+								slot[d] = buffer.size();
+								buffer.emplace_back(d, 0.0);
+							}
+							buffer[slot[d]].second += level.weights[k];
+						}
+					};
+					add(members[c].first);
+					if (members[c].second != std::numeric_limits<node_id>::max()) {
+						add(members[c].second);
+					}
+					ret.offsets[c + 1] = buffer.size() - row;
+				}
+			});
+			for (auto c = std::size_t{0}; c < count; ++c) {
+				ret.offsets[c + 1] += ret.offsets[c];
+			}
+			ret.targets.resize(ret.offsets[count]);
+			ret.weights.resize(ret.offsets[count]);
+			pool.parallel_for(threads, [&](std::size_t, std::size_t first, std::size_t last) {
+				for (auto t = first; t < last; ++t) {
+					auto k = firsts[t] < count ? ret.offsets[firsts[t]] : 0;
+					for (auto const& [d, w] : buffers[t]) {
+						ret.targets[k] = d;
+						ret.weights[k] = w;
+						++k;
+					}
+				}
+			});
+			return ret;
+		}
+
+		// A partition of one level being improved. Every node keeps the weight joining it to each
+		// part next to it, at most min(degree, k) entries, so a move updates its neighbours in
+		// O(k) each instead of them all being gathered again, which on a hub would cost its whole
+		// degree for every neighbour that moves.
+		class partition_refiner {
+		public:
+			partition_refiner(partition_level const& level,
+			                  std::vector<part_id>& part,
+			                  std::vector<std::size_t> limits)
+			: level_(level)
+			, part_(part)
+			, part_weights_(limits.size(), 0)
+			, limits_(std::move(limits))
+			, offsets_(level.size() + 1, 0)
+			, sizes_(level.size(), 0) {
+				auto const n = level.size();
+				auto const parts = limits_.size();
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					auto const degree = level.offsets[u + 1] - level.offsets[u];
+					offsets_[u + 1] = offsets_[u] + std::min(degree, parts);
+				}
+				entries_.resize(offsets_[n]);
+				for (auto u = node_id{0}; u < n; ++u) {
+					part_weights_[part_[u]] += level.node_weights[u];
+					for (auto k = level.offsets[u]; k < level.offsets[u + 1]; ++k) {
+						auto const p = part_[level.targets[k]];
+						find_or_add(u, p).weight += level.weights[k];
+						if (p != part_[u]) {
+							cut_ += level.weights[k];
+						}
+					}
+				}
+				// every edge was seen from both ends
+				cut_ /= 2.0;
+				for (auto p = part_id{0}; p < parts; ++p) {
+					excess_ += over(p);
+				}
+			}
+
+			// The best place for u to go: the part next to it with room that gains the most, or when
+			// u's part is over its limit and no such part exists, the part with the most room.
+			// Returns false if there's nowhere to go.
+			[[nodiscard]] auto best_move(node_id u, part_id& to, double& gain) const -> bool {
+				auto const from = part_[u];
+				auto const weight = level_.node_weights[u];
+				auto const internal = joined(u, from);
+				auto found = false;
+				for (auto i = offsets_[u]; i < offsets_[u] + sizes_[u]; ++i) {
+					auto const& [p, edges, w] = entries_[i];
+					if (p == from || part_weights_[p] + weight > limits_[p]) {
+						continue;
+					}
+					if (!found || w - internal > gain) {
+						found = true;
+						to = p;
+						gain = w - internal;
+					}
+				}
+				if (!found && over(from) != 0) {
+					auto roomiest = from;
+					for (auto p = part_id{0}; p < limits_.size(); ++p) {
+						if (room(p) > room(roomiest)) {
+							roomiest = p;
+						}
+					}
+					if (roomiest != from && weight <= room(roomiest)) {
+						found = true;
+						to = roomiest;
+						gain = joined(u, roomiest) - internal;
+					}
+				}
+				return found;
+			}
+
+			auto move(node_id u, part_id to) -> void {
+				auto const from = part_[u];
+				cut_ -= joined(u, to) - joined(u, from);
+				excess_ -= over(from) + over(to);
+				part_weights_[from] -= level_.node_weights[u];
+				part_weights_[to] += level_.node_weights[u];
+				excess_ += over(from) + over(to);
+				part_[u] = to;
+				for (auto k = level_.offsets[u]; k < level_.offsets[u + 1]; ++k) {
+					auto const v = level_.targets[k];
+					remove(v, from, level_.weights[k]);
+					find_or_add(v, to).weight += level_.weights[k];
+				}
+			}
+
+			// whether u has a neighbour in another part
+			[[nodiscard]] auto boundary(node_id u) const noexcept -> bool {
+				return sizes_[u] > 1 || (sizes_[u] == 1 && entries_[offsets_[u]].part != part_[u]);
+			}
+
+			[[nodiscard]] auto over(part_id p) const noexcept -> std::size_t {
+				return part_weights_[p] > limits_[p] ? part_weights_[p] - limits_[p] : 0;
+			}
+
+			[[nodiscard]] auto room(part_id p) const noexcept -> std::size_t {
+				return part_weights_[p] < limits_[p] ? limits_[p] - part_weights_[p] : 0;
+			}
+
+			// what a partition is judged by, the weight over the limit before the cut
+			[[nodiscard]] auto score() const noexcept -> std::pair<std::size_t, double> {
+				return {excess_, cut_};
+			}
+
+			[[nodiscard]] auto level() const noexcept -> partition_level const& {
+				return level_;
+			}
+
+			[[nodiscard]] auto part(node_id u) const noexcept -> part_id {
+				return part_[u];
+			}
+
+		private:
+			struct entry {
+				part_id part = 0;
+				std::uint32_t edges = 0;
+				double weight = 0.0;
+			};
+
+			partition_level const& level_;
+			std::vector<part_id>& part_;
+			std::vector<std::size_t> part_weights_;
+			std::vector<std::size_t> limits_;
+			std::size_t excess_ = 0;
+			double cut_ = 0.0;
+			std::vector<std::size_t> offsets_;
+			std::vector<std::size_t> sizes_;
+			std::vector<entry> entries_;
+
+			[[nodiscard]] auto joined(node_id u, part_id p) const noexcept -> double {
+				for (auto i = offsets_[u]; i < offsets_[u] + sizes_[u]; ++i) {
+					if (entries_[i].part == p) {
+						return entries_[i].weight;
+					}
+				}
+				return 0.0;
+			}
+
+			auto find_or_add(node_id u, part_id p) -> entry& {
+				auto const first = offsets_[u];
+				for (auto i = first; i < first + sizes_[u]; ++i) {
+					if (entries_[i].part == p) {
+						++entries_[i].edges;
+						return entries_[i];
+					}
+				}
+				auto& ret = entries_[first + sizes_[u]++];
+				ret = entry{p, 1, 0.0};
+				return ret;
+			}
+
+			// the entry goes once its last edge does, so rounding never leaves a part behind
+			auto remove(node_id u, part_id p, double weight) -> void {
+				auto const first = offsets_[u];
+				for (auto i = first; i < first + sizes_[u]; ++i) {
+					if (entries_[i].part == p) {
+						entries_[i].weight -= weight;
+						if (--entries_[i].edges == 0) {
+							entries_[i] = entries_[first + --sizes_[u]];
+						}
+						return;
+					}
+				}
+			}
+		};
+
+		// Moves nodes out of parts over the limit, those losing the least cut first, until every
+		// part fits or nothing more can move.
+		inline auto rebalance(partition_refiner& refiner) -> void {
+			auto const n = refiner.level().size();
+			for (auto sweep = 0; sweep < 4 && refiner.score().first != 0; ++sweep) {
+				auto candidates = std::vector<std::pair<double, node_id>>();
+				for (auto u = node_id{0}; u < n; ++u) {
+					auto to = part_id{0};
+					auto gain = 0.0;
+					if (refiner.over(refiner.part(u)) != 0 && refiner.best_move(u, to, gain)) {
+						candidates.emplace_back(gain, u);
+					}
+				}
+				auto const by_gain = [](auto const& a, auto const& b) { return a.first > b.first; };
+				std::stable_sort(candidates.begin(), candidates.end(), by_gain);
+				for (auto const& [ignored, u] : candidates) {
+					auto to = part_id{0};
+					auto gain = 0.0;
+					if (refiner.over(refiner.part(u)) != 0 && refiner.best_move(u, to, gain)) {
+						refiner.move(u, to);
+					}
+				}
+			}
+		}
+
+		// K-way Fiduccia-Mattheyses: nodes move one at a time, best gain first and each at most
+		// once a pass, even when that makes the cut worse for a while, and the pass is rolled back
+		// to the best state it went through. No move ever takes a part over the limit.
+		inline auto refine(partition_refiner& refiner, std::size_t passes) -> void {
+			auto const& level = refiner.level();
+			auto const n = level.size();
+			auto locked = std::vector<char>(n, 0);
+			auto version = std::vector<std::uint32_t>(n, 0);
+			// gain, node, the node's version when queued
+			using entry = std::tuple<double, node_id, std::uint32_t>;
+			auto heap = std::priority_queue<entry>();
+			auto moves = std::vector<std::pair<node_id, part_id>>();
+			// how far a pass may climb without finding anything better
+			auto const limit = std::max<std::size_t>(64, n / 100);
+			auto const queue = [&](node_id u) {
+				auto to = part_id{0};
+				auto gain = 0.0;
+				++version[u];
+				if (refiner.best_move(u, to, gain)) {
+					heap.emplace(gain, u, version[u]);
+				}
+			};
+			for (auto pass = std::size_t{0}; pass < passes; ++pass) {
+				heap = {};
+				moves.clear();
+				std::fill(locked.begin(), locked.end(), 0);
+				for (auto u = node_id{0}; u < n; ++u) {
+					if (refiner.boundary(u) || refiner.over(refiner.part(u)) != 0) {
+						queue(u);
+					}
+				}
+				auto const start = refiner.score();
+				auto best = start;
+				auto best_moves = std::size_t{0};
+				auto since_best = std::size_t{0};
+				while (!heap.empty() && since_best < limit) {
+					auto const [ignored, u, queued_version] = heap.top();
+					heap.pop();
+					auto to = part_id{0};
+					auto gain = 0.0;
+					if (locked[u] != 0 || queued_version != version[u]
+					    || !refiner.best_move(u, to, gain))
+					{
+						continue;
+					}
+					moves.emplace_back(u, refiner.part(u));
+					refiner.move(u, to);
+					locked[u] = 1;
+					auto const score = refiner.score();
+					if (score.first < best.first
+					    || (score.first == best.first && score.second < best.second - 1e-9))
+					{
+						best = score;
+						best_moves = moves.size();
+						since_best = 0;
+					}
+					else {
+						++since_best;
+					}
+					for (auto k = level.offsets[u]; k < level.offsets[u + 1]; ++k) {
+						if (locked[level.targets[k]] == 0) {
+							queue(level.targets[k]);
+						}
+					}
+				}
+				while (moves.size() > best_moves) {
+					refiner.move(moves.back().first, moves.back().second);
+					moves.pop_back();
+				}
+				if (!(best < start)) {
+					break;
+				}
+			}
+		}
+
+		// Greedy graph growing: part 0 starts from a random node and keeps taking the free node most
+		// strongly joined to it until it weighs target, and part 1 is whatever's left.
+		inline auto grow_bisection(partition_level const& level,
+		                           std::size_t target,
+		                           std::size_t limit,
+		                           std::mt19937_64& rng) -> std::vector<part_id> {
+			auto const n = level.size();
+			auto part = std::vector<part_id>(n, 1);
+			auto connection = std::vector<double>(n, 0.0);
+			auto free = std::vector<node_id>(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				free[u] = u;
+			}
+			std::shuffle(free.begin(), free.end(), rng);
+			auto heap = std::priority_queue<std::pair<double, node_id>>();
+			auto next_free = std::size_t{0};
+			auto weight = std::size_t{0};
+			while (weight < target) {
+				if (heap.empty()) {
+					// the region ran out of neighbours, so it carries on from another node
+					while (next_free < n && part[free[next_free]] == 0) {
+						++next_free;
+					}
+					if (next_free == n) {
+						break;
+					}
+					heap.emplace(connection[free[next_free]], free[next_free]);
+					++next_free;
+				}
+				auto const [joined, u] = heap.top();
+				heap.pop();
+				if (part[u] == 0 || joined != connection[u] || weight + level.node_weights[u] > limit) {
+					continue;
+				}
+				part[u] = 0;
+				weight += level.node_weights[u];
+				for (auto k = level.offsets[u]; k < level.offsets[u + 1]; ++k) {
+					auto const v = level.targets[k];
+					if (part[v] != 0) {
+						connection[v] += level.weights[k];
+						heap.emplace(connection[v], v);
+					}
+				}
+			}
+			return part;
+		}
+
+		// the subgraph on nodes, which must be sorted, numbered in their order
+		inline auto induced(partition_level const& level, std::vector<node_id> const& nodes)
+		   -> partition_level {
+			constexpr auto none = std::numeric_limits<node_id>::max();
+			auto local = std::vector<node_id>(level.size(), none);
+			for (auto i = std::size_t{0}; i < nodes.size(); ++i) {
+				local[nodes[i]] = static_cast<node_id>(i);
+			}
+			auto ret = partition_level{{0}, {}, {}, {}};
+			for (auto const u : nodes) {
+				for (auto k = level.offsets[u]; k < level.offsets[u + 1]; ++k) {
+					if (local[level.targets[k]] != none) {
+						ret.targets.push_back(local[level.targets[k]]);
+						ret.weights.push_back(level.weights[k]);
+					}
+				}
+				ret.offsets.push_back(ret.targets.size());
+				ret.node_weights.push_back(level.node_weights[u]);
+			}
+			return ret;
+		}
+
+		struct bisection_options {
+			double imbalance = 0.0;
+			std::size_t tries = 1;
+			std::size_t passes = 1;
+		};
+
+		// Recursive bisection of the coarsest level into parts first, ..., first + parts - 1, each
+		// half getting a share of the weight in proportion to the parts it's split into later. ids
+		// are the nodes of level in the graph whose part is written.
+		inline auto bisect(partition_level const& level,
+		                   std::vector<node_id> const& ids,
+		                   part_id first,
+		                   std::size_t parts,
+		                   bisection_options const& options,
+		                   std::vector<part_id>& part,
+		                   std::mt19937_64& rng) -> void {
+			if (parts == 1 || level.size() == 0) {
+				for (auto const u : ids) {
+					part[u] = first;
+				}
+				return;
+			}
+			auto total = std::size_t{0};
+			for (auto const w : level.node_weights) {
+				total += w;
+			}
+			auto const heaviest =
+			   *std::max_element(level.node_weights.begin(), level.node_weights.end());
+			auto const left = parts / 2;
+			auto const target = std::vector<std::size_t>{total * left / parts,
+			                                             total - total * left / parts};
+			auto limits = std::vector<std::size_t>(2);
+			for (auto side = 0; side < 2; ++side) {
+				auto const loose = (1.0 + options.imbalance) * static_cast<double>(target[side]);
+				limits[side] =
+				   std::max(static_cast<std::size_t>(std::ceil(loose)), target[side] + heaviest);
+			}
+			auto best = std::vector<part_id>();
+			auto best_score = std::make_pair(std::size_t{0}, 0.0);
+			for (auto attempt = std::size_t{0}; attempt < std::max<std::size_t>(options.tries, 1);
+			     ++attempt)
+			{
+				auto side = grow_bisection(level, target[0], limits[0], rng);
+				auto refiner = partition_refiner(level, side, limits);
+				rebalance(refiner);
+				refine(refiner, options.passes);
+				if (best.empty() || refiner.score() < best_score) {
+					best_score = refiner.score();
+					best = std::move(side);
+				}
+			}
+			for (auto side = part_id{0}; side < 2; ++side) {
+				auto nodes = std::vector<node_id>();
+				auto sub_ids = std::vector<node_id>();
+				for (auto u = node_id{0}; u < level.size(); ++u) {
+					if (best[u] == side) {
+						nodes.push_back(u);
+						sub_ids.push_back(ids[u]);
+					}
+				}
+				bisect(induced(level, nodes),
+				       sub_ids,
+				       side == 0 ? first : static_cast<part_id>(first + left),
+				       side == 0 ? left : parts - left,
+				       options,
+				       part,
+				       rng);
+			}
+		}
+	} // namespace detail
+
+	// the summed weight of the edges whose ends are in different parts
+	template<typename N, typename E>
+	auto edge_cut(csr_graph<N, E> const& g, std::vector<part_id> const& part) -> double {
+		auto ret = 0.0;
+		auto const sources = g.edge_sources();
+		auto const targets = g.targets();
+		auto const weights = g.weights();
+		for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+			if (part[sources[k]] != part[targets[k]]) {
+				ret += static_cast<double>(weights[k]);
+			}
+		}
+		return ret;
+	}
+
+	// Multilevel k-way partitioning in the style of METIS. The graph is coarsened by heavy edge
+	// matching, computed and contracted on every thread, until a few nodes per part are left. The
+	// coarsest graph is split by greedy graph growing a few times over, the best split is kept,
+	// and it's then projected back up one level at a time with k-way FM refinement at each. Edges
+	// are read as undirected, so u -> v and v -> u add up, and weights must not be negative.
+	// Every part holds at most (1 + imbalance) times n / k nodes, rounded up, wherever coarse
+	// nodes allow it.
+	template<typename N, typename E>
+	auto multilevel_partition(csr_graph<N, E> const& g,
+	                          std::size_t k,
+	                          partition_options const& options = {}) -> partition_result {
+		static_assert(std::is_arithmetic_v<E>,
+		              "gdwg::multilevel_partition requires arithmetic edge weights");
+		if (k == 0) {
+			throw std::runtime_error("Cannot call gdwg::multilevel_partition with no parts");
+		}
+		auto const negative = [](E const& w) { return w < E{}; };
+		if (std::any_of(g.weights().begin(), g.weights().end(), negative)) {
+			throw std::runtime_error("Cannot call gdwg::multilevel_partition on a graph with "
+			                         "negative edge weights");
+		}
+		auto const n = g.num_nodes();
+		auto ret =
+		   partition_result{std::vector<part_id>(n, 0), 0.0, std::vector<std::size_t>(k, 0), 1};
+		if (n == 0 || k == 1) {
+			ret.sizes[0] = n;
+			return ret;
+		}
+		auto const max_weight = static_cast<std::size_t>(
+		   std::ceil((1.0 + std::max(options.imbalance, 0.0)) * static_cast<double>(n)
+		             / static_cast<double>(k)));
+		auto pool = detail::thread_pool(options.threads);
+		auto rng = std::mt19937_64(options.seed);
+
+		auto levels = std::vector<detail::partition_level>();
+		auto maps = std::vector<std::vector<node_id>>();
+		auto kept = std::vector<node_id>();
+		auto isolated = std::vector<node_id>();
+		levels.push_back(detail::make_partition_level(g, kept, isolated, pool));
+		auto const coarsest_size = std::max<std::size_t>(options.coarsen_to, 1) * k;
+		// heavier coarse nodes would leave the greedy split too little to balance with
+		auto const max_node_weight = std::max<std::size_t>(
+		   1,
+		   static_cast<std::size_t>(1.5 * static_cast<double>(kept.size())
+		                            / static_cast<double>(coarsest_size)));
+		while (levels.back().size() > coarsest_size) {
+			auto [coarse, count] = detail::heavy_edge_matching(levels.back(),
+			                                                    max_node_weight,
+			                                                    rng(),
+			                                                    pool);
+			// too little shrinkage left to be worth another level
+			if (10 * count > 9 * levels.back().size()) {
+				break;
+			}
+			levels.push_back(detail::contract(levels.back(), coarse, count, pool));
+			maps.push_back(std::move(coarse));
+		}
+		ret.levels = levels.size();
+
+		// A coarse node heavier than the slack the imbalance leaves could never move, so coarse
+		// levels may go over by one node and the finest level is held to the real limit.
+		auto const limit = [&](detail::partition_level const& level) {
+			if (&level == &levels.front()) {
+				return max_weight;
+			}
+			auto const heaviest =
+			   *std::max_element(level.node_weights.begin(), level.node_weights.end());
+			return std::max(max_weight, (n + k - 1) / k + heaviest);
+		};
+		auto const& coarsest = levels.back();
+		auto part = std::vector<part_id>(coarsest.size());
+		auto ids = std::vector<node_id>(coarsest.size());
+		std::iota(ids.begin(), ids.end(), node_id{0});
+		detail::bisect(coarsest,
+		               ids,
+		               0,
+		               k,
+		               {options.imbalance, options.initial_tries, options.refinement_passes},
+		               part,
+		               rng);
+		auto const improve = [&](detail::partition_level const& level) {
+			auto refiner = detail::partition_refiner(level, part, std::vector(k, limit(level)));
+			detail::rebalance(refiner);
+			detail::refine(refiner, options.refinement_passes);
+		};
+		improve(coarsest);
+
+		for (auto level = levels.size() - 1; level-- > 0;) {
+			auto finer = std::vector<part_id>(levels[level].size());
+			for (auto u = std::size_t{0}; u < finer.size(); ++u) {
+				finer[u] = part[maps[level][u]];
+			}
+			part = std::move(finer);
+			improve(levels[level]);
+		}
+
+		for (auto u = std::size_t{0}; u < kept.size(); ++u) {
+			ret.part[kept[u]] = part[u];
+			++ret.sizes[part[u]];
+		}
+		// isolated nodes each go to the smallest part
+		auto smallest = std::priority_queue<std::pair<std::size_t, part_id>,
+		                                    std::vector<std::pair<std::size_t, part_id>>,
+		                                    std::greater<>>();
+		for (auto p = part_id{0}; p < k; ++p) {
+			smallest.emplace(ret.sizes[p], p);
+		}
+		for (auto const u : isolated) {
+			auto const p = smallest.top().second;
+			smallest.pop();
+			ret.part[u] = p;
+			smallest.emplace(++ret.sizes[p], p);
+		}
+		ret.cut = edge_cut(g, ret.part);
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto multilevel_partition(graph<N, E> const& g,
+	                          std::size_t k,
+	                          partition_options const& options = {}) -> partition_result {
+		return multilevel_partition(csr_graph<N, E>(g, csr_layout::outgoing), k, options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_PARTITION_HPP
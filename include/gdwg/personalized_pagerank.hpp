@@ -0,0 +1,389 @@
+#ifndef GDWG_PERSONALIZED_PAGERANK_HPP
+#define GDWG_PERSONALIZED_PAGERANK_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct personalized_pagerank_options {
+		double damping = 0.85;
+		// a node pushes once its residual reaches tolerance times its out degree, so at most
+		// 1 / ((1 - damping) * tolerance) edges are ever looked at
+		double tolerance = 1e-6;
+	};
+
+	// nodes holds every node given a score in ascending id order, rank[i] belonging to nodes[i].
+	// residual is the mass not pushed yet, which is exactly the L1 distance to the true scores.
+	struct personalized_pagerank_result {
+		std::vector<node_id> nodes;
+		std::vector<double> rank;
+		double residual = 0.0;
+		std::size_t pushes = 0;
+	};
+
+	// Scratch space for personalized_pagerank, only the entries a query touches are cleared
+	// afterwards, so repeated queries cost nothing in the size of the graph.
+	class personalized_pagerank_workspace {
+	public:
+		personalized_pagerank_workspace() = default;
+
+		explicit personalized_pagerank_workspace(std::size_t num_nodes) {
+			reserve(num_nodes);
+		}
+
+		auto reserve(std::size_t num_nodes) -> void {
+			if (rank_.size() < num_nodes) {
+				rank_.resize(num_nodes, 0.0);
+				residual_.resize(num_nodes, 0.0);
+				queued_.resize(num_nodes, 0);
+				seen_.resize(num_nodes, 0);
+			}
+		}
+
+		// Andersen, Chung and Lang's forward push from seed. out(u) gives the targets of u's
+		// outgoing edges, parallel edges included, and every node's rank and residual are taken
+		// to start at zero.
+		template<typename Out>
+		auto push(node_id seed, personalized_pagerank_options const& options, Out&& out)
+		   -> std::size_t {
+			auto pushes = std::size_t{0};
+			touch(seed);
+			residual_[seed] = 1.0;
+			queue_.assign(1, seed);
+			queued_[seed] = 1;
+			for (auto head = std::size_t{0}; head < queue_.size(); ++head) {
+				auto const u = queue_[head];
+				queued_[u] = 0;
+				auto const& targets = out(u);
+				auto const degree = static_cast<double>(targets.size());
+				auto const mass = residual_[u];
+				if (mass < options.tolerance * std::max(degree, 1.0)) {
+					continue;
+				}
+				++pushes;
+				rank_[u] += (1.0 - options.damping) * mass;
+				residual_[u] = 0.0;
+				// a dangling node jumps back to the seed, like every other teleport
+				if (targets.empty()) {
+					add(seed,
+					    options.damping * mass,
+					    static_cast<double>(out(seed).size()),
+					    options.tolerance);
+					continue;
+				}
+				auto const share = options.damping * mass / degree;
+				for (auto const v : targets) {
+					add(v, share, static_cast<double>(out(v).size()), options.tolerance);
+				}
+			}
+			return pushes;
+		}
+
+		// writes the touched nodes into result and clears them for the next query
+		auto collect(personalized_pagerank_result& result) -> void {
+			std::sort(touched_.begin(), touched_.end());
+			result.nodes.clear();
+			result.rank.clear();
+			result.residual = 0.0;
+			for (auto const u : touched_) {
+				result.residual += residual_[u];
+				if (rank_[u] != 0.0) {
+					result.nodes.push_back(u);
+					result.rank.push_back(rank_[u]);
+				}
+				rank_[u] = 0.0;
+				residual_[u] = 0.0;
+				seen_[u] = 0;
+			}
+			touched_.clear();
+		}
+
+		// nodes the last query gave a rank or a residual, valid until collect
+		[[nodiscard]] auto touched() const noexcept -> std::vector<node_id> const& {
+			return touched_;
+		}
+
+	private:
+		std::vector<double> rank_;
+		std::vector<double> residual_;
+		std::vector<char> queued_;
+		std::vector<char> seen_;
+		std::vector<node_id> queue_;
+		std::vector<node_id> touched_;
+
+		auto touch(node_id u) -> void {
+			if (seen_[u] == 0) {
+				seen_[u] = 1;
+				touched_.push_back(u);
+			}
+		}
+
+		auto add(node_id v, double mass, double degree, double tolerance) -> void {
+			touch(v);
+			residual_[v] += mass;
+			if (queued_[v] == 0 && residual_[v] >= tolerance * std::max(degree, 1.0)) {
+				queued_[v] = 1;
+				queue_.push_back(v);
+			}
+		}
+	};
+
+	namespace detail {
+		// what is a valid option is the same for a single query and for an index
+		inline auto check_personalized_options(personalized_pagerank_options const& options,
+		                                       std::string const& what) -> void {
+			if (options.damping < 0.0 || options.damping >= 1.0) {
+				throw std::runtime_error(what + " with a damping factor outside [0, 1)");
+			}
+			if (!(options.tolerance > 0.0)) {
+				throw std::runtime_error(what + " with a non-positive tolerance");
+			}
+		}
+
+		// most important first, ties in node order
+		template<typename N>
+		auto sort_scores(std::vector<std::pair<N, double>>& scores) -> void {
+			std::sort(scores.begin(), scores.end(), [](auto const& a, auto const& b) {
+				return a.second > b.second || (a.second == b.second && a.first < b.first);
+			});
+		}
+	} // namespace detail
+
+	// PageRank personalised to a single seed: every teleport, and every step out of a node without
+	// outgoing edges, lands back on the seed. Found by local forward push over the outgoing edges,
+	// so the work depends on the tolerance and not on the size of the graph. Parallel edges count
+	// as separate links, as in pagerank.
+	template<typename N, typename E>
+	auto personalized_pagerank(csr_graph<N, E> const& g,
+	                           node_id seed,
+	                           personalized_pagerank_options const& options,
+	                           personalized_pagerank_workspace& ws,
+	                           personalized_pagerank_result& result) -> void {
+		detail::check_personalized_options(options, "Cannot call gdwg::personalized_pagerank");
+		if (seed >= g.num_nodes()) {
+			throw std::runtime_error("Cannot call gdwg::personalized_pagerank from a seed that "
+			                         "doesn't exist in the graph");
+		}
+		ws.reserve(g.num_nodes());
+		result.pushes = ws.push(seed, options, [&g](node_id u) { return g.out_targets(u); });
+		ws.collect(result);
+	}
+
+	template<typename N, typename E>
+	auto personalized_pagerank(csr_graph<N, E> const& g,
+	                           node_id seed,
+	                           personalized_pagerank_options const& options = {})
+	   -> personalized_pagerank_result {
+		auto ws = personalized_pagerank_workspace(g.num_nodes());
+		auto ret = personalized_pagerank_result{};
+		personalized_pagerank(g, seed, options, ws, ret);
+		return ret;
+	}
+
+	struct personalized_pagerank_index_options {
+		personalized_pagerank_options pagerank = {};
+		// how many seeds keep their scores, least recently used first out
+		std::size_t capacity = 64;
+	};
+
+	// Personalized PageRank over a graph that keeps changing, with the scores of the most
+	// recently asked seeds cached. A cached result depends only on the edges out of the nodes it
+	// touched, so insert_edge and erase_edge drop the results that touched the edge's source and
+	// erase_node those that touched the node or any of its in-neighbours; everything else stays.
+	// The graph must only be modified through this object while it is alive, and queries share
+	// scratch space so an index serves one thread at a time.
+	template<typename N, typename E>
+	class personalized_pagerank_index {
+	public:
+		explicit personalized_pagerank_index(graph<N, E>& g,
+		                                     personalized_pagerank_index_options const& options = {})
+		: graph_{g}
+		, options_{options} {
+			detail::check_personalized_options(options_.pagerank,
+			                                   "Cannot construct gdwg::personalized_pagerank_index");
+			auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+			auto const n = view.num_nodes();
+			values_ = view.nodes();
+			out_.resize(n);
+			in_.resize(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				index_.emplace_hint(index_.end(), values_[u], u);
+				auto const targets = view.out_targets(u);
+				out_[u].assign(targets.begin(), targets.end());
+				for (auto const v : targets) {
+					in_[v].push_back(u);
+				}
+			}
+		}
+
+		// every node with a score and its score, highest first and ties in node order, valid until
+		// the next call on the index
+		[[nodiscard]] auto rank(N const& seed) -> std::vector<std::pair<N, double>> const& {
+			auto const it = index_.find(seed);
+			if (it == index_.end()) {
+				throw std::runtime_error("Cannot call gdwg::personalized_pagerank_index<N, E>::rank "
+				                         "from a seed that doesn't exist in the graph");
+			}
+			auto const s = it->second;
+			auto const cached = std::find_if(cache_.begin(), cache_.end(), [s](entry const& e) {
+				return e.seed == s;
+			});
+			if (cached != cache_.end()) {
+				++hits_;
+				cache_.splice(cache_.begin(), cache_, cached);
+				return cache_.front().scores;
+			}
+			++misses_;
+			ws_.reserve(values_.size());
+			ws_.push(s, options_.pagerank, [this](node_id u) -> std::vector<node_id> const& {
+				return out_[u];
+			});
+			auto e = entry{s, ws_.touched(), {}};
+			std::sort(e.touched.begin(), e.touched.end());
+			ws_.collect(result_);
+			for (auto i = std::size_t{0}; i < result_.nodes.size(); ++i) {
+				e.scores.emplace_back(values_[result_.nodes[i]], result_.rank[i]);
+			}
+			detail::sort_scores(e.scores);
+			if (options_.capacity == 0) {
+				uncached_ = std::move(e.scores);
+				return uncached_;
+			}
+			if (cache_.size() == options_.capacity) {
+				cache_.pop_back();
+			}
+			cache_.push_front(std::move(e));
+			return cache_.front().scores;
+		}
+
+		// a new node has no edges, so no cached result can depend on it
+		auto insert_node(N const& value) -> bool {
+			if (!graph_.insert_node(value)) {
+				return false;
+			}
+			auto u = node_id{0};
+			if (free_.empty()) {
+				u = static_cast<node_id>(values_.size());
+				values_.push_back(value);
+				out_.emplace_back();
+				in_.emplace_back();
+			}
+			else {
+				u = free_.back();
+				free_.pop_back();
+				values_[u] = value;
+			}
+			index_.emplace(value, u);
+			return true;
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (!graph_.insert_edge(src, dst, weight)) {
+				return false;
+			}
+			auto const u = index_.find(src)->second;
+			auto const v = index_.find(dst)->second;
+			auto const by_value = [this](node_id a, node_id b) { return values_[a] < values_[b]; };
+			out_[u].insert(std::upper_bound(out_[u].begin(), out_[u].end(), v, by_value), v);
+			in_[v].push_back(u);
+			invalidate(u);
+			return true;
+		}
+
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (!graph_.erase_edge(src, dst, weight)) {
+				return false;
+			}
+			auto const u = index_.find(src)->second;
+			auto const v = index_.find(dst)->second;
+			unlink(u, v);
+			invalidate(u);
+			return true;
+		}
+
+		auto erase_node(N const& value) -> bool {
+			auto const it = index_.find(value);
+			if (it == index_.end()) {
+				return false;
+			}
+			graph_.erase_node(value);
+			auto const u = it->second;
+			invalidate(u);
+			while (!in_[u].empty()) {
+				auto const from = in_[u].back();
+				invalidate(from);
+				unlink(from, u);
+			}
+			while (!out_[u].empty()) {
+				unlink(u, out_[u].back());
+			}
+			index_.erase(it);
+			free_.push_back(u);
+			return true;
+		}
+
+		// queries answered from the cache and queries that had to push, for tuning
+		[[nodiscard]] auto hits() const noexcept -> std::size_t {
+			return hits_;
+		}
+
+		[[nodiscard]] auto misses() const noexcept -> std::size_t {
+			return misses_;
+		}
+
+		[[nodiscard]] auto underlying() const noexcept -> graph<N, E> const& {
+			return graph_;
+		}
+
+	private:
+		// touched is sorted, the nodes whose edges the scores were computed from
+		struct entry {
+			node_id seed;
+			std::vector<node_id> touched;
+			std::vector<std::pair<N, double>> scores;
+		};
+
+		graph<N, E>& graph_;
+		personalized_pagerank_index_options options_;
+		std::vector<N> values_;
+		std::map<N, node_id> index_;
+		// every edge's target and source, parallel edges included. Targets stay in node order as in
+		// a csr_graph, so pushes happen in the same order and give the very same scores.
+		std::vector<std::vector<node_id>> out_;
+		std::vector<std::vector<node_id>> in_;
+		std::vector<node_id> free_;
+		// most recently used first
+		std::list<entry> cache_;
+		std::vector<std::pair<N, double>> uncached_;
+		std::size_t hits_ = 0;
+		std::size_t misses_ = 0;
+		// scratch space kept between queries
+		personalized_pagerank_workspace ws_;
+		personalized_pagerank_result result_;
+
+		auto invalidate(node_id u) -> void {
+			cache_.remove_if([u](entry const& e) {
+				return std::binary_search(e.touched.begin(), e.touched.end(), u);
+			});
+		}
+
+		// drops one edge from u to v, any of the parallel ones will do
+		auto unlink(node_id u, node_id v) -> void {
+			auto const out = std::find(out_[u].begin(), out_[u].end(), v);
+			out_[u].erase(out);
+			auto const in = std::find(in_[v].begin(), in_[v].end(), u);
+			in_[v].erase(in);
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_PERSONALIZED_PAGERANK_HPP
@@ -0,0 +1,263 @@
+#ifndef GDWG_RANDOM_WALK_HPP
+#define GDWG_RANDOM_WALK_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace gdwg {
+	struct walk_options {
+		// nodes per walk including the first, walks stop early at a node without a way out
+		std::size_t length = 80;
+		std::size_t walks_per_node = 10;
+		// false picks every outgoing edge equally, true in proportion to its weight
+		bool weighted = false;
+		// node2vec's return and in-out parameters, p = q = 1 is a first order walk
+		double p = 1.0;
+		double q = 1.0;
+		std::uint64_t seed = 6771;
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+	};
+
+	namespace detail {
+		// SplitMix64, small enough to reseed for every walk. Each walk draws from its own stream
+		// seeded by (seed, walk), so the walks don't depend on which thread ran them.
+		class walk_rng {
+		public:
+			using result_type = std::uint64_t;
+
+			static constexpr auto min() noexcept -> result_type {
+				return 0;
+			}
+			static constexpr auto max() noexcept -> result_type {
+				return std::numeric_limits<result_type>::max();
+			}
+
+			auto seed(std::uint64_t seed, std::uint64_t stream) noexcept -> void {
+				state_ = seed;
+				state_ = (*this)() ^ (stream * 0xD1B54A32D192ED03ULL);
+			}
+
+			auto operator()() noexcept -> result_type {
+				auto z = (state_ += 0x9E3779B97F4A7C15ULL);
+				z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+				z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+				return z ^ (z >> 31U);
+			}
+
+		private:
+			std::uint64_t state_ = 0;
+		};
+
+		// Vose's alias tables, one per csr row and laid out like the edges: edge k of a row is
+		// kept with probability[k], otherwise the walk takes the row's edge alias[k]. Rows whose
+		// weights add up to 0 can't be left.
+		struct alias_tables {
+			std::vector<double> probability;
+			std::vector<std::uint32_t> alias;
+			std::vector<char> empty;
+
+			template<typename N, typename E>
+			alias_tables(csr_graph<N, E> const& g, thread_pool& pool)
+			: probability(g.num_edges(), 1.0)
+			, alias(g.num_edges(), 0)
+			, empty(g.num_nodes(), 0) {
+				auto small = std::vector<std::vector<std::uint32_t>>(pool.size());
+				auto large = std::vector<std::vector<std::uint32_t>>(pool.size());
+				auto const n = g.num_nodes();
+				pool.parallel_for(n, [&](std::size_t t, std::size_t begin, std::size_t end) {
+					for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+						build(u, g.out_weights(u), g.out_offset(u), small[t], large[t]);
+					}
+				});
+			}
+
+			// the index within u's row of the edge drawn
+			template<typename Rng>
+			[[nodiscard]] auto sample(std::size_t offset, std::size_t degree, Rng& rng) const
+			   -> std::size_t {
+				auto const k = std::uniform_int_distribution<std::size_t>(0, degree - 1)(rng);
+				auto const keep = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+				return keep < probability[offset + k] ? k : alias[offset + k];
+			}
+
+		private:
+			template<typename E>
+			auto build(node_id u,
+			           std::span<E const> weights,
+			           std::size_t offset,
+			           std::vector<std::uint32_t>& small,
+			           std::vector<std::uint32_t>& large) -> void {
+				auto total = 0.0;
+				for (auto const& w : weights) {
+					total += static_cast<double>(w);
+				}
+				if (total <= 0.0) {
+					empty[u] = 1;
+					return;
+				}
+				auto const degree = static_cast<double>(weights.size());
+				small.clear();
+				large.clear();
+				for (auto k = std::uint32_t{0}; k < weights.size(); ++k) {
+					probability[offset + k] = static_cast<double>(weights[k]) * degree / total;
+					(probability[offset + k] < 1.0 ? small : large).push_back(k);
+				}
+				while (!small.empty() && !large.empty()) {
+					auto const s = small.back();
+					small.pop_back();
+					auto const l = large.back();
+					alias[offset + s] = l;
+					probability[offset + l] -= 1.0 - probability[offset + s];
+					if (probability[offset + l] < 1.0) {
+						large.pop_back();
+						small.push_back(l);
+					}
+				}
+				// whatever is left over is 1 up to rounding
+				for (auto const k : small) {
+					probability[offset + k] = 1.0;
+				}
+				for (auto const k : large) {
+					probability[offset + k] = 1.0;
+				}
+			}
+		};
+
+		// Runs every walk and hands it to fn(thread, walk, nodes). Walk w starts at node id
+		// w % n, so walks_per_node rounds each start once from every node. Threads take chunks
+		// of walks from a shared counter and keep one walk in memory at a time.
+		template<typename N, typename E, typename F>
+		auto run_walks(csr_graph<N, E> const& g,
+		               walk_options const& options,
+		               thread_pool& pool,
+		               F&& fn) -> void {
+			static_assert(std::is_arithmetic_v<E>,
+			              "gdwg::random_walks requires arithmetic edge weights");
+			if (!(options.p > 0.0) || !(options.q > 0.0)) {
+				throw std::runtime_error("Cannot call gdwg::random_walks with a non-positive p or q");
+			}
+			auto const negative = [](E const& w) { return w < E{}; };
+			if (options.weighted && std::any_of(g.weights().begin(), g.weights().end(), negative)) {
+				throw std::runtime_error("Cannot call gdwg::random_walks on a graph with negative edge "
+				                         "weights");
+			}
+			auto const n = g.num_nodes();
+			auto const walks = n * options.walks_per_node;
+			if (walks == 0 || options.length == 0) {
+				return;
+			}
+			auto tables = std::optional<alias_tables>();
+			if (options.weighted) {
+				tables.emplace(g, pool);
+			}
+			auto const second_order = options.p != 1.0 || options.q != 1.0;
+			// node2vec by rejection: draw a first order step, keep it with probability bias / upper
+			auto const upper = std::max({1.0 / options.p, 1.0, 1.0 / options.q});
+
+			auto next = std::atomic<std::size_t>(0);
+			auto constexpr chunk = std::size_t{64};
+			pool.parallel_for(pool.size(), [&](std::size_t, std::size_t first, std::size_t last) {
+				for (auto t = first; t < last; ++t) {
+					auto rng = walk_rng();
+					auto walk = std::vector<node_id>();
+					walk.reserve(options.length);
+					auto const step = [&](node_id u) -> std::size_t {
+						auto const degree = g.out_degree(u);
+						if (degree == 0 || (tables && tables->empty[u] != 0)) {
+							return degree;
+						}
+						if (!tables) {
+							return std::uniform_int_distribution<std::size_t>(0, degree - 1)(rng);
+						}
+						return tables->sample(g.out_offset(u), degree, rng);
+					};
+					for (auto begin = next.fetch_add(chunk); begin < walks;
+					     begin = next.fetch_add(chunk)) {
+						for (auto w = begin; w < std::min(begin + chunk, walks); ++w) {
+							rng.seed(options.seed, w);
+							walk.assign(1, static_cast<node_id>(w % n));
+							while (walk.size() < options.length) {
+								auto const u = walk.back();
+								auto k = step(u);
+								if (k == g.out_degree(u)) {
+									break;
+								}
+								auto const targets = g.out_targets(u);
+								while (second_order && walk.size() > 1) {
+									auto const prev = walk[walk.size() - 2];
+									auto const x = targets[k];
+									auto const out = g.out_targets(prev);
+									auto bias = 1.0 / options.q;
+									if (x == prev) {
+										bias = 1.0 / options.p;
+									}
+									else if (std::binary_search(out.begin(), out.end(), x)) {
+										bias = 1.0;
+									}
+									auto accept = std::uniform_real_distribution<double>(0.0, upper);
+									if (accept(rng) < bias) {
+										break;
+									}
+									k = step(u);
+								}
+								walk.push_back(targets[k]);
+							}
+							fn(t, w, std::span<node_id const>(walk));
+						}
+					}
+				}
+			});
+		}
+	} // namespace detail
+
+	// Random walks from every node, walks_per_node of them each, streamed to sink(walk, nodes) as
+	// they finish. Walk w starts at node id w % num_nodes() and only depends on the seed and w, so
+	// the same options give the same walks on any number of threads, though not in the same order.
+	// sink is called from several threads at once and nodes is only valid during the call.
+	template<typename N, typename E, typename Sink>
+	auto random_walks(csr_graph<N, E> const& g, walk_options const& options, Sink&& sink) -> void {
+		auto pool = detail::thread_pool(options.threads);
+		detail::run_walks(g,
+		                  options,
+		                  pool,
+		                  [&sink](std::size_t, std::size_t walk, std::span<node_id const> nodes) {
+			                  sink(walk, nodes);
+		                  });
+	}
+
+	// As above with walks of N, sink(walk, std::span<N const>)
+	template<typename N, typename E, typename Sink>
+	auto random_walks(graph<N, E> const& g, walk_options const& options, Sink&& sink) -> void {
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		auto pool = detail::thread_pool(options.threads);
+		auto buffers = std::vector<std::vector<N>>(pool.size());
+		detail::run_walks(
+		   view,
+		   options,
+		   pool,
+		   [&](std::size_t thread, std::size_t walk, std::span<node_id const> nodes) {
+			   auto& buffer = buffers[thread];
+			   buffer.clear();
+			   for (auto const u : nodes) {
+				   buffer.push_back(view.node(u));
+			   }
+			   sink(walk, std::span<N const>(buffer));
+		   });
+	}
+} // namespace gdwg
+
+#endif // GDWG_RANDOM_WALK_HPP
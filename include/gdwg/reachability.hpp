@@ -0,0 +1,332 @@
+#ifndef GDWG_REACHABILITY_HPP
+#define GDWG_REACHABILITY_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/scc.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace gdwg {
+	struct reachability_options {
+		// interval labels per component, more of them rule out more pairs without a search
+		std::size_t traversals = 3;
+		std::uint64_t seed = 6771;
+	};
+
+	// Answers whether one node reaches another over the condensation of the graph. Every component
+	// carries GRAIL interval labels from a few randomised depth first traversals: if a reaches b
+	// then a's interval contains b's in every traversal, so most unreachable pairs are ruled out
+	// by comparing labels. The first traversal's spanning tree intervals confirm most reachable
+	// pairs, and the rest fall back to a depth first search that skips every component whose
+	// labels already rule it out.
+	//
+	// An insert_edge that leaves the components alone widens the labels of the components that
+	// now reach further, walking up from the edge's source only as far as labels change. Edges
+	// that merge components, and every erase, rebuild the index. The graph must only be modified
+	// through this object while it is alive, and queries share scratch space so an index serves
+	// one thread at a time.
+	template<typename N, typename E>
+	class reachability_index {
+	public:
+		explicit reachability_index(graph<N, E>& g, reachability_options const& options = {})
+		: graph_{g}
+		, options_{options} {
+			options_.traversals = std::max<std::size_t>(1, options_.traversals);
+			rebuild();
+		}
+
+		[[nodiscard]] auto is_reachable(N const& src, N const& dst) const -> bool {
+			auto const from = component_.find(src);
+			auto const to = component_.find(dst);
+			if (from == component_.end() || to == component_.end()) {
+				throw std::runtime_error("Cannot call gdwg::reachability_index<N, E>::is_reachable if "
+				                         "src or dst node don't exist in the graph");
+			}
+			return reaches(from->second, to->second);
+		}
+
+		// a new node is a component of its own with labels nothing else contains yet
+		auto insert_node(N const& value) -> bool {
+			if (!graph_.insert_node(value)) {
+				return false;
+			}
+			auto const c = static_cast<component_id>(out_.size());
+			component_.emplace(value, c);
+			out_.emplace_back();
+			in_.emplace_back();
+			auto const label = next_post_++;
+			for (auto i = std::size_t{0}; i < options_.traversals; ++i) {
+				low_.push_back(label);
+				high_.push_back(label);
+			}
+			post_.push_back(label);
+			tree_low_.push_back(label);
+			visited_.push_back(0);
+			return true;
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (!graph_.insert_edge(src, dst, weight)) {
+				return false;
+			}
+			auto const from = component_.find(src)->second;
+			auto const to = component_.find(dst)->second;
+			if (from == to) {
+				return true;
+			}
+			if (reaches(from, to)) {
+				// nothing reaches further, only the adjacency changes
+				add_edge(from, to);
+				return true;
+			}
+			if (reaches(to, from)) {
+				rebuild();
+				return true;
+			}
+			add_edge(from, to);
+			widen(from, to);
+			return true;
+		}
+
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (!graph_.erase_edge(src, dst, weight)) {
+				return false;
+			}
+			rebuild();
+			return true;
+		}
+
+		auto erase_node(N const& value) -> bool {
+			if (!graph_.erase_node(value)) {
+				return false;
+			}
+			rebuild();
+			return true;
+		}
+
+		[[nodiscard]] auto num_components() const noexcept -> std::size_t {
+			return out_.size();
+		}
+
+		// how many times the index was built from scratch, the constructor included, for tuning
+		[[nodiscard]] auto rebuilds() const noexcept -> std::size_t {
+			return rebuilds_;
+		}
+
+		[[nodiscard]] auto underlying() const noexcept -> graph<N, E> const& {
+			return graph_;
+		}
+
+	private:
+		graph<N, E>& graph_;
+		reachability_options options_;
+		std::map<N, component_id> component_;
+		// edges of the condensation without duplicates
+		std::vector<std::vector<component_id>> out_;
+		std::vector<std::vector<component_id>> in_;
+		// low_/high_[c * traversals + i] is component c's interval in traversal i
+		std::vector<std::uint32_t> low_;
+		std::vector<std::uint32_t> high_;
+		// [tree_low_[c], post_[c]] holds the post order numbers of c's subtree in traversal 0
+		std::vector<std::uint32_t> post_;
+		std::vector<std::uint32_t> tree_low_;
+		std::uint32_t next_post_ = 0;
+		std::size_t rebuilds_ = 0;
+		// scratch space kept between queries
+		mutable std::vector<std::uint32_t> visited_;
+		mutable std::uint32_t epoch_ = 0;
+		mutable std::vector<component_id> stack_;
+
+		// whether a's labels contain b's in every traversal, false means a can't reach b
+		[[nodiscard]] auto may_reach(component_id a, component_id b) const noexcept -> bool {
+			auto const k = options_.traversals;
+			for (auto i = std::size_t{0}; i < k; ++i) {
+				if (low_[a * k + i] > low_[b * k + i] || high_[b * k + i] > high_[a * k + i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// b is in a's subtree of traversal 0, so a reaches b
+		[[nodiscard]] auto tree_reaches(component_id a, component_id b) const noexcept -> bool {
+			return tree_low_[a] <= post_[b] && post_[b] <= post_[a];
+		}
+
+		[[nodiscard]] auto reaches(component_id a, component_id b) const -> bool {
+			if (a == b || tree_reaches(a, b)) {
+				return true;
+			}
+			if (!may_reach(a, b)) {
+				return false;
+			}
+			if (++epoch_ == 0) {
+				std::fill(visited_.begin(), visited_.end(), 0);
+				epoch_ = 1;
+			}
+			stack_.assign(1, a);
+			visited_[a] = epoch_;
+			while (!stack_.empty()) {
+				auto const x = stack_.back();
+				stack_.pop_back();
+				for (auto const y : out_[x]) {
+					if (visited_[y] == epoch_ || !may_reach(y, b)) {
+						continue;
+					}
+					if (y == b || tree_reaches(y, b)) {
+						return true;
+					}
+					visited_[y] = epoch_;
+					stack_.push_back(y);
+				}
+			}
+			return false;
+		}
+
+		auto add_edge(component_id from, component_id to) -> void {
+			if (std::find(out_[from].begin(), out_[from].end(), to) == out_[from].end()) {
+				out_[from].push_back(to);
+				in_[to].push_back(from);
+			}
+		}
+
+		// from now reaches to, so from and everything reaching it must contain to's labels
+		auto widen(component_id from, component_id to) -> void {
+			auto const k = options_.traversals;
+			stack_.assign(1, from);
+			while (!stack_.empty()) {
+				auto const x = stack_.back();
+				stack_.pop_back();
+				auto changed = false;
+				for (auto i = std::size_t{0}; i < k; ++i) {
+					if (low_[to * k + i] < low_[x * k + i]) {
+						low_[x * k + i] = low_[to * k + i];
+						changed = true;
+					}
+					if (high_[to * k + i] > high_[x * k + i]) {
+						high_[x * k + i] = high_[to * k + i];
+						changed = true;
+					}
+				}
+				if (changed) {
+					stack_.insert(stack_.end(), in_[x].begin(), in_[x].end());
+				}
+			}
+		}
+
+		auto rebuild() -> void {
+			++rebuilds_;
+			auto const view = csr_graph<N, E>(graph_, csr_layout::outgoing);
+			auto const sccs = strongly_connected_components(view);
+			auto const count = std::size_t{sccs.count};
+			component_.clear();
+			for (auto u = node_id{0}; u < view.num_nodes(); ++u) {
+				component_.emplace_hint(component_.end(), view.node(u), sccs.component[u]);
+			}
+			out_.assign(count, {});
+			in_.assign(count, {});
+			for (auto u = node_id{0}; u < view.num_nodes(); ++u) {
+				for (auto const v : view.out_targets(u)) {
+					if (sccs.component[u] != sccs.component[v]) {
+						out_[sccs.component[u]].push_back(sccs.component[v]);
+					}
+				}
+			}
+			for (auto c = component_id{0}; c < count; ++c) {
+				std::sort(out_[c].begin(), out_[c].end());
+				out_[c].erase(std::unique(out_[c].begin(), out_[c].end()), out_[c].end());
+				for (auto const d : out_[c]) {
+					in_[d].push_back(c);
+				}
+			}
+			label(count);
+			visited_.assign(count, 0);
+			epoch_ = 0;
+		}
+
+		// Post order numbers every component once per traversal. low is the smallest number
+		// reachable from a component, high its own. Traversals after the first start from the
+		// roots in a shuffled order and try children from a random offset.
+		auto label(std::size_t count) -> void {
+			auto const k = options_.traversals;
+			constexpr auto unset = std::numeric_limits<std::uint32_t>::max();
+			low_.assign(count * k, unset);
+			high_.assign(count * k, 0);
+			post_.assign(count, 0);
+			tree_low_.assign(count, 0);
+			next_post_ = static_cast<std::uint32_t>(count);
+			auto rng = std::mt19937_64(options_.seed);
+			auto roots = std::vector<component_id>(count);
+			for (auto c = component_id{0}; c < count; ++c) {
+				roots[c] = c;
+			}
+			auto seen = std::vector<char>(count);
+			// the component, the child to try next and how many children are left
+			struct frame {
+				component_id node;
+				std::size_t next;
+				std::size_t left;
+			};
+			auto calls = std::vector<frame>();
+			for (auto i = std::size_t{0}; i < k; ++i) {
+				if (i != 0) {
+					std::shuffle(roots.begin(), roots.end(), rng);
+				}
+				std::fill(seen.begin(), seen.end(), 0);
+				auto counter = std::uint32_t{0};
+				auto const enter = [&](component_id c) {
+					seen[c] = 1;
+					if (i == 0) {
+						tree_low_[c] = counter;
+					}
+					auto const degree = out_[c].size();
+					auto const start = i == 0 || degree == 0 ? 0 : rng() % degree;
+					calls.push_back({c, start, degree});
+				};
+				for (auto const root : roots) {
+					if (seen[root] != 0) {
+						continue;
+					}
+					enter(root);
+					while (!calls.empty()) {
+						auto& top = calls.back();
+						auto const x = top.node;
+						if (top.left != 0) {
+							auto const y = out_[x][top.next];
+							top.next = top.next + 1 == out_[x].size() ? 0 : top.next + 1;
+							--top.left;
+							if (seen[y] == 0) {
+								enter(y);
+							}
+							else {
+								low_[x * k + i] = std::min(low_[x * k + i], low_[y * k + i]);
+							}
+							continue;
+						}
+						calls.pop_back();
+						auto const number = counter++;
+						low_[x * k + i] = std::min(low_[x * k + i], number);
+						high_[x * k + i] = number;
+						if (i == 0) {
+							post_[x] = number;
+						}
+						if (!calls.empty()) {
+							auto const parent = calls.back().node;
+							low_[parent * k + i] = std::min(low_[parent * k + i], low_[x * k + i]);
+						}
+					}
+				}
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_REACHABILITY_HPP
@@ -0,0 +1,401 @@
+#ifndef GDWG_REORDER_HPP
+#define GDWG_REORDER_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Node orders that put nodes used together next to each other in memory. Each function returns
+	// order with order[i] the id of the node to place at position i, ready for
+	// csr_graph::reordered, which keeps finding nodes by value so results can still be read back
+	// by N.
+	enum class reorder_method { reverse_cuthill_mckee, hub_sort, gorder };
+
+	struct gorder_options {
+		// how many of the most recently placed nodes a candidate is scored against
+		std::size_t window = 5;
+		// in-neighbours with more outgoing edges than this don't make their targets siblings, 0
+		// picks the square root of the number of nodes
+		std::size_t hub_threshold = 0;
+	};
+
+	namespace detail {
+		// neighbours in either direction without duplicates or self loops, in ascending id order
+		struct symmetric_adjacency {
+			std::vector<std::size_t> offsets;
+			std::vector<node_id> targets;
+
+			[[nodiscard]] auto degree(node_id u) const noexcept -> std::size_t {
+				return offsets[u + 1] - offsets[u];
+			}
+		};
+
+		template<typename N, typename E>
+		auto make_symmetric(csr_graph<N, E> const& g) -> symmetric_adjacency {
+			auto const n = g.num_nodes();
+			auto ret = symmetric_adjacency{std::vector<std::size_t>(n + 1, 0), {}};
+			auto const sources = g.edge_sources();
+			auto const targets = g.targets();
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				if (sources[k] != targets[k]) {
+					++ret.offsets[sources[k] + 1];
+					++ret.offsets[targets[k] + 1];
+				}
+			}
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				ret.offsets[u + 1] += ret.offsets[u];
+			}
+			ret.targets.resize(ret.offsets[n]);
+			auto next = std::vector<std::size_t>(ret.offsets.begin(), ret.offsets.end() - 1);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				if (sources[k] != targets[k]) {
+					ret.targets[next[sources[k]]++] = targets[k];
+					ret.targets[next[targets[k]]++] = sources[k];
+				}
+			}
+			// squeeze out the duplicates row by row
+			auto write = std::size_t{0};
+			auto begin = std::size_t{0};
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				auto const end = ret.offsets[u + 1];
+				auto const first = ret.targets.begin() + static_cast<std::ptrdiff_t>(begin);
+				auto const last = ret.targets.begin() + static_cast<std::ptrdiff_t>(end);
+				std::sort(first, last);
+				auto const unique = std::unique(first, last);
+				auto const out = ret.targets.begin() + static_cast<std::ptrdiff_t>(write);
+				write += static_cast<std::size_t>(std::move(first, unique, out) - out);
+				begin = end;
+				ret.offsets[u + 1] = write;
+			}
+			ret.targets.resize(write);
+			return ret;
+		}
+
+		// nodes reached from start level by level, and the last level's first node of least degree
+		inline auto bfs_levels(symmetric_adjacency const& adj,
+		                       node_id start,
+		                       std::vector<std::uint32_t>& mark,
+		                       std::uint32_t epoch,
+		                       std::vector<node_id>& queue) -> std::pair<std::size_t, node_id> {
+			queue.assign(1, start);
+			mark[start] = epoch;
+			auto levels = std::size_t{0};
+			auto level_begin = std::size_t{0};
+			auto far = start;
+			while (level_begin < queue.size()) {
+				auto const level_end = queue.size();
+				far = queue[level_begin];
+				for (auto i = level_begin; i < level_end; ++i) {
+					auto const u = queue[i];
+					if (adj.degree(u) < adj.degree(far)) {
+						far = u;
+					}
+					for (auto k = adj.offsets[u]; k < adj.offsets[u + 1]; ++k) {
+						auto const v = adj.targets[k];
+						if (mark[v] != epoch) {
+							mark[v] = epoch;
+							queue.push_back(v);
+						}
+					}
+				}
+				++levels;
+				level_begin = level_end;
+			}
+			return {levels, far};
+		}
+	} // namespace detail
+
+	// Reverse Cuthill-McKee over the edges taken in both directions. Each component starts from a
+	// pseudo-peripheral node found by George and Liu's repeated breadth first searches, takes
+	// neighbours in ascending degree, and the whole order is reversed at the end. Keeps the ids
+	// of neighbouring nodes close together, which bounds the bandwidth of the adjacency matrix.
+	template<typename N, typename E>
+	auto reverse_cuthill_mckee(csr_graph<N, E> const& g) -> std::vector<node_id> {
+		auto const n = g.num_nodes();
+		auto const adj = detail::make_symmetric(g);
+		auto by_degree = std::vector<node_id>(n);
+		std::iota(by_degree.begin(), by_degree.end(), node_id{0});
+		std::stable_sort(by_degree.begin(), by_degree.end(), [&adj](node_id lhs, node_id rhs) {
+			return adj.degree(lhs) < adj.degree(rhs);
+		});
+
+		auto ret = std::vector<node_id>();
+		ret.reserve(n);
+		auto placed = std::vector<char>(n, 0);
+		auto mark = std::vector<std::uint32_t>(n, 0);
+		auto epoch = std::uint32_t{0};
+		auto queue = std::vector<node_id>();
+		auto neighbours = std::vector<node_id>();
+		for (auto const root : by_degree) {
+			if (placed[root] != 0) {
+				continue;
+			}
+			// move to the far end of the component while that makes it deeper
+			auto start = root;
+			auto [depth, far] = detail::bfs_levels(adj, start, mark, ++epoch, queue);
+			while (far != start) {
+				auto const [next_depth, next_far] = detail::bfs_levels(adj, far, mark, ++epoch, queue);
+				if (next_depth <= depth) {
+					break;
+				}
+				start = far;
+				depth = next_depth;
+				far = next_far;
+			}
+
+			auto head = ret.size();
+			ret.push_back(start);
+			placed[start] = 1;
+			for (; head < ret.size(); ++head) {
+				auto const u = ret[head];
+				neighbours.clear();
+				for (auto k = adj.offsets[u]; k < adj.offsets[u + 1]; ++k) {
+					auto const v = adj.targets[k];
+					if (placed[v] == 0) {
+						placed[v] = 1;
+						neighbours.push_back(v);
+					}
+				}
+				std::stable_sort(neighbours.begin(),
+				                 neighbours.end(),
+				                 [&adj](node_id lhs, node_id rhs) {
+					                 return adj.degree(lhs) < adj.degree(rhs);
+				                 });
+				ret.insert(ret.end(), neighbours.begin(), neighbours.end());
+			}
+		}
+		std::reverse(ret.begin(), ret.end());
+		return ret;
+	}
+
+	// Hub sorting: nodes with more than the average number of edges in and out come first, most
+	// edges first, and every other node keeps its place relative to the rest. The hubs that most
+	// edges lead to end up sharing cache lines while the cheap pass leaves any locality the
+	// original order had among the rest.
+	template<typename N, typename E>
+	auto hub_sort(csr_graph<N, E> const& g) -> std::vector<node_id> {
+		auto const n = g.num_nodes();
+		auto degree = std::vector<std::size_t>(n, 0);
+		for (auto u = node_id{0}; u < n; ++u) {
+			degree[u] += g.out_degree(u);
+		}
+		for (auto const v : g.targets()) {
+			++degree[v];
+		}
+		auto const average = n == 0 ? 0.0 : 2.0 * static_cast<double>(g.num_edges())
+		                                        / static_cast<double>(n);
+		auto ret = std::vector<node_id>();
+		ret.reserve(n);
+		for (auto u = node_id{0}; u < n; ++u) {
+			if (static_cast<double>(degree[u]) > average) {
+				ret.push_back(u);
+			}
+		}
+		std::stable_sort(ret.begin(), ret.end(), [&degree](node_id lhs, node_id rhs) {
+			return degree[lhs] > degree[rhs];
+		});
+		for (auto u = node_id{0}; u < n; ++u) {
+			if (static_cast<double>(degree[u]) <= average) {
+				ret.push_back(u);
+			}
+		}
+		return ret;
+	}
+
+	namespace detail {
+		// Keys that only ever change by one, kept in buckets of doubly linked lists so every
+		// change and finding the largest key take constant time, amortised over the removals.
+		class unit_heap {
+		public:
+			explicit unit_heap(std::size_t count)
+			: key_(count, 0)
+			, next_(count)
+			, prev_(count)
+			, head_(1, none)
+			, removed_(count, 0) {
+				for (auto u = std::size_t{0}; u < count; ++u) {
+					link(static_cast<node_id>(u));
+				}
+			}
+
+			[[nodiscard]] auto contains(node_id u) const noexcept -> bool {
+				return removed_[u] == 0;
+			}
+
+			auto increment(node_id u) -> void {
+				unlink(u);
+				++key_[u];
+				if (key_[u] == head_.size()) {
+					head_.push_back(none);
+				}
+				link(u);
+				top_ = std::max(top_, key_[u]);
+			}
+
+			auto decrement(node_id u) -> void {
+				unlink(u);
+				--key_[u];
+				link(u);
+			}
+
+			auto remove(node_id u) -> void {
+				unlink(u);
+				removed_[u] = 1;
+			}
+
+			// a node with the largest key, the one linked most recently on ties
+			[[nodiscard]] auto top() -> node_id {
+				while (head_[top_] == none) {
+					--top_;
+				}
+				return head_[top_];
+			}
+
+		private:
+			static constexpr auto none = std::numeric_limits<node_id>::max();
+			std::vector<std::size_t> key_;
+			std::vector<node_id> next_;
+			std::vector<node_id> prev_;
+			std::vector<node_id> head_;
+			std::vector<char> removed_;
+			std::size_t top_ = 0;
+
+			auto link(node_id u) -> void {
+				auto& head = head_[key_[u]];
+				prev_[u] = none;
+				next_[u] = head;
+				if (head != none) {
+					prev_[head] = u;
+				}
+				head = u;
+			}
+
+			auto unlink(node_id u) -> void {
+				if (prev_[u] == none) {
+					head_[key_[u]] = next_[u];
+				}
+				else {
+					next_[prev_[u]] = next_[u];
+				}
+				if (next_[u] != none) {
+					prev_[next_[u]] = prev_[u];
+				}
+			}
+		};
+	} // namespace detail
+
+	// Wei, Yu, Lu and Lin's Gorder: nodes are placed one at a time, each time taking the node with
+	// the highest score against the last window placed, where a pair scores one for every edge
+	// between them and one for every in-neighbour they share. Starts from the node with the most
+	// incoming edges and takes any node left when nothing scores. In-neighbours with too many
+	// targets are skipped when counting siblings, as the full count costs the square of a hub's
+	// degree.
+	template<typename N, typename E>
+	auto gorder(csr_graph<N, E> const& g, gorder_options const& options = {})
+	   -> std::vector<node_id> {
+		auto const n = g.num_nodes();
+		auto ret = std::vector<node_id>();
+		if (n == 0) {
+			return ret;
+		}
+		ret.reserve(n);
+		auto const window = std::max<std::size_t>(1, options.window);
+		auto const threshold =
+		   options.hub_threshold != 0
+		      ? options.hub_threshold
+		      : static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+		// incoming edges from the outgoing ones, g may not have them
+		auto in_offsets = std::vector<std::size_t>(n + 1, 0);
+		for (auto const v : g.targets()) {
+			++in_offsets[v + 1];
+		}
+		for (auto v = std::size_t{0}; v < n; ++v) {
+			in_offsets[v + 1] += in_offsets[v];
+		}
+		auto in_sources = std::vector<node_id>(g.num_edges());
+		auto next = std::vector<std::size_t>(in_offsets.begin(), in_offsets.end() - 1);
+		for (auto u = node_id{0}; u < n; ++u) {
+			for (auto const v : g.out_targets(u)) {
+				in_sources[next[v]++] = u;
+			}
+		}
+
+		auto heap = detail::unit_heap(n);
+		// the score of every node left changes by step as u enters or leaves the window
+		auto const update = [&](node_id u, bool entering) {
+			auto const change = [&](node_id v) {
+				if (v != u && heap.contains(v)) {
+					if (entering) {
+						heap.increment(v);
+					}
+					else {
+						heap.decrement(v);
+					}
+				}
+			};
+			for (auto const v : g.out_targets(u)) {
+				change(v);
+			}
+			for (auto k = in_offsets[u]; k < in_offsets[u + 1]; ++k) {
+				auto const w = in_sources[k];
+				change(w);
+				if (g.out_degree(w) <= threshold) {
+					for (auto const v : g.out_targets(w)) {
+						change(v);
+					}
+				}
+			}
+		};
+
+		auto first = node_id{0};
+		for (auto v = node_id{1}; v < n; ++v) {
+			if (in_offsets[v + 1] - in_offsets[v] > in_offsets[first + 1] - in_offsets[first]) {
+				first = v;
+			}
+		}
+		auto u = first;
+		while (true) {
+			heap.remove(u);
+			ret.push_back(u);
+			if (ret.size() == n) {
+				break;
+			}
+			update(u, true);
+			if (ret.size() > window) {
+				update(ret[ret.size() - window - 1], false);
+			}
+			u = heap.top();
+		}
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto reorder(csr_graph<N, E> const& g, reorder_method method) -> csr_graph<N, E> {
+		switch (method) {
+		case reorder_method::reverse_cuthill_mckee: return g.reordered(reverse_cuthill_mckee(g));
+		case reorder_method::hub_sort: return g.reordered(hub_sort(g));
+		case reorder_method::gorder: return g.reordered(gorder(g));
+		}
+		throw std::runtime_error("Cannot call gdwg::reorder with an unknown method");
+	}
+
+	// A snapshot of g in the given order
+	template<typename N, typename E>
+	auto reorder(graph<N, E> const& g,
+	             reorder_method method,
+	             csr_layout layout = csr_layout::both) -> csr_graph<N, E> {
+		return reorder(csr_graph<N, E>(g, layout), method);
+	}
+} // namespace gdwg
+
+#endif // GDWG_REORDER_HPP
@@ -0,0 +1,137 @@
+#ifndef GDWG_SCC_HPP
+#define GDWG_SCC_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	using component_id = std::uint32_t;
+
+	// component[u] is the strongly connected component of node id u (equivalently of the u-th node
+	// of graph::nodes()). Ids follow a topological order of the condensation, so every edge between
+	// two components goes from a lower id to a higher one.
+	struct scc_result {
+		std::vector<component_id> component;
+		component_id count = 0;
+	};
+
+	// Tarjan's algorithm with an explicit call stack, so a long chain of nodes can't overflow the
+	// thread's stack. Besides the result it only allocates the index/lowlink arrays and the two
+	// stacks, O(n + e) time.
+	template<typename N, typename E>
+	auto strongly_connected_components(csr_graph<N, E> const& g) -> scc_result {
+		auto constexpr unassigned = std::numeric_limits<component_id>::max();
+		auto const n = g.num_nodes();
+		auto ret = scc_result{std::vector<component_id>(n, unassigned), 0};
+		// index 0 means not visited yet
+		auto index = std::vector<std::uint32_t>(n, 0);
+		auto low = std::vector<std::uint32_t>(n, 0);
+		auto stack = std::vector<node_id>();
+		// frames of the simulated recursion, the node and the next outgoing edge to look at
+		auto calls = std::vector<std::pair<node_id, std::size_t>>();
+		auto next_index = std::uint32_t{1};
+		auto const offsets = g.out_offsets();
+		auto const targets = g.targets();
+
+		auto const visit = [&](node_id u) {
+			index[u] = low[u] = next_index++;
+			stack.push_back(u);
+			calls.emplace_back(u, offsets[u]);
+		};
+
+		for (auto root = node_id{0}; root < n; ++root) {
+			if (index[root] != 0) {
+				continue;
+			}
+			visit(root);
+			while (!calls.empty()) {
+				auto const u = calls.back().first;
+				auto const k = calls.back().second;
+				if (k < offsets[u + 1]) {
+					++calls.back().second;
+					auto const v = targets[k];
+					if (index[v] == 0) {
+						visit(v);
+					}
+					else if (ret.component[v] == unassigned) {
+						low[u] = std::min(low[u], index[v]);
+					}
+					continue;
+				}
+				calls.pop_back();
+				if (low[u] == index[u]) {
+					auto v = u;
+					do {
+						v = stack.back();
+						stack.pop_back();
+						ret.component[v] = ret.count;
+					} while (v != u);
+					++ret.count;
+				}
+				if (!calls.empty()) {
+					auto const parent = calls.back().first;
+					low[parent] = std::min(low[parent], low[u]);
+				}
+			}
+		}
+
+		// tarjan finishes sink components first, flip so ids run in topological order
+		for (auto& c : ret.component) {
+			c = ret.count - 1 - c;
+		}
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto strongly_connected_components(graph<N, E> const& g) -> scc_result {
+		return strongly_connected_components(csr_graph<N, E>(g, csr_layout::outgoing));
+	}
+
+	// The condensation as a new graph with one node per component. Every edge between two
+	// different components is kept with its weight (identical ones collapse as usual), edges
+	// inside a component are dropped. The result is a DAG.
+	template<typename N, typename E>
+	auto condense(csr_graph<N, E> const& g, scc_result const& sccs) -> graph<component_id, E> {
+		using value_type = typename graph<component_id, E>::value_type;
+		auto edges = std::vector<value_type>();
+		for (auto u = node_id{0}; u < g.num_nodes(); ++u) {
+			auto const targets = g.out_targets(u);
+			auto const weights = g.out_weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				auto const from = sccs.component[u];
+				auto const to = sccs.component[targets[k]];
+				if (from != to) {
+					edges.push_back({from, to, weights[k]});
+				}
+			}
+		}
+		// sorted input lets insert_edges append instead of searching
+		std::sort(edges.begin(), edges.end(), [](value_type const& lhs, value_type const& rhs) {
+			return std::tie(lhs.from, lhs.to, lhs.weight) < std::tie(rhs.from, rhs.to, rhs.weight);
+		});
+
+		auto ids = std::vector<component_id>(sccs.count);
+		for (auto c = component_id{0}; c < sccs.count; ++c) {
+			ids[c] = c;
+		}
+		auto ret = graph<component_id, E>(ids.begin(), ids.end());
+		ret.insert_edges(edges.begin(), edges.end());
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto condense(graph<N, E> const& g) -> graph<component_id, E> {
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		return condense(view, strongly_connected_components(view));
+	}
+} // namespace gdwg
+
+#endif // GDWG_SCC_HPP
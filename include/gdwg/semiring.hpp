@@ -0,0 +1,418 @@
+#ifndef GDWG_SEMIRING_HPP
+#define GDWG_SEMIRING_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Semirings for the kernels below. add is the reduction over a row and multiply combines a
+	// vector entry with an edge, zero() is the identity of add and absorbs under multiply, so it
+	// stands for an entry that isn't there. edge(w) turns an edge weight into a matrix entry.
+
+	// shortest distances, multiply saturates at zero() so unreached entries stay unreached
+	template<typename T>
+	struct min_plus {
+		using value_type = T;
+		static constexpr auto zero() noexcept -> T {
+			if constexpr (std::numeric_limits<T>::has_infinity) {
+				return std::numeric_limits<T>::infinity();
+			}
+			else {
+				return std::numeric_limits<T>::max();
+			}
+		}
+		static constexpr auto one() noexcept -> T {
+			return T{};
+		}
+		static constexpr auto add(T a, T b) noexcept -> T {
+			return b < a ? b : a;
+		}
+		static constexpr auto multiply(T a, T b) noexcept -> T {
+			if constexpr (std::numeric_limits<T>::has_infinity) {
+				return a + b;
+			}
+			else {
+				return a == zero() || b == zero() ? zero() : a + b;
+			}
+		}
+		template<typename E>
+		static constexpr auto edge(E const& weight) noexcept -> T {
+			return static_cast<T>(weight);
+		}
+	};
+
+	// the usual arithmetic, for PageRank style propagation
+	template<typename T>
+	struct plus_times {
+		using value_type = T;
+		static constexpr auto zero() noexcept -> T {
+			return T{0};
+		}
+		static constexpr auto one() noexcept -> T {
+			return T{1};
+		}
+		static constexpr auto add(T a, T b) noexcept -> T {
+			return a + b;
+		}
+		static constexpr auto multiply(T a, T b) noexcept -> T {
+			return a * b;
+		}
+		template<typename E>
+		static constexpr auto edge(E const& weight) noexcept -> T {
+			return static_cast<T>(weight);
+		}
+	};
+
+	// widest (bottleneck) paths
+	template<typename T>
+	struct max_min {
+		using value_type = T;
+		static constexpr auto zero() noexcept -> T {
+			if constexpr (std::numeric_limits<T>::has_infinity) {
+				return -std::numeric_limits<T>::infinity();
+			}
+			else {
+				return std::numeric_limits<T>::lowest();
+			}
+		}
+		static constexpr auto one() noexcept -> T {
+			if constexpr (std::numeric_limits<T>::has_infinity) {
+				return std::numeric_limits<T>::infinity();
+			}
+			else {
+				return std::numeric_limits<T>::max();
+			}
+		}
+		static constexpr auto add(T a, T b) noexcept -> T {
+			return a < b ? b : a;
+		}
+		static constexpr auto multiply(T a, T b) noexcept -> T {
+			return b < a ? b : a;
+		}
+		template<typename E>
+		static constexpr auto edge(E const& weight) noexcept -> T {
+			return static_cast<T>(weight);
+		}
+	};
+
+	// reachability, every edge is a 1 whatever its weight. Bytes rather than bool so that no two
+	// threads ever share the word an entry lives in.
+	struct or_and {
+		using value_type = std::uint8_t;
+		static constexpr auto zero() noexcept -> value_type {
+			return 0;
+		}
+		static constexpr auto one() noexcept -> value_type {
+			return 1;
+		}
+		static constexpr auto add(value_type a, value_type b) noexcept -> value_type {
+			return static_cast<value_type>(a | b);
+		}
+		static constexpr auto multiply(value_type a, value_type b) noexcept -> value_type {
+			return static_cast<value_type>(a & b);
+		}
+		template<typename E>
+		static constexpr auto edge(E const&) noexcept -> value_type {
+			return 1;
+		}
+	};
+
+	// entry values[i] sits at node id indices[i], every other entry is the semiring's zero()
+	template<typename T>
+	struct sparse_vector {
+		std::vector<node_id> indices;
+		std::vector<T> values;
+	};
+
+	namespace detail {
+		// Splits [0, count) into slices of roughly equal work, where prefix(i) is the work of
+		// everything before i and prefix(count) the total
+		template<typename Prefix>
+		auto balanced_slices(std::size_t count, std::size_t slices, Prefix const& prefix)
+		   -> std::vector<std::size_t> {
+			auto ret = std::vector<std::size_t>(slices + 1, count);
+			ret[0] = 0;
+			auto const total = prefix(count);
+			for (auto t = std::size_t{1}; t < slices; ++t) {
+				auto const target = total * t / slices;
+				// first i whose prefix reaches target
+				auto low = ret[t - 1];
+				auto high = count;
+				while (low < high) {
+					auto const mid = low + (high - low) / 2;
+					if (prefix(mid) < target) {
+						low = mid + 1;
+					}
+					else {
+						high = mid;
+					}
+				}
+				ret[t] = low;
+			}
+			return ret;
+		}
+	} // namespace detail
+
+	// Threads and scratch space for the kernels below, kept between calls so an iterative
+	// algorithm starts its threads once. A workspace serves one call at a time.
+	template<typename T>
+	class spmv_workspace {
+	public:
+		using product_list = std::vector<std::pair<node_id, T>>;
+
+		explicit spmv_workspace(std::size_t threads = 0)
+		: pool_{std::make_unique<detail::thread_pool>(threads)}
+		, pairs_(pool_->size(), std::vector<product_list>(pool_->size()))
+		, parts_(pool_->size()) {}
+
+		[[nodiscard]] auto threads() const noexcept -> std::size_t {
+			return pool_->size();
+		}
+
+		// internal to the kernels
+		[[nodiscard]] auto pool() noexcept -> detail::thread_pool& {
+			return *pool_;
+		}
+		auto reserve(std::size_t num_nodes) -> void {
+			if (seen_.size() < num_nodes) {
+				seen_.resize(num_nodes, 0);
+				accumulator_.resize(num_nodes);
+			}
+		}
+		[[nodiscard]] auto seen() noexcept -> std::vector<char>& {
+			return seen_;
+		}
+		[[nodiscard]] auto accumulator() noexcept -> std::vector<T>& {
+			return accumulator_;
+		}
+		// pairs()[thread][bucket] are the products a thread made for a bucket of node ids
+		[[nodiscard]] auto pairs() noexcept -> std::vector<std::vector<product_list>>& {
+			return pairs_;
+		}
+		[[nodiscard]] auto parts() noexcept -> std::vector<sparse_vector<T>>& {
+			return parts_;
+		}
+
+	private:
+		std::unique_ptr<detail::thread_pool> pool_;
+		std::vector<char> seen_;
+		std::vector<T> accumulator_;
+		std::vector<std::vector<product_list>> pairs_;
+		std::vector<sparse_vector<T>> parts_;
+	};
+
+	namespace detail {
+		// y[i] = add over row i of multiply(x[column], edge(weight)), optionally folded into y[i].
+		// Threads take slices of rows with roughly equal numbers of entries and each row is one
+		// contiguous reduction, which the compiler can vectorise for the simple semirings.
+		template<typename S, typename E>
+		auto row_kernel(std::span<std::size_t const> offsets,
+		                std::span<node_id const> columns,
+		                std::span<E const> weights,
+		                std::span<typename S::value_type const> x,
+		                std::span<typename S::value_type> y,
+		                bool accumulate,
+		                thread_pool& pool) -> void {
+			auto const rows = offsets.size() - 1;
+			auto const slices = balanced_slices(rows, pool.size(), [&](std::size_t i) {
+				return offsets[i];
+			});
+			pool.parallel_for(pool.size(), [&](std::size_t, std::size_t first, std::size_t last) {
+				for (auto t = first; t < last; ++t) {
+					for (auto i = slices[t]; i < slices[t + 1]; ++i) {
+						auto sum = S::zero();
+						for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+							sum = S::add(sum, S::multiply(x[columns[k]], S::edge(weights[k])));
+						}
+						y[i] = accumulate ? S::add(y[i], sum) : sum;
+					}
+				}
+			});
+		}
+
+		template<typename N, typename E>
+		auto check_dense(csr_graph<N, E> const& a, std::size_t x, std::size_t y, char const* message)
+		   -> void {
+			if (x != a.num_nodes() || y != a.num_nodes()) {
+				throw std::runtime_error(message);
+			}
+		}
+	} // namespace detail
+
+	// A csr_graph is the graph's adjacency matrix A in compressed form: the outgoing arrays are its
+	// CSR rows (A[u][v] is the edge u -> v) and the incoming arrays, with csr_layout::both, its CSC
+	// columns. Parallel edges are separate entries that add() folds together. x and y must not
+	// overlap.
+
+	// y = A x, y[u] = add over edges u -> v of multiply(x[v], edge(weight)), a pull over outgoing
+	// edges. With accumulate, y[u] = add(y[u], (A x)[u]).
+	template<typename S, typename N, typename E>
+	auto mxv(csr_graph<N, E> const& a,
+	         std::span<typename S::value_type const> x,
+	         std::span<typename S::value_type> y,
+	         spmv_workspace<typename S::value_type>& ws,
+	         bool accumulate = false) -> void {
+		detail::check_dense(a,
+		                    x.size(),
+		                    y.size(),
+		                    "Cannot call gdwg::mxv with vectors whose size doesn't match the graph");
+		detail::row_kernel<S>(a.out_offsets(), a.targets(), a.weights(), x, y, accumulate, ws.pool());
+	}
+
+	// y = x A, y[v] = add over edges u -> v of multiply(x[u], edge(weight)), a pull over incoming
+	// edges so it needs csr_layout::both. With accumulate, y[v] = add(y[v], (x A)[v]).
+	template<typename S, typename N, typename E>
+	auto vxm(csr_graph<N, E> const& a,
+	         std::span<typename S::value_type const> x,
+	         std::span<typename S::value_type> y,
+	         spmv_workspace<typename S::value_type>& ws,
+	         bool accumulate = false) -> void {
+		if (!a.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::vxm on a csr_graph built without incoming "
+			                         "edges");
+		}
+		detail::check_dense(a,
+		                    x.size(),
+		                    y.size(),
+		                    "Cannot call gdwg::vxm with vectors whose size doesn't match the graph");
+		detail::row_kernel<S>(a.in_offsets(),
+		                      a.sources(),
+		                      a.incoming_weights(),
+		                      x,
+		                      y,
+		                      accumulate,
+		                      ws.pool());
+	}
+
+	// Sparse x A: pushes every entry of x along its node's outgoing edges, so the work is the
+	// number of edges leaving x rather than the size of the graph, as in a frontier expansion.
+	// Entries whose node has mask[v] set are left out of the result (a complemented mask, such as
+	// the visited set of a breadth first search), and an empty mask leaves nothing out. The result
+	// is in ascending node order. Threads take slices of x with roughly equal numbers of edges
+	// and hand their products to the thread that owns the destination's range of node ids, which
+	// reduces them in the order of x, so the result is the same on any number of threads.
+	template<typename S, typename N, typename E>
+	auto vxm(csr_graph<N, E> const& a,
+	         sparse_vector<typename S::value_type> const& x,
+	         spmv_workspace<typename S::value_type>& ws,
+	         std::span<char const> mask = {}) -> sparse_vector<typename S::value_type> {
+		using T = typename S::value_type;
+		auto const n = a.num_nodes();
+		if (x.indices.size() != x.values.size()
+		    || std::any_of(x.indices.begin(), x.indices.end(), [n](node_id u) { return u >= n; }))
+		{
+			throw std::runtime_error("Cannot call gdwg::vxm with a sparse_vector that doesn't fit "
+			                         "the graph");
+		}
+		if (!mask.empty() && mask.size() != n) {
+			throw std::runtime_error("Cannot call gdwg::vxm with a mask whose size doesn't match "
+			                         "the graph");
+		}
+		ws.reserve(n);
+		auto& seen = ws.seen();
+		auto& accumulator = ws.accumulator();
+		auto const offsets = a.out_offsets();
+		auto const targets = a.targets();
+		auto const weights = a.weights();
+		auto const skip = [&](node_id v) { return !mask.empty() && mask[v] != 0; };
+		// folds every product for a range of node ids into out, in ascending order
+		auto const reduce = [&](auto&& for_each_product, sparse_vector<T>& out) {
+			out.indices.clear();
+			out.values.clear();
+			for_each_product([&](node_id v, T const& product) {
+				if (seen[v] == 0) {
+					seen[v] = 1;
+					accumulator[v] = product;
+					out.indices.push_back(v);
+				}
+				else {
+					accumulator[v] = S::add(accumulator[v], product);
+				}
+			});
+			std::sort(out.indices.begin(), out.indices.end());
+			out.values.reserve(out.indices.size());
+			for (auto const v : out.indices) {
+				out.values.push_back(accumulator[v]);
+				seen[v] = 0;
+			}
+		};
+		auto const push = [&](std::size_t i, auto&& emit) {
+			auto const u = x.indices[i];
+			for (auto k = offsets[u]; k < offsets[u + 1]; ++k) {
+				if (!skip(targets[k])) {
+					emit(targets[k], S::multiply(x.values[i], S::edge(weights[k])));
+				}
+			}
+		};
+
+		auto const threads = ws.threads();
+		auto edges = std::vector<std::size_t>(x.indices.size() + 1, 0);
+		for (auto i = std::size_t{0}; i < x.indices.size(); ++i) {
+			edges[i + 1] = edges[i] + a.out_degree(x.indices[i]);
+		}
+		// below this many edges starting threads costs more than it saves
+		constexpr auto parallel_threshold = std::size_t{1} << 14;
+		auto ret = sparse_vector<T>{};
+		if (threads == 1 || edges.back() < parallel_threshold) {
+			reduce(
+			   [&](auto&& emit) {
+				   for (auto i = std::size_t{0}; i < x.indices.size(); ++i) {
+					   push(i, emit);
+				   }
+			   },
+			   ret);
+			return ret;
+		}
+
+		auto const slices = detail::balanced_slices(x.indices.size(), threads, [&](std::size_t i) {
+			return edges[i];
+		});
+		auto const bucket = [&](node_id v) {
+			return static_cast<std::size_t>(std::uint64_t{v} * threads / n);
+		};
+		auto& pairs = ws.pairs();
+		auto& parts = ws.parts();
+		ws.pool().parallel_for(threads, [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto t = first; t < last; ++t) {
+				for (auto& out : pairs[t]) {
+					out.clear();
+				}
+				for (auto i = slices[t]; i < slices[t + 1]; ++i) {
+					push(i, [&](node_id v, T const& product) {
+						pairs[t][bucket(v)].emplace_back(v, product);
+					});
+				}
+			}
+		});
+		ws.pool().parallel_for(threads, [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto b = first; b < last; ++b) {
+				reduce(
+				   [&](auto&& emit) {
+					   for (auto t = std::size_t{0}; t < threads; ++t) {
+						   for (auto const& [v, product] : pairs[t][b]) {
+							   emit(v, product);
+						   }
+					   }
+				   },
+				   parts[b]);
+			}
+		});
+		for (auto const& part : parts) {
+			ret.indices.insert(ret.indices.end(), part.indices.begin(), part.indices.end());
+			ret.values.insert(ret.values.end(), part.values.begin(), part.values.end());
+		}
+		return ret;
+	}
+} // namespace gdwg
+
+#endif // GDWG_SEMIRING_HPP
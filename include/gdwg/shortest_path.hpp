@@ -0,0 +1,398 @@
+#ifndef GDWG_SHORTEST_PATH_HPP
+#define GDWG_SHORTEST_PATH_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// counters from a single query, useful when tuning heuristics
+	struct search_stats {
+		// nodes taken off the heap and expanded
+		std::size_t settled = 0;
+		// edges looked at while expanding
+		std::size_t relaxed = 0;
+		// heap insertions, including the ones that later turn out stale
+		std::size_t pushed = 0;
+	};
+
+	// result of a query over a csr_graph, the path itself stays in the workspace
+	template<typename E>
+	struct search_result {
+		bool found = false;
+		E distance = E{};
+		search_stats stats;
+	};
+
+	// result of a query over a graph, with the path spelled out as node values from src to dst
+	template<typename N, typename E>
+	struct path_result {
+		bool found = false;
+		E distance = E{};
+		std::vector<N> nodes;
+		search_stats stats;
+	};
+
+	namespace detail {
+		template<typename E>
+		struct heap_entry {
+			// priority, the distance plus whatever the search adds on top of it
+			E key;
+			E dist;
+			node_id node;
+		};
+
+		template<typename E>
+		struct heap_greater {
+			auto operator()(heap_entry<E> const& lhs, heap_entry<E> const& rhs) const noexcept
+			   -> bool {
+				return lhs.key > rhs.key;
+			}
+		};
+
+		// One direction of a search. A label is only valid while its stamp equals the workspace
+		// epoch so starting a new query never has to touch all n entries.
+		template<typename E>
+		struct search_frontier {
+			std::vector<E> dist;
+			std::vector<node_id> parent;
+			std::vector<std::uint32_t> reached;
+			std::vector<std::uint32_t> settled;
+			std::vector<heap_entry<E>> heap;
+
+			auto resize(std::size_t n) -> void {
+				if (dist.size() < n) {
+					dist.resize(n);
+					parent.resize(n);
+					reached.resize(n, 0);
+					settled.resize(n, 0);
+				}
+			}
+
+			auto reset_stamps() -> void {
+				std::fill(reached.begin(), reached.end(), 0);
+				std::fill(settled.begin(), settled.end(), 0);
+			}
+
+			[[nodiscard]] auto is_reached(node_id u, std::uint32_t epoch) const noexcept -> bool {
+				return reached[u] == epoch;
+			}
+
+			[[nodiscard]] auto is_settled(node_id u, std::uint32_t epoch) const noexcept -> bool {
+				return settled[u] == epoch;
+			}
+
+			auto label(node_id u, E d, node_id p, std::uint32_t epoch) noexcept -> void {
+				dist[u] = d;
+				parent[u] = p;
+				reached[u] = epoch;
+			}
+
+			auto push(heap_entry<E> entry) -> void {
+				heap.push_back(entry);
+				std::push_heap(heap.begin(), heap.end(), heap_greater<E>{});
+			}
+
+			auto pop() -> heap_entry<E> {
+				std::pop_heap(heap.begin(), heap.end(), heap_greater<E>{});
+				auto ret = heap.back();
+				heap.pop_back();
+				return ret;
+			}
+
+			[[nodiscard]] auto top_key() const noexcept -> E {
+				return heap.front().key;
+			}
+		};
+	} // namespace detail
+
+	// Scratch space for point to point searches. After the first query on a graph of a given size
+	// nothing is allocated again, so a workspace should be kept and handed to every query.
+	template<typename E>
+	class search_workspace {
+	public:
+		search_workspace() = default;
+
+		explicit search_workspace(std::size_t num_nodes) {
+			reserve(num_nodes);
+		}
+
+		auto reserve(std::size_t num_nodes) -> void {
+			forward_.resize(num_nodes);
+			backward_.resize(num_nodes);
+			forward_.heap.reserve(num_nodes);
+			backward_.heap.reserve(num_nodes);
+		}
+
+		// stats of the last query
+		[[nodiscard]] auto stats() const noexcept -> search_stats const& {
+			return stats_;
+		}
+
+		// writes the nodes of the last found path from src to dst into out, reusing its capacity
+		auto path(std::vector<node_id>& out) const -> void {
+			out.clear();
+			if (!found_) {
+				return;
+			}
+			for (auto u = meet_;; u = forward_.parent[u]) {
+				out.push_back(u);
+				if (u == src_) {
+					break;
+				}
+			}
+			std::reverse(out.begin(), out.end());
+			if (bidirectional_) {
+				for (auto u = meet_; u != dst_;) {
+					u = backward_.parent[u];
+					out.push_back(u);
+				}
+			}
+		}
+
+		// forward distance label of u from the last query, if the search reached it
+		[[nodiscard]] auto distance(node_id u) const -> std::optional<E> {
+			if (u >= forward_.dist.size() || !forward_.is_reached(u, epoch_)) {
+				return std::nullopt;
+			}
+			return forward_.dist[u];
+		}
+
+		// The pieces below are what the search routines build on, they are not needed to run a
+		// query.
+
+		// starts a new query, invalidating every label of the previous one in O(1)
+		auto start(std::size_t num_nodes, node_id src, node_id dst, bool bidirectional) -> void {
+			reserve(num_nodes);
+			if (++epoch_ == 0) {
+				forward_.reset_stamps();
+				backward_.reset_stamps();
+				epoch_ = 1;
+			}
+			forward_.heap.clear();
+			backward_.heap.clear();
+			stats_ = search_stats{};
+			src_ = src;
+			dst_ = dst;
+			meet_ = dst;
+			found_ = false;
+			bidirectional_ = bidirectional;
+		}
+
+		// records that the search finished, meet is where the two directions joined
+		auto finish(bool found, node_id meet) noexcept -> void {
+			found_ = found;
+			meet_ = meet;
+		}
+
+		[[nodiscard]] auto epoch() const noexcept -> std::uint32_t {
+			return epoch_;
+		}
+		[[nodiscard]] auto forward() noexcept -> detail::search_frontier<E>& {
+			return forward_;
+		}
+		[[nodiscard]] auto backward() noexcept -> detail::search_frontier<E>& {
+			return backward_;
+		}
+		[[nodiscard]] auto mutable_stats() noexcept -> search_stats& {
+			return stats_;
+		}
+
+	private:
+		detail::search_frontier<E> forward_;
+		detail::search_frontier<E> backward_;
+		std::uint32_t epoch_ = 0;
+		search_stats stats_;
+		node_id src_ = 0;
+		node_id dst_ = 0;
+		node_id meet_ = 0;
+		bool found_ = false;
+		bool bidirectional_ = false;
+	};
+
+	// A* from src to dst. heuristic(u) must not overestimate the distance from u to dst, the search
+	// stops as soon as dst is taken off the heap. Nodes are reopened if an inconsistent heuristic
+	// finds a shorter path to one already expanded.
+	template<typename N, typename E, typename Heuristic>
+	auto astar(csr_graph<N, E> const& g,
+	           node_id src,
+	           node_id dst,
+	           Heuristic&& heuristic,
+	           search_workspace<E>& ws) -> search_result<E> {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::astar requires arithmetic edge weights");
+		ws.start(g.num_nodes(), src, dst, false);
+		auto const epoch = ws.epoch();
+		auto& fwd = ws.forward();
+		auto& stats = ws.mutable_stats();
+
+		fwd.label(src, E{}, src, epoch);
+		fwd.push({heuristic(src), E{}, src});
+		++stats.pushed;
+		while (!fwd.heap.empty()) {
+			auto const top = fwd.pop();
+			// a later push already improved this node
+			if (top.dist != fwd.dist[top.node]) {
+				continue;
+			}
+			++stats.settled;
+			if (top.node == dst) {
+				ws.finish(true, dst);
+				return {true, top.dist, stats};
+			}
+			auto const targets = g.out_targets(top.node);
+			auto const weights = g.out_weights(top.node);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				++stats.relaxed;
+				if (weights[k] < E{}) {
+					throw std::runtime_error("Cannot call gdwg::astar on a graph with negative edge "
+					                         "weights");
+				}
+				auto const v = targets[k];
+				auto const d = top.dist + weights[k];
+				if (!fwd.is_reached(v, epoch) || d < fwd.dist[v]) {
+					fwd.label(v, d, top.node, epoch);
+					fwd.push({d + heuristic(v), d, v});
+					++stats.pushed;
+				}
+			}
+		}
+		ws.finish(false, dst);
+		return {false, E{}, stats};
+	}
+
+	// Dijkstra run from both ends at once, the forward half over outgoing edges and the backward
+	// half over incoming ones. Stops once the two smallest heap keys add up to at least the best
+	// path seen, which usually settles far fewer nodes than a one sided search.
+	template<typename N, typename E>
+	auto bidirectional_dijkstra(csr_graph<N, E> const& g,
+	                            node_id src,
+	                            node_id dst,
+	                            search_workspace<E>& ws) -> search_result<E> {
+		static_assert(std::is_arithmetic_v<E>,
+		              "gdwg::bidirectional_dijkstra requires arithmetic edge weights");
+		if (!g.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::bidirectional_dijkstra on a csr_graph built "
+			                         "without incoming edges");
+		}
+		ws.start(g.num_nodes(), src, dst, true);
+		auto const epoch = ws.epoch();
+		auto& fwd = ws.forward();
+		auto& bwd = ws.backward();
+		auto& stats = ws.mutable_stats();
+
+		fwd.label(src, E{}, src, epoch);
+		bwd.label(dst, E{}, dst, epoch);
+		if (src == dst) {
+			ws.finish(true, src);
+			return {true, E{}, stats};
+		}
+		fwd.push({E{}, E{}, src});
+		bwd.push({E{}, E{}, dst});
+		stats.pushed += 2;
+
+		auto found = false;
+		auto best = E{};
+		auto meet = dst;
+		while (!fwd.heap.empty() && !bwd.heap.empty()) {
+			if (found && fwd.top_key() + bwd.top_key() >= best) {
+				break;
+			}
+			auto const is_forward = fwd.top_key() <= bwd.top_key();
+			auto& self = is_forward ? fwd : bwd;
+			auto& other = is_forward ? bwd : fwd;
+			auto const top = self.pop();
+			if (top.dist != self.dist[top.node] || self.is_settled(top.node, epoch)) {
+				continue;
+			}
+			self.settled[top.node] = epoch;
+			++stats.settled;
+
+			auto const targets = is_forward ? g.out_targets(top.node) : g.in_sources(top.node);
+			auto const weights = is_forward ? g.out_weights(top.node) : g.in_weights(top.node);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				++stats.relaxed;
+				if (weights[k] < E{}) {
+					throw std::runtime_error("Cannot call gdwg::bidirectional_dijkstra on a graph with "
+					                         "negative edge weights");
+				}
+				auto const v = targets[k];
+				auto const d = top.dist + weights[k];
+				if (!self.is_reached(v, epoch) || d < self.dist[v]) {
+					self.label(v, d, top.node, epoch);
+					self.push({d, d, v});
+					++stats.pushed;
+					if (other.is_reached(v, epoch) && (!found || d + other.dist[v] < best)) {
+						found = true;
+						best = d + other.dist[v];
+						meet = v;
+					}
+				}
+			}
+		}
+		ws.finish(found, meet);
+		return {found, found ? best : E{}, stats};
+	}
+
+	namespace detail {
+		template<typename N, typename E>
+		auto to_path_result(csr_graph<N, E> const& view,
+		                    search_result<E> const& result,
+		                    search_workspace<E> const& ws) -> path_result<N, E> {
+			auto ret = path_result<N, E>{result.found, result.distance, {}, result.stats};
+			auto ids = std::vector<node_id>();
+			ws.path(ids);
+			ret.nodes.reserve(ids.size());
+			std::transform(ids.begin(), ids.end(), std::back_inserter(ret.nodes), [&](node_id u) {
+				return view.node(u);
+			});
+			return ret;
+		}
+	} // namespace detail
+
+	// One off A* over a graph, heuristic(n) estimates the distance from node value n to dst. This
+	// snapshots the graph first, so repeated queries should build a csr_graph and a
+	// search_workspace once and use the overload above.
+	template<typename N, typename E, typename Heuristic>
+	auto astar(graph<N, E> const& g, N const& src, N const& dst, Heuristic heuristic)
+	   -> path_result<N, E> {
+		if (!g.is_node(src) || !g.is_node(dst)) {
+			throw std::runtime_error("Cannot call gdwg::astar if src or dst node don't exist in the "
+			                         "graph");
+		}
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		auto ws = search_workspace<E>(view.num_nodes());
+		auto const result = astar(
+		   view,
+		   view.id(src),
+		   view.id(dst),
+		   [&](node_id u) { return heuristic(view.node(u)); },
+		   ws);
+		return detail::to_path_result(view, result, ws);
+	}
+
+	// One off bidirectional Dijkstra over a graph, see astar above for repeated queries
+	template<typename N, typename E>
+	auto bidirectional_dijkstra(graph<N, E> const& g, N const& src, N const& dst)
+	   -> path_result<N, E> {
+		if (!g.is_node(src) || !g.is_node(dst)) {
+			throw std::runtime_error("Cannot call gdwg::bidirectional_dijkstra if src or dst node "
+			                         "don't exist in the graph");
+		}
+		auto const view = csr_graph<N, E>(g);
+		auto ws = search_workspace<E>(view.num_nodes());
+		auto const result = bidirectional_dijkstra(view, view.id(src), view.id(dst), ws);
+		return detail::to_path_result(view, result, ws);
+	}
+} // namespace gdwg
+
+#endif // GDWG_SHORTEST_PATH_HPP
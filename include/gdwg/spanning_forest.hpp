@@ -0,0 +1,180 @@
+#ifndef GDWG_SPANNING_FOREST_HPP
+#define GDWG_SPANNING_FOREST_HPP
+
+#include "gdwg/connected_components.hpp"
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace gdwg {
+	// edges are positions in the flat edge arrays of the csr_graph
+	template<typename E>
+	struct spanning_forest_result {
+		std::vector<std::size_t> edges;
+		E total_weight = E{};
+	};
+
+	template<typename N, typename E>
+	struct spanning_forest {
+		std::vector<typename graph<N, E>::value_type> edges;
+		E total_weight = E{};
+	};
+
+	// Kruskal over the edges in weight order, treating every edge as undirected and skipping self
+	// loops. Equal weights are broken by edge position so the forest is the same one boruvka finds.
+	template<typename N, typename E>
+	auto kruskal(csr_graph<N, E> const& g) -> spanning_forest_result<E> {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::kruskal requires arithmetic edge weights");
+		auto ret = spanning_forest_result<E>{};
+		auto sets = detail::concurrent_union_find(g.num_nodes());
+		auto const sources = g.edge_sources();
+		auto const targets = g.targets();
+		auto const weights = g.weights();
+		for (auto const k : g.edges_by_weight()) {
+			auto const u = sets.find(sources[k]);
+			auto const v = sets.find(targets[k]);
+			if (u == v) {
+				continue;
+			}
+			sets.link(u, v);
+			ret.edges.push_back(k);
+			ret.total_weight += weights[k];
+			if (ret.edges.size() + 1 == g.num_nodes()) {
+				break;
+			}
+		}
+		return ret;
+	}
+
+	// Parallel Boruvka. Every round each component picks its lightest edge to another component
+	// (ties broken by edge position, so the picks can't form a cycle) through a lock free minimum
+	// on an atomic per component, then all picks are merged at once. Needs O(log(n)) rounds.
+	template<typename N, typename E>
+	auto boruvka(csr_graph<N, E> const& g, std::size_t threads = 0) -> spanning_forest_result<E> {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::boruvka requires arithmetic edge weights");
+		if (!g.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::boruvka on a csr_graph built without incoming "
+			                         "edges");
+		}
+		auto constexpr none = std::numeric_limits<std::size_t>::max();
+		auto const n = g.num_nodes();
+		auto ret = spanning_forest_result<E>{};
+		auto pool = detail::thread_pool(threads);
+		auto sets = detail::concurrent_union_find(n);
+		auto const sources = g.edge_sources();
+		auto const targets = g.targets();
+		auto const weights = g.weights();
+		auto best = std::vector<std::atomic<std::size_t>>(n);
+		auto picked = std::vector<std::vector<std::size_t>>(pool.size());
+
+		auto const lighter = [&](std::size_t lhs, std::size_t rhs) {
+			return rhs == none || weights[lhs] < weights[rhs]
+			       || (!(weights[rhs] < weights[lhs]) && lhs < rhs);
+		};
+		auto const offer = [&](node_id component, std::size_t k) {
+			auto current = best[component].load(std::memory_order_relaxed);
+			while (lighter(k, current)
+			       && !best[component].compare_exchange_weak(current, k, std::memory_order_relaxed))
+			{
+			}
+		};
+
+		auto merged = true;
+		while (merged) {
+			pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+				for (auto u = begin; u < end; ++u) {
+					sets.compress(static_cast<node_id>(u));
+					best[u].store(none, std::memory_order_relaxed);
+				}
+			});
+			pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+				for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+					auto const mine = sets.load(u);
+					auto const first = g.out_offset(u);
+					auto const out = g.out_targets(u);
+					for (auto i = std::size_t{0}; i < out.size(); ++i) {
+						if (sets.load(out[i]) != mine) {
+							offer(mine, first + i);
+						}
+					}
+					auto const in = g.in_sources(u);
+					auto const in_edges = g.in_edges(u);
+					for (auto i = std::size_t{0}; i < in.size(); ++i) {
+						if (sets.load(in[i]) != mine) {
+							offer(mine, in_edges[i]);
+						}
+					}
+				}
+			});
+			// two components picking each other's edge only keep it once
+			pool.parallel_for(n, [&](std::size_t t, std::size_t begin, std::size_t end) {
+				for (auto c = static_cast<node_id>(begin); c < end; ++c) {
+					auto const k = best[c].load(std::memory_order_relaxed);
+					if (k == none) {
+						continue;
+					}
+					auto const a = sets.load(sources[k]);
+					auto const other = a == c ? sets.load(targets[k]) : a;
+					if (best[other].load(std::memory_order_relaxed) != k || c < other) {
+						picked[t].push_back(k);
+					}
+				}
+			});
+			merged = false;
+			for (auto& edges : picked) {
+				merged = merged || !edges.empty();
+				for (auto const k : edges) {
+					ret.edges.push_back(k);
+					ret.total_weight += weights[k];
+				}
+			}
+			pool.parallel_for(pool.size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+				for (auto t = begin; t < end; ++t) {
+					for (auto const k : picked[t]) {
+						sets.link(sources[k], targets[k]);
+					}
+					picked[t].clear();
+				}
+			});
+		}
+		return ret;
+	}
+
+	namespace detail {
+		template<typename N, typename E>
+		auto to_spanning_forest(csr_graph<N, E> const& view, spanning_forest_result<E> const& result)
+		   -> spanning_forest<N, E> {
+			auto ret = spanning_forest<N, E>{{}, result.total_weight};
+			auto const sources = view.edge_sources();
+			auto const targets = view.targets();
+			auto const weights = view.weights();
+			ret.edges.reserve(result.edges.size());
+			for (auto const k : result.edges) {
+				ret.edges.push_back({view.node(sources[k]), view.node(targets[k]), weights[k]});
+			}
+			return ret;
+		}
+	} // namespace detail
+
+	// minimum spanning forest of g read as undirected, edges in the order they were chosen
+	template<typename N, typename E>
+	auto kruskal(graph<N, E> const& g) -> spanning_forest<N, E> {
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		return detail::to_spanning_forest(view, kruskal(view));
+	}
+
+	template<typename N, typename E>
+	auto boruvka(graph<N, E> const& g, std::size_t threads = 0) -> spanning_forest<N, E> {
+		auto const view = csr_graph<N, E>(g);
+		return detail::to_spanning_forest(view, boruvka(view, threads));
+	}
+} // namespace gdwg
+
+#endif // GDWG_SPANNING_FOREST_HPP
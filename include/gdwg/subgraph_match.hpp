@@ -0,0 +1,325 @@
+#ifndef GDWG_SUBGRAPH_MATCH_HPP
+#define GDWG_SUBGRAPH_MATCH_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct subgraph_options {
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+	};
+
+	namespace detail {
+		// the default node and edge predicate, anything goes
+		struct match_anything {
+			template<typename A, typename B>
+			constexpr auto operator()(A const&, B const&) const noexcept -> bool {
+				return true;
+			}
+		};
+
+		// distinct neighbours, parallel edges counted once
+		inline auto distinct_count(std::span<node_id const> sorted) -> std::size_t {
+			auto ret = std::size_t{0};
+			for (auto i = std::size_t{0}; i < sorted.size(); ++i) {
+				ret += i == 0 || sorted[i] != sorted[i - 1] ? 1 : 0;
+			}
+			return ret;
+		}
+
+		// A pattern edge between the node placed at some position and one placed earlier (or
+		// itself for a self loop). outgoing means the edge leaves the later node.
+		template<typename F>
+		struct match_constraint {
+			std::size_t earlier;
+			bool outgoing;
+			F weight;
+		};
+
+		// The order pattern nodes are matched in, VF2++ style: the rarest, best connected node
+		// first, then always the node with the most edges to those already placed, ties going to
+		// higher degree and then fewer candidates. Every node after the first that has an edge
+		// to an earlier one takes its candidates from that node's match's row.
+		template<typename F>
+		struct match_plan {
+			std::vector<node_id> order;
+			// earlier position whose row gives the candidates, or none
+			std::vector<std::size_t> anchor;
+			// whether the candidates are the out row (true) or in row of the anchor's match
+			std::vector<char> anchor_out;
+			std::vector<std::vector<match_constraint<F>>> constraints;
+			// allowed[i][t], whether target node t passes the filters for position i
+			std::vector<std::vector<char>> allowed;
+			static constexpr auto none = std::numeric_limits<std::size_t>::max();
+		};
+
+		template<typename P, typename F, typename N, typename E, typename NodeMatch>
+		auto plan_match(csr_graph<P, F> const& pattern,
+		                csr_graph<N, E> const& target,
+		                NodeMatch& node_match,
+		                thread_pool& pool) -> match_plan<F> {
+			auto const k = pattern.num_nodes();
+			auto const n = target.num_nodes();
+			auto target_out = std::vector<std::size_t>(n);
+			auto target_in = std::vector<std::size_t>(n);
+			pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+				for (auto t = static_cast<node_id>(begin); t < end; ++t) {
+					target_out[t] = distinct_count(target.out_targets(t));
+					target_in[t] = distinct_count(target.in_sources(t));
+				}
+			});
+			auto allowed = std::vector<std::vector<char>>(k, std::vector<char>(n, 0));
+			auto count = std::vector<std::size_t>(k, 0);
+			auto degree = std::vector<std::size_t>(k, 0);
+			for (auto p = node_id{0}; p < k; ++p) {
+				auto const out = distinct_count(pattern.out_targets(p));
+				auto const in = distinct_count(pattern.in_sources(p));
+				degree[p] = out + in;
+				pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+					for (auto t = static_cast<node_id>(begin); t < end; ++t) {
+						allowed[p][t] = target_out[t] >= out && target_in[t] >= in
+						                && node_match(pattern.node(p), target.node(t));
+					}
+				});
+				count[p] = static_cast<std::size_t>(
+				   std::count(allowed[p].begin(), allowed[p].end(), char{1}));
+			}
+
+			auto ret = match_plan<F>{};
+			auto position = std::vector<std::size_t>(k, match_plan<F>::none);
+			auto links = std::vector<std::size_t>(k, 0);
+			for (auto i = std::size_t{0}; i < k; ++i) {
+				// whether a should be placed before b
+				auto const before = [&](node_id a, node_id b) {
+					if (i == 0) {
+						return std::tuple(count[b], degree[a]) > std::tuple(count[a], degree[b]);
+					}
+					return std::tuple(links[a], degree[a], count[b])
+					       > std::tuple(links[b], degree[b], count[a]);
+				};
+				auto best = match_plan<F>::none;
+				for (auto p = node_id{0}; p < k; ++p) {
+					if (position[p] == match_plan<F>::none
+					    && (best == match_plan<F>::none || before(p, static_cast<node_id>(best))))
+					{
+						best = p;
+					}
+				}
+				auto const p = static_cast<node_id>(best);
+				position[p] = i;
+				ret.order.push_back(p);
+				ret.allowed.push_back(std::move(allowed[p]));
+				ret.anchor.push_back(match_plan<F>::none);
+				ret.anchor_out.push_back(0);
+				auto& constraints = ret.constraints.emplace_back();
+				auto const out = pattern.out_targets(p);
+				auto const out_weights = pattern.out_weights(p);
+				for (auto e = std::size_t{0}; e < out.size(); ++e) {
+					++links[out[e]];
+					if (position[out[e]] != match_plan<F>::none) {
+						constraints.push_back({position[out[e]], true, out_weights[e]});
+					}
+				}
+				auto const in = pattern.in_sources(p);
+				auto const in_weights = pattern.in_weights(p);
+				for (auto e = std::size_t{0}; e < in.size(); ++e) {
+					++links[in[e]];
+					// self loops were already taken from the out row
+					if (position[in[e]] != match_plan<F>::none && in[e] != p) {
+						constraints.push_back({position[in[e]], false, in_weights[e]});
+					}
+				}
+				for (auto const& c : constraints) {
+					if (c.earlier != i
+					    && (ret.anchor.back() == match_plan<F>::none || c.earlier < ret.anchor.back()))
+					{
+						ret.anchor.back() = c.earlier;
+						// p -> earlier means p is among the in row of earlier's match
+						ret.anchor_out.back() = c.outgoing ? 0 : 1;
+					}
+				}
+			}
+			return ret;
+		}
+
+		// whether some edge from -> to passes edge_match against the pattern weight
+		template<typename N, typename E, typename F, typename EdgeMatch>
+		auto has_edge(csr_graph<N, E> const& target,
+		              node_id from,
+		              node_id to,
+		              F const& weight,
+		              EdgeMatch& edge_match) -> bool {
+			auto const row = target.out_targets(from);
+			auto const weights = target.out_weights(from);
+			auto k = static_cast<std::size_t>(std::lower_bound(row.begin(), row.end(), to)
+			                                  - row.begin());
+			for (; k < row.size() && row[k] == to; ++k) {
+				if (edge_match(weight, weights[k])) {
+					return true;
+				}
+			}
+			return false;
+		}
+	} // namespace detail
+
+	// Finds every injective mapping of the pattern's nodes onto target nodes that carries each
+	// pattern edge onto a target edge in the same direction, so the pattern occurs as a subgraph
+	// though not necessarily an induced one. node_match(pattern value, target value) and
+	// edge_match(pattern weight, target weight) narrow down which nodes and edges may stand in,
+	// and a target node also needs at least as many distinct in and out neighbours as the pattern
+	// node. Matches are extended depth first in a fixed order of pattern nodes, taking candidates
+	// from a matched neighbour's row. Threads take the first pattern node's candidates from a
+	// shared counter and call sink(mapping) for every match, where mapping[p] is the target node
+	// id of pattern node id p. sink and both predicates are called from several threads at once
+	// and mapping is only valid during the call. Symmetric patterns are reported once per
+	// automorphism. Returns the number of matches.
+	template<typename P,
+	         typename F,
+	         typename N,
+	         typename E,
+	         typename Sink,
+	         typename NodeMatch = detail::match_anything,
+	         typename EdgeMatch = detail::match_anything>
+	auto subgraph_matches(csr_graph<P, F> const& pattern,
+	                      csr_graph<N, E> const& target,
+	                      Sink&& sink,
+	                      subgraph_options const& options = {},
+	                      NodeMatch node_match = {},
+	                      EdgeMatch edge_match = {}) -> std::size_t {
+		if (!pattern.has_incoming() || !target.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::subgraph_matches on a csr_graph built without "
+			                         "incoming edges");
+		}
+		auto const k = pattern.num_nodes();
+		if (k == 0) {
+			return 0;
+		}
+		auto pool = detail::thread_pool(options.threads);
+		auto const plan = detail::plan_match(pattern, target, node_match, pool);
+		auto seeds = std::vector<node_id>();
+		for (auto t = node_id{0}; t < target.num_nodes(); ++t) {
+			if (plan.allowed[0][t] != 0) {
+				seeds.push_back(t);
+			}
+		}
+
+		auto matches = std::atomic<std::size_t>(0);
+		auto next = std::atomic<std::size_t>(0);
+		pool.parallel_for(pool.size(), [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto thread = first; thread < last; ++thread) {
+				// matched[i] is the target node standing in for the pattern node at position i
+				auto matched = std::vector<node_id>(k);
+				auto mapping = std::vector<node_id>(k);
+				auto found = std::size_t{0};
+				auto const fits = [&](std::size_t i, node_id t) {
+					if (plan.allowed[i][t] == 0) {
+						return false;
+					}
+					auto const placed = matched.begin() + static_cast<std::ptrdiff_t>(i);
+					if (std::find(matched.begin(), placed, t) != placed) {
+						return false;
+					}
+					for (auto const& c : plan.constraints[i]) {
+						auto const other = c.earlier == i ? t : matched[c.earlier];
+						auto const from = c.outgoing ? t : other;
+						auto const to = c.outgoing ? other : t;
+						if (!detail::has_edge(target, from, to, c.weight, edge_match)) {
+							return false;
+						}
+					}
+					return true;
+				};
+				auto const extend = [&](auto&& self, std::size_t i) -> void {
+					if (i == k) {
+						for (auto j = std::size_t{0}; j < k; ++j) {
+							mapping[plan.order[j]] = matched[j];
+						}
+						++found;
+						sink(std::span<node_id const>(mapping));
+						return;
+					}
+					auto const anchor = plan.anchor[i];
+					auto const visit = [&](std::span<node_id const> candidates) {
+						for (auto c = std::size_t{0}; c < candidates.size(); ++c) {
+							auto const t = candidates[c];
+							if ((c == 0 || t != candidates[c - 1]) && fits(i, t)) {
+								matched[i] = t;
+								self(self, i + 1);
+							}
+						}
+					};
+					if (anchor == detail::match_plan<F>::none) {
+						for (auto t = node_id{0}; t < target.num_nodes(); ++t) {
+							if (fits(i, t)) {
+								matched[i] = t;
+								self(self, i + 1);
+							}
+						}
+					}
+					else if (plan.anchor_out[i] != 0) {
+						visit(target.out_targets(matched[anchor]));
+					}
+					else {
+						visit(target.in_sources(matched[anchor]));
+					}
+				};
+				for (auto s = next.fetch_add(1); s < seeds.size(); s = next.fetch_add(1)) {
+					if (fits(0, seeds[s])) {
+						matched[0] = seeds[s];
+						extend(extend, 1);
+					}
+				}
+				matches.fetch_add(found);
+			}
+		});
+		return matches.load();
+	}
+
+	// As above over graphs, sink(mapping) gets a std::span<N const> where mapping[i] stands in
+	// for the i-th node of pattern.nodes()
+	template<typename P,
+	         typename F,
+	         typename N,
+	         typename E,
+	         typename Sink,
+	         typename NodeMatch = detail::match_anything,
+	         typename EdgeMatch = detail::match_anything>
+	auto subgraph_matches(graph<P, F> const& pattern,
+	                      graph<N, E> const& target,
+	                      Sink&& sink,
+	                      subgraph_options const& options = {},
+	                      NodeMatch node_match = {},
+	                      EdgeMatch edge_match = {}) -> std::size_t {
+		auto const pattern_view = csr_graph<P, F>(pattern);
+		auto const target_view = csr_graph<N, E>(target);
+		auto const translate = [&](std::span<node_id const> mapping) {
+			// patterns are small, so a buffer per call is cheap next to the search
+			auto values = std::vector<N>();
+			values.reserve(mapping.size());
+			for (auto const t : mapping) {
+				values.push_back(target_view.node(t));
+			}
+			sink(std::span<N const>(values));
+		};
+		return subgraph_matches(pattern_view,
+		                        target_view,
+		                        translate,
+		                        options,
+		                        node_match,
+		                        edge_match);
+	}
+} // namespace gdwg
+
+#endif // GDWG_SUBGRAPH_MATCH_HPP
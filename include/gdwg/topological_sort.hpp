@@ -0,0 +1,373 @@
+#ifndef GDWG_TOPOLOGICAL_SORT_HPP
+#define GDWG_TOPOLOGICAL_SORT_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// order holds every node when the graph is a DAG, otherwise cycle holds one directed cycle
+	// (the last node has an edge back to the first)
+	struct topological_result {
+		bool is_dag = false;
+		std::vector<node_id> order;
+		std::vector<node_id> cycle;
+	};
+
+	template<typename N>
+	struct topological_order {
+		bool is_dag = false;
+		std::vector<N> order;
+		std::vector<N> cycle;
+	};
+
+	// Kahn's algorithm, O(n + e). Ties are broken by node id so the order is deterministic.
+	template<typename N, typename E>
+	auto topological_sort(csr_graph<N, E> const& g) -> topological_result {
+		auto const n = g.num_nodes();
+		auto ret = topological_result{};
+		auto in_degree = std::vector<std::uint32_t>(n, 0);
+		for (auto const v : g.targets()) {
+			++in_degree[v];
+		}
+		ret.order.reserve(n);
+		for (auto u = node_id{0}; u < n; ++u) {
+			if (in_degree[u] == 0) {
+				ret.order.push_back(u);
+			}
+		}
+		// order doubles as the queue
+		for (auto head = std::size_t{0}; head < ret.order.size(); ++head) {
+			for (auto const v : g.out_targets(ret.order[head])) {
+				if (--in_degree[v] == 0) {
+					ret.order.push_back(v);
+				}
+			}
+		}
+		ret.is_dag = ret.order.size() == n;
+		if (ret.is_dag) {
+			return ret;
+		}
+
+		// every node left over has a left over predecessor, so walking predecessors must loop
+		auto constexpr none = std::numeric_limits<node_id>::max();
+		auto pred = std::vector<node_id>(n, none);
+		for (auto u = node_id{0}; u < n; ++u) {
+			if (in_degree[u] == 0) {
+				continue;
+			}
+			for (auto const v : g.out_targets(u)) {
+				if (in_degree[v] != 0) {
+					pred[v] = u;
+				}
+			}
+		}
+		auto u = static_cast<node_id>(
+		   std::find_if(in_degree.begin(), in_degree.end(), [](auto d) { return d != 0; })
+		   - in_degree.begin());
+		auto seen = std::vector<bool>(n, false);
+		while (!seen[u]) {
+			seen[u] = true;
+			u = pred[u];
+		}
+		for (auto v = pred[u];; v = pred[v]) {
+			ret.cycle.push_back(v);
+			if (v == u) {
+				break;
+			}
+		}
+		std::reverse(ret.cycle.begin(), ret.cycle.end());
+		ret.order.clear();
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto topological_sort(graph<N, E> const& g) -> topological_order<N> {
+		auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+		auto const result = topological_sort(view);
+		auto ret = topological_order<N>{result.is_dag, {}, {}};
+		auto const to_value = [&](node_id u) { return view.node(u); };
+		std::transform(result.order.begin(),
+		               result.order.end(),
+		               std::back_inserter(ret.order),
+		               to_value);
+		std::transform(result.cycle.begin(),
+		               result.cycle.end(),
+		               std::back_inserter(ret.cycle),
+		               to_value);
+		return ret;
+	}
+
+	// what happened to an edge handed to incremental_topological_order::insert_edge
+	template<typename N>
+	struct dag_insert_result {
+		// false for an edge that already existed or one that was rejected
+		bool inserted = false;
+		// when rejected, the cycle the edge would have closed, starting at dst and ending at src
+		std::vector<N> cycle;
+	};
+
+	// Keeps a topological order of a DAG up to date while edges are added, using the Pearce-Kelly
+	// algorithm: an edge src -> dst that already agrees with the order costs O(log(n)), otherwise
+	// only the nodes whose position lies between dst and src and that are reachable from dst (or
+	// reach src) are searched and shuffled. Edges that would close a cycle are rejected and the
+	// cycle is reported. The graph must only be modified through this object while it is alive.
+	template<typename N, typename E>
+	class incremental_topological_order {
+	public:
+		explicit incremental_topological_order(graph<N, E>& g)
+		: graph_{g} {
+			auto const view = csr_graph<N, E>(g, csr_layout::outgoing);
+			auto const sorted = topological_sort(view);
+			if (!sorted.is_dag) {
+				throw std::runtime_error("Cannot construct gdwg::incremental_topological_order over a "
+				                         "graph that has a cycle");
+			}
+			auto const n = view.num_nodes();
+			values_ = view.nodes();
+			out_.resize(n);
+			in_.resize(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				index_.emplace_hint(index_.end(), values_[u], u);
+				for (auto const v : view.out_targets(u)) {
+					out_[u].push_back(v);
+					in_[v].push_back(u);
+				}
+			}
+			ord_.resize(n);
+			node_at_ = sorted.order;
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				ord_[node_at_[i]] = static_cast<std::uint32_t>(i);
+			}
+			visited_.assign(n, 0);
+		}
+
+		// new nodes have no edges yet so they go at the end of the order
+		auto insert_node(N const& value) -> bool {
+			if (!graph_.insert_node(value)) {
+				return false;
+			}
+			auto u = node_id{0};
+			if (free_.empty()) {
+				u = static_cast<node_id>(values_.size());
+				values_.push_back(value);
+				out_.emplace_back();
+				in_.emplace_back();
+				ord_.push_back(0);
+				visited_.push_back(0);
+			}
+			else {
+				u = free_.back();
+				free_.pop_back();
+				values_[u] = value;
+			}
+			index_.emplace(value, u);
+			ord_[u] = static_cast<std::uint32_t>(node_at_.size());
+			node_at_.push_back(u);
+			return true;
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> dag_insert_result<N> {
+			auto const x = lookup(src, "insert_edge");
+			auto const y = lookup(dst, "insert_edge");
+			auto ret = dag_insert_result<N>{};
+			last_reordered_ = 0;
+			if (graph_.find(src, dst, weight) != graph_.end()) {
+				return ret;
+			}
+			if (x == y) {
+				ret.cycle.push_back(src);
+				return ret;
+			}
+			if (ord_[y] < ord_[x] && !reorder(x, y, ret.cycle)) {
+				return ret;
+			}
+			graph_.insert_edge(src, dst, weight);
+			out_[x].push_back(y);
+			in_[y].push_back(x);
+			ret.inserted = true;
+			return ret;
+		}
+
+		// removing edges can't break the order, so this only keeps the adjacency in sync
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			auto const x = lookup(src, "erase_edge");
+			auto const y = lookup(dst, "erase_edge");
+			if (!graph_.erase_edge(src, dst, weight)) {
+				return false;
+			}
+			out_[x].erase(std::find(out_[x].begin(), out_[x].end(), y));
+			in_[y].erase(std::find(in_[y].begin(), in_[y].end(), x));
+			return true;
+		}
+
+		// O(n) since every later node moves up one position
+		auto erase_node(N const& value) -> bool {
+			auto const it = index_.find(value);
+			if (it == index_.end()) {
+				return false;
+			}
+			auto const u = it->second;
+			graph_.erase_node(value);
+			for (auto const v : out_[u]) {
+				std::erase(in_[v], u);
+			}
+			for (auto const v : in_[u]) {
+				std::erase(out_[v], u);
+			}
+			out_[u].clear();
+			in_[u].clear();
+			free_.push_back(u);
+			index_.erase(it);
+			node_at_.erase(node_at_.begin() + ord_[u]);
+			for (auto i = std::size_t{ord_[u]}; i < node_at_.size(); ++i) {
+				ord_[node_at_[i]] = static_cast<std::uint32_t>(i);
+			}
+			return true;
+		}
+
+		// the current order, every edge goes from an earlier node to a later one
+		[[nodiscard]] auto order() const -> std::vector<N> {
+			auto ret = std::vector<N>();
+			ret.reserve(node_at_.size());
+			std::transform(node_at_.begin(), node_at_.end(), std::back_inserter(ret), [&](auto u) {
+				return values_[u];
+			});
+			return ret;
+		}
+
+		[[nodiscard]] auto position(N const& value) const -> std::size_t {
+			return ord_[lookup(value, "position")];
+		}
+
+		// how many nodes the last insert_edge moved, for tuning
+		[[nodiscard]] auto last_reordered() const noexcept -> std::size_t {
+			return last_reordered_;
+		}
+
+		[[nodiscard]] auto underlying() const noexcept -> graph<N, E> const& {
+			return graph_;
+		}
+
+	private:
+		graph<N, E>& graph_;
+		std::vector<N> values_;
+		std::map<N, node_id> index_;
+		std::vector<std::vector<node_id>> out_;
+		std::vector<std::vector<node_id>> in_;
+		std::vector<node_id> free_;
+		// ord_[u] is u's position, node_at_[i] the node at position i
+		std::vector<std::uint32_t> ord_;
+		std::vector<node_id> node_at_;
+		// scratch space kept between inserts
+		std::vector<std::uint32_t> visited_;
+		std::uint32_t epoch_ = 0;
+		std::vector<node_id> stack_;
+		std::vector<node_id> parent_;
+		std::vector<node_id> forward_;
+		std::vector<node_id> backward_;
+		std::vector<std::uint32_t> slots_;
+		std::size_t last_reordered_ = 0;
+
+		[[nodiscard]] auto lookup(N const& value, char const* caller) const -> node_id {
+			auto const it = index_.find(value);
+			if (it == index_.end()) {
+				throw std::runtime_error(std::string("Cannot call gdwg::incremental_topological_order<N, "
+				                                     "E>::")
+				                         + caller + " on a node that doesn't exist in the graph");
+			}
+			return it->second;
+		}
+
+		// Edge x -> y where y currently comes before x. Returns false and fills cycle if y reaches x.
+		auto reorder(node_id x, node_id y, std::vector<N>& cycle) -> bool {
+			auto const lower = ord_[y];
+			auto const upper = ord_[x];
+			if (++epoch_ == 0) {
+				std::fill(visited_.begin(), visited_.end(), 0);
+				epoch_ = 1;
+			}
+			parent_.resize(values_.size());
+
+			// forward from y through nodes positioned no later than x
+			forward_.clear();
+			stack_.assign(1, y);
+			visited_[y] = epoch_;
+			while (!stack_.empty()) {
+				auto const u = stack_.back();
+				stack_.pop_back();
+				forward_.push_back(u);
+				for (auto const v : out_[u]) {
+					if (v == x) {
+						for (auto w = u;; w = parent_[w]) {
+							cycle.push_back(values_[w]);
+							if (w == y) {
+								break;
+							}
+						}
+						std::reverse(cycle.begin(), cycle.end());
+						cycle.push_back(values_[x]);
+						return false;
+					}
+					if (visited_[v] != epoch_ && ord_[v] < upper) {
+						visited_[v] = epoch_;
+						parent_[v] = u;
+						stack_.push_back(v);
+					}
+				}
+			}
+
+			// backward from x through nodes positioned no earlier than y
+			backward_.clear();
+			stack_.assign(1, x);
+			visited_[x] = epoch_;
+			while (!stack_.empty()) {
+				auto const u = stack_.back();
+				stack_.pop_back();
+				backward_.push_back(u);
+				for (auto const v : in_[u]) {
+					if (visited_[v] != epoch_ && ord_[v] > lower) {
+						visited_[v] = epoch_;
+						stack_.push_back(v);
+					}
+				}
+			}
+
+			// the two sets swap places, each keeping its internal order, in the positions they held
+			auto const by_position = [this](node_id a, node_id b) { return ord_[a] < ord_[b]; };
+			std::sort(forward_.begin(), forward_.end(), by_position);
+			std::sort(backward_.begin(), backward_.end(), by_position);
+			slots_.clear();
+			for (auto const u : backward_) {
+				slots_.push_back(ord_[u]);
+			}
+			for (auto const u : forward_) {
+				slots_.push_back(ord_[u]);
+			}
+			std::sort(slots_.begin(), slots_.end());
+			auto slot = slots_.begin();
+			for (auto const u : backward_) {
+				ord_[u] = *slot;
+				node_at_[*slot++] = u;
+			}
+			for (auto const u : forward_) {
+				ord_[u] = *slot;
+				node_at_[*slot++] = u;
+			}
+			last_reordered_ = slots_.size();
+			return true;
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_TOPOLOGICAL_SORT_HPP
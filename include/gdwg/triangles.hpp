@@ -0,0 +1,191 @@
+#ifndef GDWG_TRIANGLES_HPP
+#define GDWG_TRIANGLES_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/intersect.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace gdwg {
+	struct triangle_options {
+		// 0 uses every hardware thread
+		std::size_t threads = 0;
+	};
+
+	// per_node[u] is the number of triangles through node id u, degree[u] its number of distinct
+	// neighbours and clustering[u] its local clustering coefficient, 0 for nodes with fewer than two
+	// neighbours. transitivity is the global coefficient, three times the triangles over the
+	// connected triples.
+	struct triangle_result {
+		std::uint64_t triangles = 0;
+		std::vector<std::uint64_t> per_node;
+		std::vector<std::size_t> degree;
+		std::vector<double> clustering;
+		double transitivity = 0.0;
+		double average_clustering = 0.0;
+	};
+
+	namespace detail {
+		// Neighbours of every node with direction, parallel edges and self loops dropped, then
+		// oriented from lower to higher (degree, id) rank and renumbered by rank. Each triangle is
+		// then found exactly once, from its lowest ranked node, and no list is longer than
+		// O(sqrt(e)).
+		struct oriented_adjacency {
+			std::vector<std::size_t> degree;
+			std::vector<node_id> rank;
+			std::vector<node_id> by_rank;
+			std::vector<std::size_t> offsets;
+			std::vector<node_id> targets;
+
+			template<typename N, typename E>
+			oriented_adjacency(csr_graph<N, E> const& g, thread_pool& pool)
+			: degree(g.num_nodes())
+			, rank(g.num_nodes())
+			, by_rank(g.num_nodes())
+			, offsets(g.num_nodes() + 1, 0) {
+				auto const n = g.num_nodes();
+				// out and in rows are both ascending, so a merge gives the undirected row
+				auto const for_each_neighbour = [&g](node_id u, auto&& fn) {
+					auto const out = g.out_targets(u);
+					auto const in = g.in_sources(u);
+					auto i = std::size_t{0};
+					auto j = std::size_t{0};
+					auto last = u;
+					while (i < out.size() || j < in.size()) {
+						auto const v = j == in.size() || (i < out.size() && out[i] < in[j]) ? out[i++]
+						                                                                     : in[j++];
+						if (v != u && v != last) {
+							fn(v);
+						}
+						last = v;
+					}
+				};
+				pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+					for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+						for_each_neighbour(u, [&](node_id) { ++degree[u]; });
+					}
+				});
+				for (auto u = node_id{0}; u < n; ++u) {
+					by_rank[u] = u;
+				}
+				std::sort(by_rank.begin(), by_rank.end(), [this](node_id lhs, node_id rhs) {
+					return degree[lhs] < degree[rhs] || (degree[lhs] == degree[rhs] && lhs < rhs);
+				});
+				for (auto r = node_id{0}; r < n; ++r) {
+					rank[by_rank[r]] = r;
+				}
+
+				pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+					for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+						auto count = std::size_t{0};
+						for_each_neighbour(u, [&](node_id v) { count += rank[v] > rank[u] ? 1 : 0; });
+						offsets[rank[u] + 1] = count;
+					}
+				});
+				for (auto r = std::size_t{0}; r < n; ++r) {
+					offsets[r + 1] += offsets[r];
+				}
+				targets.resize(offsets[n]);
+				pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+					for (auto u = static_cast<node_id>(begin); u < end; ++u) {
+						auto const first = offsets[rank[u]];
+						auto next = first;
+						for_each_neighbour(u, [&](node_id v) {
+							if (rank[v] > rank[u]) {
+								targets[next++] = rank[v];
+							}
+						});
+						std::sort(targets.begin() + static_cast<std::ptrdiff_t>(first),
+						          targets.begin() + static_cast<std::ptrdiff_t>(next));
+					}
+				});
+			}
+
+			[[nodiscard]] auto row(node_id r) const noexcept -> std::span<node_id const> {
+				return {targets.data() + offsets[r], offsets[r + 1] - offsets[r]};
+			}
+		};
+	} // namespace detail
+
+	// Triangles of g read as an undirected simple graph. Each oriented edge (u, v) intersects the
+	// two oriented rows, see detail::intersect for the kernels. Threads take chunks of nodes from a
+	// shared counter since the work per node is uneven, and count into their own arrays.
+	template<typename N, typename E>
+	auto count_triangles(csr_graph<N, E> const& g, triangle_options const& options = {})
+	   -> triangle_result {
+		if (!g.has_incoming()) {
+			throw std::runtime_error("Cannot call gdwg::count_triangles on a csr_graph built without "
+			                         "incoming edges");
+		}
+		auto const n = g.num_nodes();
+		auto pool = detail::thread_pool(options.threads);
+		auto const adjacency = detail::oriented_adjacency(g, pool);
+		auto local = std::vector<std::vector<std::uint64_t>>(pool.size());
+		auto next = std::atomic<std::size_t>(0);
+		auto constexpr chunk = std::size_t{64};
+
+		pool.parallel_for(pool.size(), [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto t = first; t < last; ++t) {
+				auto& counts = local[t];
+				counts.assign(n, 0);
+				for (auto begin = next.fetch_add(chunk); begin < n; begin = next.fetch_add(chunk)) {
+					for (auto u = static_cast<node_id>(begin); u < std::min(begin + chunk, n); ++u) {
+						auto const row = adjacency.row(u);
+						for (auto const v : row) {
+							detail::intersect(row, adjacency.row(v), [&](node_id w) {
+								++counts[u];
+								++counts[v];
+								++counts[w];
+							});
+						}
+					}
+				}
+			}
+		});
+
+		auto ret = triangle_result{};
+		ret.per_node.assign(n, 0);
+		ret.degree = adjacency.degree;
+		ret.clustering.assign(n, 0.0);
+		pool.parallel_for(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+			for (auto u = begin; u < end; ++u) {
+				for (auto const& counts : local) {
+					ret.per_node[u] += counts[adjacency.rank[u]];
+				}
+				auto const d = static_cast<double>(ret.degree[u]);
+				if (ret.degree[u] > 1) {
+					ret.clustering[u] = 2.0 * static_cast<double>(ret.per_node[u]) / (d * (d - 1.0));
+				}
+			}
+		});
+		auto corners = std::uint64_t{0};
+		auto triples = 0.0;
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			corners += ret.per_node[u];
+			auto const d = static_cast<double>(ret.degree[u]);
+			triples += d * (d - 1.0) / 2.0;
+			ret.average_clustering += ret.clustering[u];
+		}
+		// every triangle has three corners
+		ret.triangles = corners / 3;
+		ret.transitivity = triples == 0.0 ? 0.0 : 3.0 * static_cast<double>(ret.triangles) / triples;
+		ret.average_clustering = n == 0 ? 0.0 : ret.average_clustering / static_cast<double>(n);
+		return ret;
+	}
+
+	template<typename N, typename E>
+	auto count_triangles(graph<N, E> const& g, triangle_options const& options = {})
+	   -> triangle_result {
+		return count_triangles(csr_graph<N, E>(g), options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_TRIANGLES_HPP
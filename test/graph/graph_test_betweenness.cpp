@@ -0,0 +1,167 @@
+#include "gdwg/betweenness.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Rationale: small graphs with known scores, then random graphs against the textbook formula
+// from all pairs distances and path counts, weighted and unweighted and with several threads.
+// Sampling is checked to be reproducible by seed and to stay inside the bound it reports.
+
+namespace {
+	// sum over s != v != t of sigma(s, v) * sigma(v, t) / sigma(s, t) on shortest s-t paths via v
+	auto brute_force(gdwg::csr_graph<int, double> const& view, bool weighted)
+	   -> std::vector<double> {
+		auto const n = view.num_nodes();
+		auto constexpr infinity = std::numeric_limits<double>::infinity();
+		auto dist = std::vector<std::vector<double>>(n, std::vector<double>(n, infinity));
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			dist[u][u] = 0.0;
+			auto const out = view.out_targets(u);
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				auto const w = weighted ? view.out_weights(u)[i] : 1.0;
+				if (out[i] != u) {
+					dist[u][out[i]] = std::min(dist[u][out[i]], w);
+				}
+			}
+		}
+		auto const direct = dist;
+		for (auto k = std::size_t{0}; k < n; ++k) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				for (auto j = std::size_t{0}; j < n; ++j) {
+					dist[i][j] = std::min(dist[i][j], dist[i][k] + dist[k][j]);
+				}
+			}
+		}
+		// paths counted in order of distance from each source
+		auto sigma = std::vector<std::vector<double>>(n, std::vector<double>(n, 0.0));
+		for (auto s = std::size_t{0}; s < n; ++s) {
+			auto order = std::vector<std::size_t>();
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				if (dist[s][v] < infinity) {
+					order.push_back(v);
+				}
+			}
+			std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+				return dist[s][a] < dist[s][b];
+			});
+			sigma[s][s] = 1.0;
+			for (auto const v : order) {
+				for (auto const u : order) {
+					if (u != v && direct[u][v] < infinity && dist[s][u] + direct[u][v] == dist[s][v]) {
+						sigma[s][v] += sigma[s][u];
+					}
+				}
+			}
+		}
+		auto ret = std::vector<double>(n, 0.0);
+		for (auto s = std::size_t{0}; s < n; ++s) {
+			for (auto t = std::size_t{0}; t < n; ++t) {
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (s == t || v == s || v == t || dist[s][t] == infinity) {
+						continue;
+					}
+					if (dist[s][v] + dist[v][t] == dist[s][t]) {
+						ret[v] += sigma[s][v] * sigma[v][t] / sigma[s][t];
+					}
+				}
+			}
+		}
+		return ret;
+	}
+
+	auto check_close(std::vector<double> const& actual, std::vector<double> const& expected)
+	   -> void {
+		REQUIRE(actual.size() == expected.size());
+		for (auto u = std::size_t{0}; u < actual.size(); ++u) {
+			CHECK(actual[u] == Approx(expected[u]).margin(1e-9));
+		}
+	}
+} // namespace
+
+TEST_CASE("betweenness on small graphs") {
+	// a diamond a -> {b, c} -> d with d -> e, where the cheaper side wins when weighted
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "b", 5);
+	g.insert_edge("a", "c", 2);
+	g.insert_edge("b", "d", 1);
+	g.insert_edge("c", "d", 2);
+	g.insert_edge("d", "e", 1);
+
+	auto const unweighted = gdwg::betweenness(g, {.weighted = false, .threads = 1});
+	// b and c each carry half of a -> d and a -> e, d carries a, b, c -> e
+	check_close(unweighted.centrality, {0.0, 1.0, 1.0, 3.0, 0.0});
+	CHECK(unweighted.exact);
+	CHECK(unweighted.sources == 5);
+
+	auto const weighted = gdwg::betweenness(g, {.threads = 2});
+	check_close(weighted.centrality, {0.0, 2.0, 0.0, 3.0, 0.0});
+
+	auto const normalized = gdwg::betweenness(g, {.normalized = true});
+	check_close(normalized.centrality, {0.0, 2.0 / 12.0, 0.0, 3.0 / 12.0, 0.0});
+
+	CHECK(gdwg::betweenness(gdwg::graph<int, int>{}).centrality.empty());
+}
+
+TEST_CASE("betweenness matches the definition on random graphs") {
+	for (auto round = std::size_t{0}; round < 4; ++round) {
+		auto const g = gdwg::rmat_graph<double>({.scale = 6,
+		                                         .edge_factor = 2 + round,
+		                                         .max_weight = round % 2 == 0 ? 1 : 4,
+		                                         .seed = round});
+		auto const view = gdwg::csr_graph<int, double>(g);
+		for (auto const weighted : {false, true}) {
+			auto const expected = brute_force(view, weighted);
+			for (auto const threads : {std::size_t{1}, std::size_t{3}}) {
+				auto const result = gdwg::betweenness(view, {.weighted = weighted, .threads = threads});
+				check_close(result.centrality, expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("sampled betweenness") {
+	auto const g = gdwg::rmat_graph<double>({.scale = 7, .edge_factor = 4, .seed = 3});
+	auto const view = gdwg::csr_graph<int, double>(g);
+	auto const exact = gdwg::betweenness(view);
+
+	auto const options = gdwg::betweenness_options{.samples = 40, .confidence = 0.9, .threads = 2};
+	auto const sampled = gdwg::betweenness(view, options);
+	CHECK(!sampled.exact);
+	CHECK(sampled.sources == 40);
+	CHECK(sampled.error_bound > 0.0);
+	for (auto u = std::size_t{0}; u < view.num_nodes(); ++u) {
+		CHECK(std::abs(sampled.centrality[u] - exact.centrality[u]) <= sampled.error_bound);
+	}
+	// the same seed picks the same sources, threads only change the order of the sums
+	check_close(gdwg::betweenness(view, options).centrality, sampled.centrality);
+
+	// asking for every node is the exact run
+	auto const all = gdwg::betweenness(view, {.samples = view.num_nodes()});
+	CHECK(all.exact);
+	check_close(all.centrality, exact.centrality);
+
+	auto const loose = gdwg::betweenness_sample_size(1000, 0.1, 0.9);
+	CHECK(loose < gdwg::betweenness_sample_size(1000, 0.05, 0.9));
+	CHECK(gdwg::betweenness_sample_size(1000, 1e-6, 0.9) == 1000);
+}
+
+TEST_CASE("betweenness errors") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	g.insert_edge(1, 2, 0);
+	CHECK_THROWS_MATCHES(gdwg::betweenness(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::betweenness on a graph with "
+	                                              "non-positive edge weights"));
+	CHECK(gdwg::betweenness(g, {.weighted = false}).centrality.size() == 2);
+	CHECK_THROWS_MATCHES(gdwg::betweenness(g, {.weighted = false, .samples = 1, .confidence = 1.0}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::betweenness with a confidence "
+	                                              "outside (0, 1)"));
+}
@@ -0,0 +1,104 @@
+#include "gdwg/connected_components.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: the labels are compared against a single threaded search over the edges in both
+// directions for several thread counts, on random graphs where the giant component sampling has
+// something to find and on an R-MAT graph like the ones this is meant for.
+
+namespace {
+	// component of every node by a search that ignores direction, numbered by smallest node
+	template<typename E>
+	auto reference_components(gdwg::csr_graph<int, E> const& view)
+	   -> std::vector<gdwg::component_id> {
+		auto const n = view.num_nodes();
+		auto constexpr unset = std::numeric_limits<gdwg::component_id>::max();
+		auto ret = std::vector<gdwg::component_id>(n, unset);
+		auto next = gdwg::component_id{0};
+		for (auto s = gdwg::node_id{0}; s < n; ++s) {
+			if (ret[s] != unset) {
+				continue;
+			}
+			auto stack = std::vector<gdwg::node_id>{s};
+			ret[s] = next;
+			while (!stack.empty()) {
+				auto const u = stack.back();
+				stack.pop_back();
+				auto const visit = [&](gdwg::node_id v) {
+					if (ret[v] == unset) {
+						ret[v] = next;
+						stack.push_back(v);
+					}
+				};
+				std::for_each(view.out_targets(u).begin(), view.out_targets(u).end(), visit);
+				std::for_each(view.in_sources(u).begin(), view.in_sources(u).end(), visit);
+			}
+			++next;
+		}
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("weakly connected components on a small graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e", "f"};
+	g.insert_edge("b", "a", 1);
+	g.insert_edge("c", "b", 1);
+	g.insert_edge("d", "e", 1);
+	g.insert_edge("f", "f", 1);
+	auto const result = gdwg::weakly_connected_components(g);
+	CHECK(result.component == std::vector<gdwg::component_id>{0, 0, 0, 1, 1, 2});
+	CHECK(result.sizes == std::vector<std::size_t>{3, 2, 1});
+
+	auto const empty = gdwg::weakly_connected_components(gdwg::graph<int, int>{});
+	CHECK(empty.component.empty());
+	CHECK(empty.sizes.empty());
+
+	auto const view = gdwg::csr_graph<std::string, int>(g, gdwg::csr_layout::outgoing);
+	CHECK_THROWS_MATCHES(gdwg::weakly_connected_components(view),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::weakly_connected_components on a "
+	                                              "csr_graph built without incoming edges"));
+}
+
+TEST_CASE("weakly connected components match a sequential search") {
+	auto rng = std::mt19937(6771);
+	for (auto round = 0; round < 6; ++round) {
+		auto constexpr n = 500;
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		for (auto i = 0; i < 150 * (round + 1); ++i) {
+			g.insert_edge(node(rng), node(rng), 1);
+		}
+		auto const view = gdwg::csr_graph<int, int>(g);
+		auto const expected = reference_components(view);
+		for (auto const threads : {1, 2, 4, 7}) {
+			auto const result = gdwg::weakly_connected_components(
+			   view,
+			   {.threads = static_cast<std::size_t>(threads), .samples = 64});
+			CHECK(result.component == expected);
+			CHECK(std::accumulate(result.sizes.begin(), result.sizes.end(), std::size_t{0}) == n);
+		}
+	}
+}
+
+TEST_CASE("weakly connected components on an R-MAT graph") {
+	auto const g = gdwg::rmat_graph({.scale = 12, .edge_factor = 4, .seed = 42});
+	auto const view = gdwg::csr_graph<int, int>(g);
+	auto const expected = reference_components(view);
+	auto const result = gdwg::weakly_connected_components(view, {.threads = 4});
+	CHECK(result.component == expected);
+	// R-MAT leaves plenty of isolated nodes next to one giant component
+	auto const giant = *std::max_element(result.sizes.begin(), result.sizes.end());
+	CHECK(giant > view.num_nodes() / 2);
+	CHECK(result.sizes.size() > 1);
+}
@@ -0,0 +1,145 @@
+#include "gdwg/contraction_hierarchy.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <sstream>
+#include <vector>
+
+// Rationale: every query answered through the hierarchy has to match a plain search on the
+// original graph, including the unpacked path. The same has to hold after the hierarchy has been
+// written out and loaded back.
+
+namespace {
+	// a noisy grid with a few long range edges, close to what a road graph looks like
+	auto road_like_graph(int side, unsigned seed) -> gdwg::graph<int, double> {
+		auto g = gdwg::graph<int, double>{};
+		for (auto i = 0; i < side * side; ++i) {
+			g.insert_node(i);
+		}
+		auto rng = std::mt19937(seed);
+		auto weight = std::uniform_real_distribution<double>(1.0, 10.0);
+		auto node = std::uniform_int_distribution<int>(0, side * side - 1);
+		for (auto r = 0; r < side; ++r) {
+			for (auto c = 0; c < side; ++c) {
+				auto const u = r * side + c;
+				if (c + 1 < side) {
+					g.insert_edge(u, u + 1, weight(rng));
+					g.insert_edge(u + 1, u, weight(rng));
+				}
+				if (r + 1 < side) {
+					g.insert_edge(u, u + side, weight(rng));
+				}
+			}
+		}
+		for (auto i = 0; i < side; ++i) {
+			g.insert_edge(node(rng), node(rng), 5 * weight(rng));
+		}
+		return g;
+	}
+
+	auto path_weight(gdwg::graph<int, double> const& g, std::vector<int> const& path) -> double {
+		auto total = 0.0;
+		for (auto i = std::size_t{0}; i + 1 < path.size(); ++i) {
+			auto const w = g.weights(path[i], path[i + 1]);
+			REQUIRE_FALSE(w.empty());
+			total += *std::min_element(w.begin(), w.end());
+		}
+		return total;
+	}
+} // namespace
+
+TEST_CASE("contraction hierarchy on a small graph") {
+	auto g = gdwg::graph<int, double>{1, 2, 3, 4, 5};
+	g.insert_edge(1, 2, 1.0);
+	g.insert_edge(2, 3, 1.0);
+	g.insert_edge(3, 4, 1.0);
+	g.insert_edge(1, 4, 5.0);
+	g.insert_edge(1, 4, 4.0);
+	g.insert_edge(4, 4, 1.0);
+	auto const ch = gdwg::contraction_hierarchy<int, double>(g);
+	CHECK(ch.num_nodes() == 5);
+
+	auto const result = ch.query(1, 4);
+	CHECK(result.found);
+	CHECK(result.distance == Approx(3.0));
+	CHECK(result.nodes == std::vector<int>{1, 2, 3, 4});
+
+	CHECK_FALSE(ch.query(4, 1).found);
+	CHECK_FALSE(ch.query(1, 5).found);
+	CHECK(ch.query(5, 5).found);
+
+	CHECK_THROWS_MATCHES(ch.query(1, 9),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::contraction_hierarchy<N, "
+	                                              "E>::query if src or dst node don't exist in the "
+	                                              "graph"));
+
+	// every original edge survives in the augmented graph
+	auto const augmented = ch.shortcut_graph();
+	CHECK(augmented.is_connected(1, 2));
+	CHECK(augmented.is_connected(2, 3));
+	CHECK(augmented.is_connected(3, 4));
+	CHECK_FALSE(augmented.is_connected(4, 4));
+}
+
+TEST_CASE("contraction hierarchy matches dijkstra") {
+	auto const g = road_like_graph(12, 6771);
+	auto const view = gdwg::csr_graph<int, double>(g);
+	auto const ch = gdwg::contraction_hierarchy<int, double>(view);
+	auto ws = gdwg::search_workspace<double>();
+	auto reference = gdwg::search_workspace<double>();
+	auto hierarchy_path = std::vector<gdwg::node_id>();
+	auto path = std::vector<gdwg::node_id>();
+	for (auto s = gdwg::node_id{0}; s < view.num_nodes(); s += 5) {
+		for (auto t = gdwg::node_id{0}; t < view.num_nodes(); t += 3) {
+			auto const expected = gdwg::bidirectional_dijkstra(view, s, t, reference);
+			auto const got = ch.query(s, t, ws);
+			REQUIRE(got.found == expected.found);
+			if (!got.found) {
+				continue;
+			}
+			CHECK(got.distance == Approx(expected.distance));
+			ws.path(hierarchy_path);
+			ch.unpack(hierarchy_path, path);
+			REQUIRE(path.front() == s);
+			REQUIRE(path.back() == t);
+			auto values = std::vector<int>();
+			std::transform(path.begin(), path.end(), std::back_inserter(values), [&](auto u) {
+				return view.node(u);
+			});
+			CHECK(path_weight(g, values) == Approx(expected.distance));
+		}
+	}
+}
+
+TEST_CASE("contraction hierarchy round trips through a stream") {
+	auto const g = road_like_graph(8, 42);
+	auto const ch = gdwg::contraction_hierarchy<int, double>(g);
+	auto buffer = std::stringstream();
+	ch.save(buffer);
+	auto const loaded = gdwg::contraction_hierarchy<int, double>::load(buffer);
+	CHECK(loaded.num_nodes() == ch.num_nodes());
+	CHECK(loaded.num_shortcuts() == ch.num_shortcuts());
+	CHECK(loaded.shortcut_graph() == ch.shortcut_graph());
+	for (auto s = 0; s < 64; s += 7) {
+		for (auto t = 0; t < 64; t += 5) {
+			auto const a = ch.query(s, t);
+			auto const b = loaded.query(s, t);
+			CHECK(a.found == b.found);
+			CHECK(a.distance == b.distance);
+			CHECK(a.nodes == b.nodes);
+		}
+	}
+
+	using hierarchy = gdwg::contraction_hierarchy<int, double>;
+	auto garbage = std::stringstream("not a hierarchy at all");
+	CHECK_THROWS_MATCHES(hierarchy::load(garbage),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::contraction_hierarchy<N, "
+	                                              "E>::load on a stream that doesn't hold a "
+	                                              "contraction hierarchy"));
+	auto truncated = std::stringstream(buffer.str().substr(0, 40));
+	CHECK_THROWS(hierarchy::load(truncated));
+}
@@ -0,0 +1,245 @@
+#include "gdwg/critical_path.hpp"
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: on a small plan every start and slack can be worked out by hand. On random DAGs the
+// one shot schedule is checked against a longest path computed straight from the edges, and the
+// incremental schedule must agree with a fresh one after every change, while only recomputing
+// nodes a change can reach.
+
+namespace {
+	// edges only go from smaller to larger numbers, so numeric order is a topological order
+	auto random_dag(std::mt19937& rng, int n, int m) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto weight = std::uniform_int_distribution<int>(0, 20);
+		for (auto i = 0; i < m; ++i) {
+			auto a = node(rng);
+			auto b = node(rng);
+			if (a != b) {
+				g.insert_edge(std::min(a, b), std::max(a, b), weight(rng));
+			}
+		}
+		return g;
+	}
+
+	// the longest path into every node, straight from the edges in numeric order
+	auto reference_earliest(gdwg::graph<int, int> const& g, int n) -> std::vector<int> {
+		auto ret = std::vector<int>(static_cast<std::size_t>(n), 0);
+		for (auto const& [from, to, weight] : g) {
+			auto& start = ret[static_cast<std::size_t>(to)];
+			start = std::max(start, ret[static_cast<std::size_t>(from)] + weight);
+		}
+		return ret;
+	}
+
+	auto values(gdwg::csr_graph<int, int> const& view, std::vector<gdwg::node_id> const& path)
+	   -> std::vector<int> {
+		auto ret = std::vector<int>();
+		for (auto const u : path) {
+			ret.push_back(view.node(u));
+		}
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("a small plan by hand") {
+	auto g = gdwg::graph<std::string, int>{"design", "build", "docs", "test", "ship", "party"};
+	g.insert_edge("design", "build", 5);
+	g.insert_edge("design", "docs", 5);
+	g.insert_edge("build", "test", 10);
+	g.insert_edge("docs", "ship", 3);
+	g.insert_edge("test", "ship", 4);
+	// a lag that's shorter than the one kept
+	g.insert_edge("build", "test", 2);
+	auto const view = gdwg::csr_graph<std::string, int>(g);
+	auto const result = gdwg::critical_path(view);
+	auto const at = [&](std::string const& value) { return view.id(value); };
+
+	CHECK(result.length == 19);
+	CHECK(result.earliest[at("design")] == 0);
+	CHECK(result.earliest[at("build")] == 5);
+	CHECK(result.earliest[at("docs")] == 5);
+	CHECK(result.earliest[at("test")] == 15);
+	CHECK(result.earliest[at("ship")] == 19);
+	CHECK(result.latest[at("docs")] == 16);
+	CHECK(result.slack[at("docs")] == 11);
+	CHECK(result.slack[at("test")] == 0);
+	// nothing depends on party, so it can start at 0 or as late as the end
+	CHECK(result.earliest[at("party")] == 0);
+	CHECK(result.latest[at("party")] == 19);
+	auto path = std::vector<std::string>();
+	for (auto const u : result.path) {
+		path.push_back(view.node(u));
+	}
+	CHECK(path == std::vector<std::string>{"design", "build", "test", "ship"});
+
+	// the graph overload and a snapshot without incoming edges agree
+	auto const outgoing =
+	   gdwg::critical_path(gdwg::csr_graph<std::string, int>(g, gdwg::csr_layout::outgoing));
+	CHECK(outgoing.path == result.path);
+	CHECK(gdwg::critical_path(g).slack == result.slack);
+
+	auto schedule = gdwg::incremental_critical_path<std::string, int>(g);
+	CHECK(schedule.length() == 19);
+	CHECK(schedule.path() == path);
+	// docs gets long enough to take over
+	CHECK(schedule.change_weight("docs", "ship", 3, 20));
+	CHECK(schedule.length() == 25);
+	CHECK(schedule.path() == std::vector<std::string>{"design", "docs", "ship"});
+	CHECK(schedule.slack("test") == 6);
+	CHECK(schedule.latest("party") == 25);
+	CHECK(g.find("docs", "ship", 20) != g.end());
+	// build -> test becomes the 2 already there
+	CHECK(schedule.change_weight("build", "test", 10, 2));
+	CHECK(g.find("build", "test", 10) == g.end());
+	CHECK(schedule.earliest("test") == 7);
+	CHECK_FALSE(schedule.change_weight("build", "test", 10, 3));
+	CHECK(schedule.change_weight("build", "test", 2, 2));
+	CHECK(schedule.underlying().find("build", "test", 2) != g.end());
+}
+
+TEST_CASE("random DAGs match a longest path straight from the edges") {
+	auto rng = std::mt19937(6771);
+	for (auto round = 0; round < 20; ++round) {
+		auto const g = random_dag(rng, 60, 200);
+		auto const view = gdwg::csr_graph<int, int>(g);
+		auto const result = gdwg::critical_path(view);
+		auto const expected = reference_earliest(g, 60);
+		auto length = 0;
+		for (auto u = gdwg::node_id{0}; u < view.num_nodes(); ++u) {
+			CHECK(result.earliest[u] == expected[static_cast<std::size_t>(view.node(u))]);
+			CHECK(result.slack[u] >= 0);
+			CHECK(result.slack[u] == result.latest[u] - result.earliest[u]);
+			length = std::max(length, result.earliest[u]);
+		}
+		// every edge fits between the two ends' windows
+		for (auto const& [from, to, weight] : g) {
+			CHECK(result.latest[view.id(from)] + weight <= result.latest[view.id(to)]);
+		}
+		CHECK(result.length == length);
+		REQUIRE_FALSE(result.path.empty());
+		CHECK(result.earliest[result.path.front()] == 0);
+		CHECK(result.earliest[result.path.back()] == length);
+		for (auto i = std::size_t{1}; i < result.path.size(); ++i) {
+			auto const u = result.path[i - 1];
+			auto const v = result.path[i];
+			CHECK(result.slack[u] == 0);
+			CHECK(g.find(view.node(u), view.node(v), result.earliest[v] - result.earliest[u])
+			      != g.end());
+		}
+	}
+}
+
+TEST_CASE("the incremental schedule agrees with a fresh one after every change") {
+	auto rng = std::mt19937(42);
+	auto g = random_dag(rng, 80, 300);
+	auto schedule = gdwg::incremental_critical_path<int, int>(g);
+	auto weight = std::uniform_int_distribution<int>(0, 30);
+	auto touched = std::size_t{0};
+	for (auto round = 0; round < 300; ++round) {
+		auto const edges = std::vector<gdwg::graph<int, int>::value_type>(g.begin(), g.end());
+		auto const& e = edges[std::uniform_int_distribution<std::size_t>(0, edges.size() - 1)(rng)];
+		REQUIRE(schedule.change_weight(e.from, e.to, e.weight, weight(rng)));
+		touched += schedule.last_updated();
+		auto const view = gdwg::csr_graph<int, int>(g);
+		auto const fresh = gdwg::critical_path(view);
+		REQUIRE(schedule.length() == fresh.length);
+		for (auto u = gdwg::node_id{0}; u < view.num_nodes(); ++u) {
+			REQUIRE(schedule.earliest(view.node(u)) == fresh.earliest[u]);
+			REQUIRE(schedule.latest(view.node(u)) == fresh.latest[u]);
+			REQUIRE(schedule.slack(view.node(u)) == fresh.slack[u]);
+		}
+		REQUIRE(schedule.path() == values(view, fresh.path));
+	}
+	// most changes reach far fewer nodes than the two full passes of a recompute
+	CHECK(touched < std::size_t{300} * 80);
+}
+
+TEST_CASE("only what a change reaches is recomputed") {
+	// two chains that share nothing
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 20; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i + 1 < 10; ++i) {
+		g.insert_edge(i, i + 1, 1);
+		g.insert_edge(i + 10, i + 11, 2);
+	}
+	// and a shortcut that's never the longest way to 9
+	g.insert_edge(0, 9, 1);
+	auto schedule = gdwg::incremental_critical_path<int, int>(g);
+	CHECK(schedule.length() == 18);
+	// 9 and 0 are looked at again and neither changes, so it stops there
+	CHECK(schedule.change_weight(0, 9, 1, 3));
+	CHECK(schedule.last_updated() == 2);
+	CHECK(schedule.earliest(9) == 9);
+	// 8 -> 9 reaches 9 downstream and 0 to 8 upstream
+	CHECK(schedule.change_weight(8, 9, 1, 5));
+	CHECK(schedule.last_updated() == 10);
+	CHECK(schedule.earliest(9) == 13);
+	CHECK(schedule.slack(0) == 5);
+	// a weight that stays the same recomputes nothing
+	CHECK(schedule.change_weight(15, 16, 2, 2));
+	CHECK(schedule.last_updated() == 0);
+	CHECK(schedule.change_weight(0, 1, 1, 7));
+	CHECK(schedule.last_updated() == 10);
+	CHECK(schedule.length() == 19);
+	CHECK(schedule.slack(10) == 1);
+	CHECK(schedule.path() == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+	auto const empty = gdwg::critical_path(gdwg::graph<int, int>{});
+	CHECK(empty.length == 0);
+	CHECK(empty.path.empty());
+}
+
+TEST_CASE("critical path errors") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	g.insert_edge(1, 2, 1);
+	g.insert_edge(2, 3, 1);
+	auto schedule = gdwg::incremental_critical_path<int, int>(g);
+	CHECK_THROWS_MATCHES(schedule.change_weight(1, 4, 1, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::incremental_critical_path<N, "
+	                                              "E>::change_weight on a node that doesn't exist "
+	                                              "in the graph"));
+	CHECK_THROWS_MATCHES(schedule.change_weight(1, 2, 1, -1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::incremental_critical_path<N, "
+	                                              "E>::change_weight with a negative weight"));
+	CHECK_THROWS_MATCHES(schedule.slack(0),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::incremental_critical_path<N, "
+	                                              "E>::slack on a node that doesn't exist in the "
+	                                              "graph"));
+
+	g.insert_edge(3, 1, 0);
+	CHECK_THROWS_MATCHES(gdwg::critical_path(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::critical_path on a graph that "
+	                                              "has a cycle"));
+	CHECK_THROWS_MATCHES((gdwg::incremental_critical_path<int, int>(g)),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot construct gdwg::incremental_critical_path "
+	                                              "over a graph that has a cycle"));
+	g.erase_edge(3, 1, 0);
+	g.insert_edge(1, 3, -2);
+	CHECK_THROWS_MATCHES(gdwg::critical_path(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::critical_path on a graph with "
+	                                              "negative edge weights"));
+	CHECK_THROWS_MATCHES((gdwg::incremental_critical_path<int, int>(g)),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot construct gdwg::incremental_critical_path "
+	                                              "over a graph with negative edge weights"));
+}
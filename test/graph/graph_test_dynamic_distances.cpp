@@ -0,0 +1,154 @@
+#include "gdwg/dynamic_distances.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Rationale: after every update in a random stream of inserts and erases the maintained
+// distances must equal a Bellman-Ford run from scratch. Parallel edges, zero distance changes
+// and erased sources are covered by hand, along with the touched counts that show an update
+// stayed local.
+
+namespace {
+	auto from_scratch(gdwg::graph<int, int> const& g, int source) -> std::map<int, int> {
+		auto ret = std::map<int, int>{{source, 0}};
+		for (auto changed = true; changed;) {
+			changed = false;
+			for (auto const& [from, to, weight] : g) {
+				auto const d = ret.find(from);
+				if (d == ret.end()) {
+					continue;
+				}
+				auto const it = ret.find(to);
+				if (it == ret.end() || d->second + weight < it->second) {
+					ret[to] = d->second + weight;
+					changed = true;
+				}
+			}
+		}
+		return ret;
+	}
+
+	auto check(gdwg::dynamic_distances<int, int> const& distances) -> void {
+		auto const& g = distances.underlying();
+		for (auto const source : distances.sources()) {
+			auto const expected = from_scratch(g, source);
+			for (auto const u : g.nodes()) {
+				auto const it = expected.find(u);
+				auto const want = it == expected.end() ? std::nullopt : std::optional<int>(it->second);
+				REQUIRE(distances.distance(source, u) == want);
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("dynamic distances match a recomputation after every update") {
+	auto rng = std::mt19937(6771);
+	auto constexpr n = 40;
+	auto node = std::uniform_int_distribution<int>(0, n - 1);
+	auto weight = std::uniform_int_distribution<int>(1, 5);
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < n; ++i) {
+		g.insert_node(i);
+	}
+	auto edges = std::vector<std::tuple<int, int, int>>();
+	for (auto i = 0; i < 60; ++i) {
+		auto const e = std::tuple(node(rng), node(rng), weight(rng));
+		if (g.insert_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e))) {
+			edges.push_back(e);
+		}
+	}
+	auto distances = gdwg::dynamic_distances<int, int>(g, {0, 7, 21});
+	check(distances);
+	for (auto step = 0; step < 400; ++step) {
+		if (edges.empty() || std::bernoulli_distribution(0.55)(rng)) {
+			auto const e = std::tuple(node(rng), node(rng), weight(rng));
+			if (distances.insert_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e))) {
+				edges.push_back(e);
+			}
+		}
+		else {
+			auto const i = std::uniform_int_distribution<std::size_t>(0, edges.size() - 1)(rng);
+			auto const [from, to, w] = edges[i];
+			CHECK(distances.erase_edge(from, to, w));
+			edges.erase(edges.begin() + static_cast<std::ptrdiff_t>(i));
+		}
+		check(distances);
+		CHECK(distances.last_update().changed <= distances.last_update().touched);
+	}
+}
+
+TEST_CASE("dynamic distances on a small graph") {
+	auto g = gdwg::graph<std::string, int>{"s", "a", "b", "c", "d"};
+	g.insert_edge("s", "a", 1);
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 1);
+	g.insert_edge("c", "d", 1);
+	g.insert_edge("s", "b", 2);
+	auto distances = gdwg::dynamic_distances<std::string, int>(g, {"s", "s"});
+	CHECK(distances.sources() == std::vector<std::string>{"s"});
+	CHECK(distances.distance("s", "d") == 4);
+
+	// b also gets 2 from s directly, so nothing downstream is touched
+	CHECK(distances.erase_edge("a", "b", 1));
+	CHECK(distances.last_update().touched == 1);
+	CHECK(distances.last_update().changed == 0);
+	CHECK(distances.distance("s", "d") == 4);
+
+	// a parallel edge with the same weight keeps c's distance
+	CHECK(distances.insert_edge("b", "c", 5));
+	CHECK(distances.last_update().touched == 0);
+	CHECK(distances.erase_edge("b", "c", 1));
+	CHECK(distances.distance("s", "c") == 7);
+	CHECK(distances.last_update().changed == 2);
+	CHECK(distances.insert_edge("s", "d", 1));
+	CHECK(distances.last_update().changed == 1);
+	CHECK(distances.distance("s", "d") == 1);
+
+	CHECK(distances.erase_node("b"));
+	CHECK(distances.distance("s", "c") == std::nullopt);
+	CHECK(distances.distance("s", "d") == 1);
+	CHECK(!g.is_node("b"));
+	CHECK(distances.insert_node("e"));
+	CHECK(distances.distance("s", "e") == std::nullopt);
+	CHECK(distances.insert_edge("d", "e", 2));
+	CHECK(distances.distance("s", "e") == 3);
+
+	CHECK(distances.erase_node("s"));
+	CHECK(distances.sources().empty());
+}
+
+TEST_CASE("dynamic distances errors") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	g.insert_edge(1, 2, 0);
+	CHECK_THROWS_MATCHES((gdwg::dynamic_distances<int, int>(g, {1})),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot construct gdwg::dynamic_distances over a "
+	                                              "graph with non-positive edge weights"));
+	g.replace_node(2, 3);
+	g.erase_edge(1, 3, 0);
+	CHECK_THROWS_MATCHES((gdwg::dynamic_distances<int, int>(g, {2})),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot construct gdwg::dynamic_distances from a "
+	                                              "source that doesn't exist in the graph"));
+	auto distances = gdwg::dynamic_distances<int, int>(g, {1});
+	CHECK_THROWS_MATCHES(distances.insert_edge(1, 3, -2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::dynamic_distances<N, "
+	                                              "E>::insert_edge with a non-positive weight"));
+	CHECK_THROWS_MATCHES(distances.distance(3, 1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::dynamic_distances<N, "
+	                                              "E>::distance from a node that isn't a source"));
+	CHECK_THROWS_MATCHES(distances.distance(1, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::dynamic_distances<N, "
+	                                              "E>::distance on a node that doesn't exist in the "
+	                                              "graph"));
+}
@@ -0,0 +1,140 @@
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/k_core.hpp"
+
+#include <catch2/catch.hpp>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Rationale: core numbers are checked on a small graph by hand, then against the definition on
+// random graphs for every degree mode: repeatedly drop nodes below k and see who is left. The
+// parallel version must agree with the sequential one whatever the number of threads.
+
+namespace {
+	// core[u] straight from the definition, O(k * n * e)
+	auto brute_force_cores(gdwg::csr_graph<int, int> const& view, gdwg::degree_mode mode)
+	   -> std::vector<std::size_t> {
+		auto const n = view.num_nodes();
+		auto ret = std::vector<std::size_t>(n, 0);
+		for (auto k = std::size_t{1};; ++k) {
+			auto alive = std::vector<bool>(n, true);
+			auto changed = true;
+			while (changed) {
+				changed = false;
+				auto degree = std::vector<std::size_t>(n, 0);
+				for (auto u = gdwg::node_id{0}; u < n; ++u) {
+					for (auto const v : view.out_targets(u)) {
+						if (u != v && alive[u] && alive[v]) {
+							degree[v] += mode != gdwg::degree_mode::out ? 1 : 0;
+							degree[u] += mode != gdwg::degree_mode::in ? 1 : 0;
+						}
+					}
+				}
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					if (alive[u] && degree[u] < k) {
+						alive[u] = false;
+						changed = true;
+					}
+				}
+			}
+			auto any = false;
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				if (alive[u]) {
+					ret[u] = k;
+					any = true;
+				}
+			}
+			if (!any) {
+				return ret;
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("core numbers of a small graph") {
+	// a triangle a, b, c with a tail c -> d -> e, and a parallel edge and self loop on the tail
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 1);
+	g.insert_edge("c", "a", 1);
+	g.insert_edge("c", "d", 1);
+	g.insert_edge("d", "e", 1);
+	g.insert_edge("d", "e", 2);
+	g.insert_edge("e", "e", 1);
+
+	auto const total = gdwg::core_numbers(g);
+	CHECK(total.core == std::vector<std::size_t>{2, 2, 2, 2, 2});
+	CHECK(total.degeneracy == 2);
+	auto const in = gdwg::core_numbers(g, gdwg::degree_mode::in);
+	CHECK(in.core == std::vector<std::size_t>{1, 1, 1, 1, 1});
+	auto const out = gdwg::core_numbers(g, gdwg::degree_mode::out);
+	// e only points at itself, and once it goes d points at nothing
+	CHECK(out.core == std::vector<std::size_t>{1, 1, 1, 0, 0});
+
+	auto const core = gdwg::k_core(g, 1, gdwg::degree_mode::out);
+	CHECK(core.nodes() == std::vector<std::string>{"a", "b", "c"});
+	CHECK(core.is_connected("c", "a"));
+	CHECK(!core.is_node("d"));
+	CHECK(gdwg::k_core(g, 2).nodes() == g.nodes());
+
+	CHECK(gdwg::k_core(g, 3).empty());
+	CHECK(gdwg::core_numbers(gdwg::graph<int, int>{}).degeneracy == 0);
+	CHECK(gdwg::parallel_core_numbers(gdwg::graph<int, int>{}).core.empty());
+}
+
+TEST_CASE("core numbers match the definition") {
+	for (auto round = std::size_t{0}; round < 4; ++round) {
+		auto const g = gdwg::rmat_graph({.scale = 6, .edge_factor = 2 + 3 * round, .seed = round});
+		auto const view = gdwg::csr_graph<int, int>(g);
+		using gdwg::degree_mode;
+		for (auto const mode : {degree_mode::in, degree_mode::out, degree_mode::total}) {
+			auto const expected = brute_force_cores(view, mode);
+			auto const sequential = gdwg::core_numbers(view, mode);
+			CHECK(sequential.core == expected);
+			for (auto const threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}}) {
+				auto const parallel = gdwg::parallel_core_numbers(view,
+				                                                  {.mode = mode, .threads = threads});
+				CHECK(parallel.core == expected);
+				CHECK(parallel.degeneracy == sequential.degeneracy);
+			}
+		}
+	}
+}
+
+TEST_CASE("k_core keeps every edge between core nodes") {
+	auto const g = gdwg::rmat_graph({.scale = 8, .edge_factor = 8, .max_weight = 5, .seed = 9});
+	auto const cores = gdwg::core_numbers(g);
+	auto const k = cores.degeneracy / 2;
+	auto const core = gdwg::k_core(g, k);
+	auto const nodes = g.nodes();
+	auto expected_nodes = std::vector<int>();
+	for (auto u = std::size_t{0}; u < nodes.size(); ++u) {
+		if (cores.core[u] >= k) {
+			expected_nodes.push_back(nodes[u]);
+		}
+	}
+	CHECK(core.nodes() == expected_nodes);
+	auto edges = std::size_t{0};
+	for (auto const& [from, to, weight] : g) {
+		if (core.is_node(from) && core.is_node(to)) {
+			CHECK(core.find(from, to, weight) != core.end());
+			++edges;
+		}
+	}
+	CHECK(static_cast<std::size_t>(std::distance(core.begin(), core.end())) == edges);
+}
+
+TEST_CASE("core numbers by out or total degree need incoming edges") {
+	auto const g = gdwg::graph<int, int>{1};
+	auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+	CHECK(gdwg::core_numbers(view, gdwg::degree_mode::in).core.size() == 1);
+	CHECK_THROWS_MATCHES(gdwg::core_numbers(view),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::core_numbers on a csr_graph "
+	                                              "built without incoming edges"));
+	CHECK_THROWS_MATCHES(gdwg::parallel_core_numbers(view, {.mode = gdwg::degree_mode::out}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::parallel_core_numbers on a "
+	                                              "csr_graph built without incoming edges"));
+}
@@ -0,0 +1,127 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/k_shortest_paths.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: the usual textbook example for Yen's algorithm, then random graphs where every
+// loopless path is enumerated by brute force so the k shortest distances can be compared. The
+// graph itself must come out of the queries unchanged.
+
+namespace {
+	// every loopless path from u to dst, as (distance, nodes) using the lightest parallel edge
+	auto all_paths(gdwg::csr_graph<int, int> const& view,
+	               gdwg::node_id u,
+	               gdwg::node_id dst,
+	               std::vector<gdwg::node_id>& path,
+	               int distance,
+	               std::vector<std::pair<int, std::vector<gdwg::node_id>>>& out) -> void {
+		path.push_back(u);
+		if (u == dst) {
+			out.emplace_back(distance, path);
+		}
+		else {
+			auto const targets = view.out_targets(u);
+			auto const weights = view.out_weights(u);
+			for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+				auto const lightest = i == 0 || targets[i] != targets[i - 1];
+				if (lightest && std::find(path.begin(), path.end(), targets[i]) == path.end()) {
+					all_paths(view, targets[i], dst, path, distance + weights[i], out);
+				}
+			}
+		}
+		path.pop_back();
+	}
+} // namespace
+
+TEST_CASE("k shortest paths on the textbook graph") {
+	auto g = gdwg::graph<std::string, int>{"C", "D", "E", "F", "G", "H"};
+	g.insert_edge("C", "D", 3);
+	g.insert_edge("C", "E", 2);
+	g.insert_edge("D", "F", 4);
+	g.insert_edge("E", "D", 1);
+	g.insert_edge("E", "F", 2);
+	g.insert_edge("E", "G", 3);
+	g.insert_edge("F", "G", 2);
+	g.insert_edge("F", "H", 1);
+	g.insert_edge("G", "H", 2);
+	auto const before = g;
+
+	auto const paths = gdwg::k_shortest_paths(g, std::string("C"), std::string("H"), 3);
+	REQUIRE(paths.size() == 3);
+	CHECK(paths[0].distance == 5);
+	CHECK(paths[0].nodes == std::vector<std::string>{"C", "E", "F", "H"});
+	CHECK(paths[1].distance == 7);
+	CHECK(paths[1].nodes == std::vector<std::string>{"C", "E", "G", "H"});
+	CHECK(paths[2].distance == 8);
+	CHECK((paths[2].nodes == std::vector<std::string>{"C", "D", "F", "H"}
+	       || paths[2].nodes == std::vector<std::string>{"C", "E", "D", "F", "H"}
+	       || paths[2].nodes == std::vector<std::string>{"C", "E", "F", "G", "H"}));
+	CHECK(g == before);
+
+	// there are only seven loopless paths from C to H
+	CHECK(gdwg::k_shortest_paths(g, std::string("C"), std::string("H"), 100).size() == 7);
+	CHECK(gdwg::k_shortest_paths(g, std::string("H"), std::string("C"), 3).empty());
+	auto const self = gdwg::k_shortest_paths(g, std::string("C"), std::string("C"), 3);
+	REQUIRE(self.size() == 1);
+	CHECK(self[0].nodes == std::vector<std::string>{"C"});
+}
+
+TEST_CASE("k shortest paths agree with brute force") {
+	auto rng = std::mt19937(6771);
+	for (auto round = 0; round < 30; ++round) {
+		auto constexpr n = 8;
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto weight = std::uniform_int_distribution<int>(0, 9);
+		for (auto i = 0; i < 22; ++i) {
+			g.insert_edge(node(rng), node(rng), weight(rng));
+		}
+		auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+		auto const src = static_cast<gdwg::node_id>(node(rng));
+		auto const dst = static_cast<gdwg::node_id>(node(rng));
+		auto expected = std::vector<std::pair<int, std::vector<gdwg::node_id>>>();
+		auto scratch = std::vector<gdwg::node_id>();
+		all_paths(view, src, dst, scratch, 0, expected);
+		std::sort(expected.begin(), expected.end());
+
+		auto ws = gdwg::search_workspace<int>();
+		auto const k = std::size_t{10};
+		auto const paths = gdwg::k_shortest_paths(view, src, dst, k, ws);
+		REQUIRE(paths.size() == std::min(k, expected.size()));
+		auto seen = std::set<std::vector<gdwg::node_id>>();
+		for (auto i = std::size_t{0}; i < paths.size(); ++i) {
+			CHECK(paths[i].distance == expected[i].first);
+			CHECK(paths[i].nodes.front() == src);
+			CHECK(paths[i].nodes.back() == dst);
+			CHECK(paths[i].costs.back() == paths[i].distance);
+			auto sorted = paths[i].nodes;
+			std::sort(sorted.begin(), sorted.end());
+			CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+			auto const entry = std::pair(paths[i].distance, paths[i].nodes);
+			CHECK(std::find(expected.begin(), expected.end(), entry) != expected.end());
+			CHECK(seen.insert(paths[i].nodes).second);
+		}
+	}
+}
+
+TEST_CASE("k shortest paths errors") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	g.insert_edge(1, 2, -1);
+	CHECK_THROWS_MATCHES(gdwg::k_shortest_paths(g, 1, 2, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::k_shortest_paths on a graph "
+	                                              "with negative edge weights"));
+	CHECK_THROWS_MATCHES(gdwg::k_shortest_paths(g, 1, 3, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::k_shortest_paths if src or dst "
+	                                              "node don't exist in the graph"));
+}
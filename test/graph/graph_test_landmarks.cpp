@@ -0,0 +1,226 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/landmarks.hpp"
+#include "gdwg/shortest_path.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+// Rationale: on random graphs the bounds must hold for every pair against Floyd-Warshall, a
+// pair flagged unreachable must really be, and A* guided by the landmarks must still find exact
+// distances. Both selection modes are checked on graphs where the right landmarks are obvious.
+
+namespace {
+	auto constexpr infinite = std::numeric_limits<int>::max();
+
+	auto random_graph(std::size_t seed, int n, int m) -> gdwg::graph<int, int> {
+		auto rng = std::mt19937(static_cast<unsigned>(seed));
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto weight = std::uniform_int_distribution<int>(0, 9);
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < m; ++i) {
+			g.insert_edge(node(rng), node(rng), weight(rng));
+		}
+		return g;
+	}
+
+	auto all_pairs(gdwg::csr_graph<int, int> const& g) -> std::vector<std::vector<int>> {
+		auto const n = g.num_nodes();
+		auto ret = std::vector<std::vector<int>>(n, std::vector<int>(n, infinite));
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			ret[u][u] = 0;
+			auto const targets = g.out_targets(u);
+			auto const weights = g.out_weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				ret[u][targets[k]] = std::min(ret[u][targets[k]], weights[k]);
+			}
+		}
+		for (auto k = std::size_t{0}; k < n; ++k) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				for (auto j = std::size_t{0}; j < n; ++j) {
+					if (ret[i][k] != infinite && ret[k][j] != infinite) {
+						ret[i][j] = std::min(ret[i][j], ret[i][k] + ret[k][j]);
+					}
+				}
+			}
+		}
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("landmark bounds hold for every pair") {
+	auto const selection = GENERATE(gdwg::landmark_selection::degree,
+	                                gdwg::landmark_selection::farthest);
+	auto const landmarks = GENERATE(std::size_t{1}, std::size_t{4}, std::size_t{100});
+	for (auto seed = std::size_t{0}; seed < 5; ++seed) {
+		auto const g = random_graph(seed, 30, 60);
+		auto const view = gdwg::csr_graph<int, int>(g);
+		auto const exact = all_pairs(view);
+		auto const oracle = gdwg::landmark_oracle<int, int>(view, {landmarks, selection, 3});
+		CHECK(oracle.landmarks().size() == std::min(landmarks, view.num_nodes()));
+		for (auto s = gdwg::node_id{0}; s < view.num_nodes(); ++s) {
+			for (auto t = gdwg::node_id{0}; t < view.num_nodes(); ++t) {
+				auto const b = oracle.bounds(s, t);
+				if (exact[s][t] == infinite) {
+					CHECK((!b.upper || !b.reachable));
+					continue;
+				}
+				REQUIRE(b.reachable);
+				CHECK(b.lower <= exact[s][t]);
+				if (b.upper) {
+					CHECK(exact[s][t] <= *b.upper);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("every landmark knows its own distances exactly") {
+	auto const g = random_graph(6771, 40, 120);
+	auto const view = gdwg::csr_graph<int, int>(g);
+	auto const exact = all_pairs(view);
+	auto const oracle = gdwg::landmark_oracle<int, int>(view, {.landmarks = 5});
+	for (auto const l : oracle.landmarks()) {
+		for (auto u = gdwg::node_id{0}; u < view.num_nodes(); ++u) {
+			auto const from = oracle.bounds(l, u);
+			CHECK(from.reachable == (exact[l][u] != infinite));
+			if (from.reachable) {
+				CHECK(from.lower == exact[l][u]);
+				CHECK(from.upper == exact[l][u]);
+			}
+			auto const to = oracle.bounds(u, l);
+			CHECK(to.reachable == (exact[u][l] != infinite));
+			if (to.reachable) {
+				CHECK(to.lower == exact[u][l]);
+				CHECK(to.upper == exact[u][l]);
+			}
+		}
+	}
+}
+
+TEST_CASE("landmarks guide A* to exact distances") {
+	auto const g = random_graph(42, 60, 200);
+	auto const view = gdwg::csr_graph<int, int>(g);
+	auto const exact = all_pairs(view);
+	auto const oracle = gdwg::landmark_oracle<int, int>(view, {.landmarks = 6});
+	auto ws = gdwg::search_workspace<int>(view.num_nodes());
+	auto guided = std::size_t{0};
+	auto blind = std::size_t{0};
+	for (auto s = gdwg::node_id{0}; s < view.num_nodes(); ++s) {
+		for (auto t = gdwg::node_id{0}; t < view.num_nodes(); ++t) {
+			auto const result = gdwg::astar(view, s, t, oracle.heuristic(t), ws);
+			REQUIRE(result.found == (exact[s][t] != infinite));
+			if (result.found) {
+				CHECK(result.distance == exact[s][t]);
+			}
+			guided += result.stats.settled;
+			blind += gdwg::astar(view, s, t, [](gdwg::node_id) { return 0; }, ws).stats.settled;
+		}
+	}
+	CHECK(guided < blind);
+
+	auto const path = gdwg::astar(g, 0, 59, oracle.heuristic_to(59));
+	CHECK(path.found == (exact[view.id(0)][view.id(59)] != infinite));
+	CHECK(path.distance == (path.found ? exact[view.id(0)][view.id(59)] : 0));
+}
+
+TEST_CASE("farthest selection puts a landmark in every component") {
+	// three separate directed cycles
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 15; ++i) {
+		g.insert_node(i);
+	}
+	for (auto c = 0; c < 3; ++c) {
+		for (auto i = 0; i < 5; ++i) {
+			g.insert_edge(c * 5 + i, c * 5 + (i + 1) % 5, 1);
+		}
+	}
+	// a self loop makes node 7 the start
+	g.insert_edge(7, 7, 1);
+	auto const oracle = gdwg::landmark_oracle<int, int>(g, {.landmarks = 3});
+	auto const& landmarks = oracle.landmarks();
+	REQUIRE(landmarks.size() == 3);
+	CHECK(landmarks[0] == 7);
+	auto components = std::vector<int>();
+	for (auto const l : landmarks) {
+		components.push_back(static_cast<int>(l) / 5);
+	}
+	std::sort(components.begin(), components.end());
+	CHECK(components == std::vector<int>{0, 1, 2});
+	CHECK_FALSE(oracle.bounds(0, 10).reachable);
+	CHECK(oracle.bounds(0, 4).upper == 4);
+	CHECK(oracle.bounds(0, 4).lower == 4);
+}
+
+TEST_CASE("degree selection picks the hubs") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 20; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 20; ++i) {
+		g.insert_edge(3, i, 1);
+		g.insert_edge(i, 11, 2);
+	}
+	auto const oracle = gdwg::landmark_oracle<int, int>(
+	   g,
+	   {.landmarks = 2, .selection = gdwg::landmark_selection::degree});
+	CHECK(oracle.landmarks() == std::vector<gdwg::node_id>{3, 11});
+	CHECK(oracle.bounds(5, 11).upper == 2);
+	CHECK(oracle.bounds(3, 11).lower == 1);
+	CHECK(oracle.bounds(3, 11).upper == 1);
+}
+
+TEST_CASE("landmark oracle edge cases") {
+	SECTION("an empty graph has no landmarks") {
+		auto const oracle = gdwg::landmark_oracle<int, int>(gdwg::graph<int, int>{});
+		CHECK(oracle.landmarks().empty());
+		CHECK(oracle.num_nodes() == 0);
+	}
+	SECTION("without landmarks the bounds are trivial") {
+		auto const g = random_graph(1, 10, 20);
+		auto const oracle = gdwg::landmark_oracle<int, int>(g, {.landmarks = 0});
+		auto const b = oracle.bounds(1, 2);
+		CHECK(b.reachable);
+		CHECK(b.lower == 0);
+		CHECK_FALSE(b.upper);
+		CHECK(oracle.bounds(4, 4).upper == 0);
+	}
+	SECTION("negative weights are rejected") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, -1);
+		CHECK_THROWS_MATCHES((gdwg::landmark_oracle<int, int>(g)),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot build a gdwg::landmark_oracle over a "
+		                                              "graph with negative edge weights"));
+	}
+	SECTION("a csr_graph needs incoming edges") {
+		auto const g = random_graph(1, 10, 20);
+		auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+		CHECK_THROWS_MATCHES((gdwg::landmark_oracle<int, int>(view)),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot build a gdwg::landmark_oracle over a "
+		                                              "csr_graph built without incoming edges"));
+	}
+	SECTION("missing nodes are rejected") {
+		auto const g = random_graph(1, 10, 20);
+		auto const oracle = gdwg::landmark_oracle<int, int>(g);
+		CHECK_THROWS_MATCHES(oracle.bounds(0, 10),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::landmark_oracle<N, E>::"
+		                                              "bounds if src or dst node don't exist in the "
+		                                              "graph"));
+		CHECK_THROWS_MATCHES(oracle.heuristic_to(-1),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::landmark_oracle<N, E>::"
+		                                              "heuristic_to on a node that doesn't exist in "
+		                                              "the graph"));
+	}
+}
@@ -0,0 +1,104 @@
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/louvain.hpp"
+
+#include <catch2/catch.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+// Rationale: a ring of cliques has an obvious best partition that Louvain must find, and two
+// triangles check the modularity formula by hand. On random graphs every level has to improve
+// on the one before and report the modularity its assignment really has.
+
+TEST_CASE("modularity of two triangles") {
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c", "x", "y", "z"};
+	g.insert_edge("a", "b", 1.0);
+	g.insert_edge("b", "c", 1.0);
+	g.insert_edge("c", "a", 1.0);
+	g.insert_edge("x", "y", 1.0);
+	g.insert_edge("y", "z", 1.0);
+	g.insert_edge("z", "x", 1.0);
+	g.insert_edge("c", "x", 1.0);
+	auto const view = gdwg::csr_graph<std::string, double>(g);
+	// 7 edges, each triangle holds 3 of them and has total degree 7
+	auto const expected = 2.0 * (3.0 / 7.0 - (7.0 / 14.0) * (7.0 / 14.0));
+	CHECK(gdwg::modularity(view, {0, 0, 0, 1, 1, 1}) == Approx(expected));
+	CHECK(gdwg::modularity(view, {0, 0, 0, 0, 0, 0}) == Approx(0.0).margin(1e-12));
+
+	auto const result = gdwg::louvain(g);
+	CHECK(result.community == std::vector<gdwg::community_id>{0, 0, 0, 1, 1, 1});
+	REQUIRE(!result.levels.empty());
+	CHECK(result.levels.back().communities == 2);
+	CHECK(result.levels.back().modularity == Approx(expected));
+}
+
+TEST_CASE("louvain finds a ring of cliques") {
+	auto constexpr cliques = 12;
+	auto constexpr size = 5;
+	auto g = gdwg::graph<int, double>{};
+	for (auto i = 0; i < cliques * size; ++i) {
+		g.insert_node(i);
+	}
+	for (auto c = 0; c < cliques; ++c) {
+		for (auto i = 0; i < size; ++i) {
+			for (auto j = i + 1; j < size; ++j) {
+				g.insert_edge(c * size + i, c * size + j, 1.0);
+			}
+		}
+		// one light edge to the next clique
+		g.insert_edge(c * size, ((c + 1) % cliques) * size + 1, 0.5);
+	}
+	auto const result = gdwg::louvain(g);
+	for (auto u = 0; u < cliques * size; ++u) {
+		CHECK(result.community[static_cast<std::size_t>(u)]
+		      == result.community[static_cast<std::size_t>(u / size * size)]);
+	}
+	auto const found = std::set<gdwg::community_id>(result.community.begin(),
+	                                                result.community.end());
+	CHECK(found.size() == cliques);
+}
+
+TEST_CASE("louvain levels on random graphs") {
+	for (auto seed = std::uint64_t{1}; seed <= 4; ++seed) {
+		auto const g = gdwg::rmat_graph<double>(
+		   {.scale = 9, .edge_factor = 4, .max_weight = 3, .seed = seed});
+		auto const view = gdwg::csr_graph<int, double>(g);
+		auto const result = gdwg::louvain(view);
+		REQUIRE(!result.levels.empty());
+		auto previous = -1.0;
+		auto communities = view.num_nodes() + 1;
+		for (auto const& level : result.levels) {
+			CHECK(level.modularity > previous);
+			CHECK(level.communities < communities);
+			CHECK(level.modularity == Approx(gdwg::modularity(view, level.community)));
+			auto const found = std::set<gdwg::community_id>(level.community.begin(),
+			                                                level.community.end());
+			CHECK(found.size() == level.communities);
+			CHECK(*found.rbegin() + 1 == level.communities);
+			previous = level.modularity;
+			communities = level.communities;
+		}
+		CHECK(result.community == result.levels.back().community);
+		CHECK(result.levels.back().modularity > 0.0);
+	}
+}
+
+TEST_CASE("louvain on graphs without weight and errors") {
+	auto const lonely = gdwg::louvain(gdwg::graph<int, double>{1, 2, 3});
+	CHECK(lonely.community == std::vector<gdwg::community_id>{0, 1, 2});
+	REQUIRE(lonely.levels.size() == 1);
+	CHECK(lonely.levels[0].modularity == 0.0);
+
+	auto g = gdwg::graph<int, double>{1, 2};
+	g.insert_edge(1, 2, -1.0);
+	CHECK_THROWS_MATCHES(gdwg::louvain(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::louvain on a graph with "
+	                                              "negative edge weights"));
+	auto const view = gdwg::csr_graph<int, double>(g, gdwg::csr_layout::outgoing);
+	CHECK_THROWS_MATCHES(gdwg::louvain(view),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::louvain on a csr_graph built "
+	                                              "without incoming edges"));
+}
@@ -0,0 +1,170 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/matching.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Rationale: random bipartite graphs are small enough for the largest matching and the heaviest
+// one to be found by trying every assignment of sources, both with more sources than targets
+// and the other way round so the Hungarian matrix is transposed in half the cases.
+
+namespace {
+	// workers are 0 .. sources - 1, jobs follow them
+	auto random_bipartite(int sources, int targets, int edges, int min_weight, std::mt19937& rng)
+	   -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < sources + targets; ++i) {
+			g.insert_node(i);
+		}
+		auto source = std::uniform_int_distribution<int>(0, sources - 1);
+		auto target = std::uniform_int_distribution<int>(sources, sources + targets - 1);
+		auto weight = std::uniform_int_distribution<int>(min_weight, 20);
+		for (auto i = 0; i < edges; ++i) {
+			g.insert_edge(source(rng), target(rng), weight(rng));
+		}
+		return g;
+	}
+
+	// the most pairs and the heaviest total over every way to give sources distinct targets
+	auto brute_force(gdwg::csr_graph<int, int> const& view,
+	                 gdwg::node_id u,
+	                 std::vector<char>& taken,
+	                 std::size_t pairs,
+	                 int weight,
+	                 std::size_t& most,
+	                 int& heaviest) -> void {
+		if (u == view.num_nodes()) {
+			most = std::max(most, pairs);
+			heaviest = std::max(heaviest, weight);
+			return;
+		}
+		brute_force(view, u + 1, taken, pairs, weight, most, heaviest);
+		auto const targets = view.out_targets(u);
+		auto const weights = view.out_weights(u);
+		for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+			if (taken[targets[k]] == 0) {
+				taken[targets[k]] = 1;
+				brute_force(view, u + 1, taken, pairs + 1, weight + weights[k], most, heaviest);
+				taken[targets[k]] = 0;
+			}
+		}
+	}
+
+	auto check_is_matching(gdwg::csr_graph<int, int> const& view,
+	                       gdwg::matching_result<int> const& result) -> void {
+		auto used = std::set<gdwg::node_id>();
+		auto const sources = view.edge_sources();
+		auto total = 0;
+		for (auto const k : result.edges) {
+			CHECK(used.insert(sources[k]).second);
+			CHECK(used.insert(view.targets()[k]).second);
+			total += view.weights()[k];
+		}
+		CHECK(std::is_sorted(result.edges.begin(), result.edges.end()));
+		CHECK(total == result.total_weight);
+	}
+} // namespace
+
+TEST_CASE("matchings agree with brute force") {
+	auto rng = std::mt19937(6771);
+	for (auto round = 0; round < 60; ++round) {
+		auto const sources = 2 + round % 5;
+		auto const targets = 2 + (round / 5) % 5;
+		auto const g = random_bipartite(sources, targets, 2 * (sources + targets), -5, rng);
+		auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+		auto taken = std::vector<char>(view.num_nodes(), 0);
+		auto most = std::size_t{0};
+		auto heaviest = 0;
+		brute_force(view, 0, taken, 0, 0, most, heaviest);
+
+		auto const cardinality = gdwg::hopcroft_karp(view);
+		check_is_matching(view, cardinality);
+		CHECK(cardinality.edges.size() == most);
+		auto const weighted = gdwg::hungarian(view);
+		check_is_matching(view, weighted);
+		CHECK(weighted.total_weight == heaviest);
+		for (auto const k : weighted.edges) {
+			CHECK(view.weights()[k] > 0);
+		}
+	}
+}
+
+TEST_CASE("hopcroft karp on a larger graph matches a simple augmenting path search") {
+	auto rng = std::mt19937(6771);
+	auto const g = random_bipartite(300, 250, 900, 1, rng);
+	auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+	// Kuhn's algorithm, one augmenting path search per source
+	auto const free = static_cast<gdwg::node_id>(view.num_nodes());
+	auto mate = std::vector<gdwg::node_id>(view.num_nodes(), free);
+	auto seen = std::vector<char>();
+	auto augment = [&](auto&& self, gdwg::node_id u) -> bool {
+		for (auto const v : view.out_targets(u)) {
+			if (seen[v] == 0) {
+				seen[v] = 1;
+				if (mate[v] == free || self(self, mate[v])) {
+					mate[v] = u;
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+	auto expected = std::size_t{0};
+	for (auto u = gdwg::node_id{0}; u < 300; ++u) {
+		seen.assign(view.num_nodes(), 0);
+		expected += augment(augment, u) ? 1 : 0;
+	}
+	auto const result = gdwg::hopcroft_karp(view);
+	check_is_matching(view, result);
+	CHECK(result.edges.size() == expected);
+}
+
+TEST_CASE("matching workers to jobs") {
+	auto g = gdwg::graph<std::string, int>{"ann", "bob", "cat", "build", "paint", "test"};
+	g.insert_edge("ann", "build", 9);
+	g.insert_edge("ann", "paint", 7);
+	g.insert_edge("bob", "build", 8);
+	g.insert_edge("bob", "build", 2);
+	g.insert_edge("cat", "build", 3);
+	g.insert_edge("cat", "test", -1);
+
+	auto const most = gdwg::hopcroft_karp(g);
+	auto const pairs = [](gdwg::matching<std::string, int> const& m) {
+		auto ret = std::vector<std::tuple<std::string, std::string, int>>();
+		for (auto const& [from, to, weight] : m.edges) {
+			ret.emplace_back(from, to, weight);
+		}
+		return ret;
+	};
+	using edge = std::tuple<std::string, std::string, int>;
+	CHECK(pairs(most)
+	      == std::vector<edge>{{"ann", "paint", 7}, {"bob", "build", 2}, {"cat", "test", -1}});
+
+	// ann builds for 9 or paints for 7 while bob builds for 8: 15 beats 9 + 3
+	auto const heaviest = gdwg::hungarian(g);
+	CHECK(heaviest.total_weight == 15);
+	CHECK(pairs(heaviest) == std::vector<edge>{{"ann", "paint", 7}, {"bob", "build", 8}});
+}
+
+TEST_CASE("matching errors") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	g.insert_edge(1, 2, 1);
+	g.insert_edge(2, 3, 1);
+	CHECK_THROWS_MATCHES(gdwg::hopcroft_karp(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::hopcroft_karp on a graph where "
+	                                              "a node is both a source and a target"));
+	CHECK_THROWS_MATCHES(gdwg::hungarian(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::hungarian on a graph where a "
+	                                              "node is both a source and a target"));
+	CHECK(gdwg::hopcroft_karp(gdwg::graph<int, int>{}).edges.empty());
+	CHECK(gdwg::hungarian(gdwg::graph<int, int>{1, 2}).edges.empty());
+}
@@ -0,0 +1,188 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/max_flow.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: the textbook network has a known value and cut. Random graphs are checked against a
+// plain Edmonds-Karp on a capacity matrix, and every result is checked to be a valid flow whose
+// value equals the capacity of the cut it reports, which is what makes it maximum.
+
+namespace {
+	auto edmonds_karp(gdwg::csr_graph<int, long> const& view, gdwg::node_id s, gdwg::node_id t)
+	   -> long {
+		auto const n = view.num_nodes();
+		auto capacity = std::vector<std::vector<long>>(n, std::vector<long>(n, 0));
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			auto const out = view.out_targets(u);
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				if (out[i] != u) {
+					capacity[u][out[i]] += view.out_weights(u)[i];
+				}
+			}
+		}
+		auto total = 0L;
+		while (true) {
+			auto parent = std::vector<std::size_t>(n, n);
+			parent[s] = s;
+			auto queue = std::vector<std::size_t>{s};
+			for (auto i = std::size_t{0}; i < queue.size() && parent[t] == n; ++i) {
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (parent[v] == n && capacity[queue[i]][v] > 0) {
+						parent[v] = queue[i];
+						queue.push_back(v);
+					}
+				}
+			}
+			if (parent[t] == n) {
+				return total;
+			}
+			auto bottleneck = std::numeric_limits<long>::max();
+			for (auto v = std::size_t{t}; v != s; v = parent[v]) {
+				bottleneck = std::min(bottleneck, capacity[parent[v]][v]);
+			}
+			for (auto v = std::size_t{t}; v != s; v = parent[v]) {
+				capacity[parent[v]][v] -= bottleneck;
+				capacity[v][parent[v]] += bottleneck;
+			}
+			total += bottleneck;
+		}
+	}
+
+	// capacity limits, conservation at every inner node and the cut capacity matching the value
+	auto check_flow(gdwg::csr_graph<int, long> const& view,
+	                gdwg::node_id s,
+	                gdwg::node_id t,
+	                gdwg::flow_result<long> const& result) -> void {
+		auto const n = view.num_nodes();
+		auto balance = std::vector<long>(n, 0);
+		auto cut = 0L;
+		REQUIRE(result.source_side[s]);
+		REQUIRE(!result.source_side[t]);
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			auto const out = view.out_targets(u);
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				auto const k = view.out_offset(u) + i;
+				auto const capacity = view.out_weights(u)[i];
+				REQUIRE(result.flow[k] >= 0);
+				REQUIRE(result.flow[k] <= capacity);
+				balance[u] -= result.flow[k];
+				balance[out[i]] += result.flow[k];
+				if (result.source_side[u] && !result.source_side[out[i]]) {
+					cut += capacity;
+					CHECK(result.flow[k] == capacity);
+				}
+				if (!result.source_side[u] && result.source_side[out[i]]) {
+					CHECK(result.flow[k] == 0);
+				}
+			}
+		}
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			if (u != s && u != t) {
+				CHECK(balance[u] == 0);
+			}
+		}
+		CHECK(balance[t] == result.value);
+		CHECK(cut == result.value);
+	}
+} // namespace
+
+TEST_CASE("max flow on the textbook network") {
+	auto g = gdwg::graph<std::string, long>{"s", "v1", "v2", "v3", "v4", "t"};
+	g.insert_edge("s", "v1", 16);
+	g.insert_edge("s", "v2", 13);
+	g.insert_edge("v1", "v3", 12);
+	g.insert_edge("v2", "v1", 4);
+	g.insert_edge("v2", "v4", 14);
+	g.insert_edge("v3", "v2", 9);
+	g.insert_edge("v3", "t", 20);
+	g.insert_edge("v4", "v3", 7);
+	g.insert_edge("v4", "t", 4);
+
+	auto const result = gdwg::max_flow(g, std::string("s"), std::string("t"));
+	CHECK(result.value == 23);
+	CHECK(result.source_side == std::vector<std::string>{"s", "v1", "v2", "v4"});
+	CHECK(result.sink_side == std::vector<std::string>{"t", "v3"});
+	REQUIRE(result.edges.size() == 9);
+	CHECK(result.edges.front().from == "s");
+	CHECK(result.edges.front().to == "v1");
+	CHECK(result.edges.front().capacity == 16);
+
+	auto const view = gdwg::csr_graph<std::string, long>(g);
+	auto const reverse = gdwg::max_flow(view, view.id("t"), view.id("s"));
+	CHECK(reverse.value == 0);
+	CHECK(std::all_of(reverse.flow.begin(), reverse.flow.end(), [](long f) { return f == 0; }));
+}
+
+TEST_CASE("parallel edges add up and self loops are ignored") {
+	auto g = gdwg::graph<int, long>{1, 2, 3};
+	g.insert_edge(1, 2, 3);
+	g.insert_edge(1, 2, 5);
+	g.insert_edge(2, 2, 100);
+	g.insert_edge(2, 1, 7);
+	g.insert_edge(2, 3, 6);
+	g.insert_edge(2, 3, 10);
+
+	auto const result = gdwg::max_flow(g, 1, 3);
+	CHECK(result.value == 8);
+	REQUIRE(result.edges.size() == 6);
+	// smallest capacity first among parallel edges
+	CHECK(result.edges[0].flow == 3);
+	CHECK(result.edges[1].flow == 5);
+	CHECK(result.edges[2].flow == 0);
+	CHECK(result.edges[3].flow == 0);
+	CHECK(result.edges[4].flow == 6);
+	CHECK(result.edges[5].flow == 2);
+	CHECK(result.source_side == std::vector<int>{1});
+}
+
+TEST_CASE("max flow agrees with edmonds-karp on random graphs") {
+	auto rng = std::mt19937(6771);
+	for (auto round = 0; round < 40; ++round) {
+		auto const n = 2 + round;
+		auto g = gdwg::graph<int, long>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto capacity = std::uniform_int_distribution<long>(0, 20);
+		for (auto i = 0; i < 4 * n; ++i) {
+			g.insert_edge(node(rng), node(rng), capacity(rng));
+		}
+		auto const view = gdwg::csr_graph<int, long>(g);
+		auto const s = static_cast<gdwg::node_id>(node(rng));
+		auto t = static_cast<gdwg::node_id>(node(rng));
+		if (s == t) {
+			t = static_cast<gdwg::node_id>((t + 1) % static_cast<gdwg::node_id>(n));
+		}
+		auto const result = gdwg::max_flow(view, s, t);
+		CHECK(result.value == edmonds_karp(view, s, t));
+		check_flow(view, s, t, result);
+	}
+}
+
+TEST_CASE("max flow errors") {
+	auto g = gdwg::graph<int, long>{1, 2};
+	g.insert_edge(1, 2, -1);
+	CHECK_THROWS_MATCHES(gdwg::max_flow(g, 1, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::max_flow on a graph with "
+	                                              "negative edge weights"));
+	CHECK_THROWS_MATCHES(gdwg::max_flow(g, 1, 3),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::max_flow if src or dst node "
+	                                              "don't exist in the graph"));
+	CHECK_THROWS_MATCHES(gdwg::max_flow(g, 1, 1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::max_flow with the same source "
+	                                              "and sink"));
+	auto const view = gdwg::csr_graph<int, long>(g, gdwg::csr_layout::outgoing);
+	CHECK_THROWS_MATCHES(gdwg::max_flow(view, 0, 1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::max_flow on a csr_graph built "
+	                                              "without incoming edges"));
+}
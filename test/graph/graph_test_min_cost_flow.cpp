@@ -0,0 +1,280 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/max_flow.hpp"
+#include "gdwg/min_cost_flow.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: small random networks, parallel edges and negative costs included, are solved by
+// trying every integral flow on every edge, for the full value and for smaller limits. Larger
+// ones must carry the maximum flow and leave no negative cycle in the residual network, which
+// is what makes a flow of that value cheapest.
+
+namespace {
+	using capacity_cost = std::pair<int, int>;
+	using view_type = gdwg::csr_graph<int, capacity_cost>;
+
+	struct best_flow {
+		int value = 0;
+		int cost = 0;
+	};
+
+	// the largest value up to limit and the least cost of a flow with that value
+	auto brute_force(view_type const& view, gdwg::node_id s, gdwg::node_id t, int limit)
+	   -> best_flow {
+		auto const sources = view.edge_sources();
+		auto const m = view.num_edges();
+		auto flow = std::vector<int>(m, 0);
+		auto ret = std::optional<best_flow>();
+		auto const check = [&] {
+			auto balance = std::vector<int>(view.num_nodes(), 0);
+			auto cost = 0;
+			for (auto k = std::size_t{0}; k < m; ++k) {
+				balance[sources[k]] -= flow[k];
+				balance[view.targets()[k]] += flow[k];
+				cost += flow[k] * view.weights()[k].second;
+			}
+			for (auto u = gdwg::node_id{0}; u < view.num_nodes(); ++u) {
+				if (u != s && u != t && balance[u] != 0) {
+					return;
+				}
+			}
+			auto const value = balance[t];
+			if (value < 0 || value > limit) {
+				return;
+			}
+			if (!ret || value > ret->value || (value == ret->value && cost < ret->cost)) {
+				ret = best_flow{value, cost};
+			}
+		};
+		auto const search = [&](auto&& self, std::size_t k) -> void {
+			if (k == m) {
+				check();
+				return;
+			}
+			for (flow[k] = 0; flow[k] <= view.weights()[k].first; ++flow[k]) {
+				self(self, k + 1);
+			}
+			flow[k] = 0;
+		};
+		search(search, 0);
+		return *ret;
+	}
+
+	// every flow within its capacity, conserved at inner nodes and adding up to value and cost
+	auto check_flow(view_type const& view,
+	                gdwg::node_id s,
+	                gdwg::node_id t,
+	                gdwg::min_cost_flow_result<int, int> const& result) -> void {
+		auto const sources = view.edge_sources();
+		auto balance = std::vector<int>(view.num_nodes(), 0);
+		auto cost = 0;
+		REQUIRE(result.flow.size() == view.num_edges());
+		for (auto k = std::size_t{0}; k < view.num_edges(); ++k) {
+			auto const [capacity, unit] = view.weights()[k];
+			REQUIRE(result.flow[k] >= 0);
+			REQUIRE(result.flow[k] <= capacity);
+			balance[sources[k]] -= result.flow[k];
+			balance[view.targets()[k]] += result.flow[k];
+			cost += result.flow[k] * unit;
+		}
+		for (auto u = gdwg::node_id{0}; u < view.num_nodes(); ++u) {
+			if (u != s && u != t) {
+				REQUIRE(balance[u] == 0);
+			}
+		}
+		CHECK(balance[t] == result.value);
+		CHECK(cost == result.cost);
+	}
+
+	// Bellman-Ford over the residual network, a flow of its value is cheapest exactly when no
+	// cycle there has negative cost
+	auto has_negative_residual_cycle(view_type const& view,
+	                                  gdwg::min_cost_flow_result<int, int> const& result) -> bool {
+		auto const sources = view.edge_sources();
+		struct arc {
+			gdwg::node_id from;
+			gdwg::node_id to;
+			int cost;
+		};
+		auto arcs = std::vector<arc>();
+		for (auto k = std::size_t{0}; k < view.num_edges(); ++k) {
+			auto const [capacity, unit] = view.weights()[k];
+			if (result.flow[k] < capacity) {
+				arcs.push_back({sources[k], view.targets()[k], unit});
+			}
+			if (result.flow[k] > 0) {
+				arcs.push_back({view.targets()[k], sources[k], -unit});
+			}
+		}
+		auto dist = std::vector<long>(view.num_nodes(), 0);
+		for (auto round = std::size_t{0}; round <= view.num_nodes(); ++round) {
+			auto changed = false;
+			for (auto const& a : arcs) {
+				if (dist[a.from] + a.cost < dist[a.to]) {
+					dist[a.to] = dist[a.from] + a.cost;
+					changed = true;
+				}
+			}
+			if (!changed) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// edges only go from lower to higher nodes when acyclic, otherwise negative costs make for
+	// negative cycles
+	auto random_network(std::mt19937& rng, int n, int m, int max_capacity, bool acyclic)
+	   -> gdwg::graph<int, capacity_cost> {
+		auto g = gdwg::graph<int, capacity_cost>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto capacity = std::uniform_int_distribution<int>(0, max_capacity);
+		auto cost = std::uniform_int_distribution<int>(-5, 9);
+		for (auto i = 0; i < m; ++i) {
+			auto from = node(rng);
+			auto to = node(rng);
+			if (acyclic && from > to) {
+				std::swap(from, to);
+			}
+			g.insert_edge(from, to, {capacity(rng), cost(rng)});
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("min cost flow agrees with brute force on small networks") {
+	auto rng = std::mt19937(6771);
+	for (auto round = 0; round < 120; ++round) {
+		auto const acyclic = round % 2 == 1;
+		auto const g = random_network(rng, 4 + round % 2, 7, 3, acyclic);
+		auto const view = view_type(g, gdwg::csr_layout::outgoing);
+		auto const s = gdwg::node_id{0};
+		auto const t = static_cast<gdwg::node_id>(view.num_nodes() - 1);
+		auto const full = gdwg::min_cost_flow(view, s, t);
+		auto const expected = brute_force(view, s, t, std::numeric_limits<int>::max());
+		CHECK(full.value == expected.value);
+		CHECK(full.cost == expected.cost);
+		check_flow(view, s, t, full);
+		for (auto limit = 0; limit < full.value; ++limit) {
+			auto const limited = gdwg::min_cost_flow(view, s, t, limit);
+			auto const cheapest = brute_force(view, s, t, limit);
+			CHECK(limited.value == limit);
+			CHECK(limited.cost == cheapest.cost);
+			check_flow(view, s, t, limited);
+		}
+	}
+}
+
+TEST_CASE("min cost flow carries the maximum flow as cheaply as possible") {
+	auto rng = std::mt19937(42);
+	for (auto round = 0; round < 30; ++round) {
+		auto const acyclic = round % 3 == 0;
+		auto const n = 10 + 3 * round;
+		auto const g = random_network(rng, n, 5 * n, 20, acyclic);
+		auto const view = view_type(g, gdwg::csr_layout::outgoing);
+		auto const s = gdwg::node_id{0};
+		auto const t = static_cast<gdwg::node_id>(n - 1);
+		auto const result = gdwg::min_cost_flow(view, s, t);
+		check_flow(view, s, t, result);
+		CHECK_FALSE(has_negative_residual_cycle(view, result));
+
+		// max_flow wants plain capacities, parallel edges add up there all the same
+		auto capacities = gdwg::graph<int, long>{};
+		for (auto i = 0; i < n; ++i) {
+			capacities.insert_node(i);
+		}
+		for (auto const& [from, to, weight] : g) {
+			capacities.insert_edge(from, to, weight.first);
+		}
+		CHECK(result.value == gdwg::max_flow(capacities, 0, n - 1).value);
+	}
+}
+
+TEST_CASE("parallel edges are separate arcs") {
+	auto g = gdwg::graph<std::string, capacity_cost>{"s", "a", "t"};
+	g.insert_edge("s", "a", {2, 5});
+	g.insert_edge("s", "a", {3, 1});
+	g.insert_edge("a", "t", {4, 0});
+	g.insert_edge("a", "a", {9, -9});
+	g.insert_edge("s", "t", {1, 10});
+
+	auto const cheap = gdwg::min_cost_flow(g, std::string("s"), std::string("t"), 3);
+	CHECK(cheap.value == 3);
+	CHECK(cheap.cost == 3 - 81);
+	auto const full = gdwg::min_cost_flow(g, std::string("s"), std::string("t"));
+	CHECK(full.value == 5);
+	// the self loop pays to be saturated whatever else flows
+	CHECK(full.cost == 3 * 1 + 1 * 5 + 1 * 10 - 9 * 9);
+	REQUIRE(full.edges.size() == 5);
+	// graph iterator order: a -> a, a -> t, s -> a (2, 5), s -> a (3, 1), s -> t
+	CHECK(full.edges[0].flow == 9);
+	CHECK(full.edges[1].flow == 4);
+	CHECK(full.edges[2].weight == capacity_cost{2, 5});
+	CHECK(full.edges[2].flow == 1);
+	CHECK(full.edges[3].flow == 3);
+	CHECK(full.edges[4].flow == 1);
+}
+
+TEST_CASE("flow goes round negative cycles off the path") {
+	auto g = gdwg::graph<int, capacity_cost>{1, 2, 3};
+	g.insert_edge(1, 2, {1, 1});
+	g.insert_edge(2, 3, {2, -3});
+	g.insert_edge(3, 2, {1, 1});
+	auto const result = gdwg::min_cost_flow(g, 1, 3);
+	CHECK(result.value == 1);
+	CHECK(result.cost == 1 - 3 * 2 + 1);
+	REQUIRE(result.edges.size() == 3);
+	CHECK(result.edges[0].flow == 1);
+	CHECK(result.edges[1].flow == 2);
+	CHECK(result.edges[2].flow == 1);
+	// even with nothing to send
+	CHECK(gdwg::min_cost_flow(g, 1, 3, 0).cost == -3 + 1);
+}
+
+TEST_CASE("a projection reads capacity and cost from any weight") {
+	struct capacity_times_distance {
+		auto capacity(double w) const -> double {
+			return w;
+		}
+		auto cost(double w) const -> long {
+			return static_cast<long>(w * 10);
+		}
+	};
+	auto g = gdwg::graph<int, double>{1, 2, 3};
+	g.insert_edge(1, 2, 1.5);
+	g.insert_edge(2, 3, 2.5);
+	g.insert_edge(1, 3, 0.5);
+	auto const result = gdwg::min_cost_flow(g, 1, 3, 10.0, capacity_times_distance{});
+	CHECK(result.value == Approx(2.0));
+	// fractional flows make the total cost fractional too
+	CHECK(result.cost == Approx(0.5 * 5 + 1.5 * 40));
+}
+
+TEST_CASE("min cost flow errors") {
+	auto g = gdwg::graph<int, capacity_cost>{1, 2, 3};
+	g.insert_edge(1, 2, {-1, 0});
+	CHECK_THROWS_MATCHES(gdwg::min_cost_flow(g, 1, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::min_cost_flow on a graph with "
+	                                              "negative capacities"));
+	CHECK_THROWS_MATCHES(gdwg::min_cost_flow(g, 1, 4),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::min_cost_flow if src or dst "
+	                                              "node don't exist in the graph"));
+	CHECK_THROWS_MATCHES(gdwg::min_cost_flow(g, 1, 1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::min_cost_flow with the same "
+	                                              "source and sink"));
+}
@@ -95,6 +95,47 @@ TEST_CASE("insert edge") {
 	}
 }
 
+TEST_CASE("insert edges") {
+	SECTION("check throw") {
+		auto grap = gdwg::graph<int, int>{1, 2};
+		auto const edges = std::vector<gdwg::graph<int, int>::value_type>{{1, 2, 3}, {1, 20, 3}};
+		CHECK_THROWS_MATCHES(grap.insert_edges(edges.begin(), edges.end()),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::insert_edges "
+		                                              "when either src or dst node does not exist"));
+		// the edges before the bad one are kept
+		CHECK(grap.is_connected(1, 2));
+	}
+
+	SECTION("insert sorted and unsorted edges") {
+		auto grap = gdwg::graph<int, int>{1, 2, 3};
+		auto const sorted = std::vector<gdwg::graph<int, int>::value_type>{{1, 1, 2},
+		                                                                   {1, 2, 3},
+		                                                                   {1, 2, 4},
+		                                                                   {1, 3, 4},
+		                                                                   {2, 3, 5}};
+		CHECK(grap.insert_edges(sorted.begin(), sorted.end()) == 5);
+
+		auto expected = gdwg::graph<int, int>{1, 2, 3};
+		CHECK(expected.insert_edge(2, 3, 5));
+		CHECK(expected.insert_edge(1, 3, 4));
+		CHECK(expected.insert_edge(1, 1, 2));
+		CHECK(expected.insert_edge(1, 2, 4));
+		CHECK(expected.insert_edge(1, 2, 3));
+		CHECK(grap == expected);
+
+		// duplicates are skipped, the rest still go in wherever they belong
+		auto const unsorted = std::vector<gdwg::graph<int, int>::value_type>{{3, 1, 1},
+		                                                                     {1, 2, 3},
+		                                                                     {2, 1, 1},
+		                                                                     {3, 1, 1}};
+		CHECK(grap.insert_edges(unsorted.begin(), unsorted.end()) == 2);
+		CHECK(grap.weights(3, 1) == std::vector<int>{1});
+		CHECK(grap.weights(2, 1) == std::vector<int>{1});
+		CHECK(grap.weights(1, 2) == std::vector<int>{3, 4});
+	}
+}
+
 TEST_CASE("replace node") {
 	SECTION("check throw") {
 		auto grap = gdwg::graph<int, int>{1, 2};
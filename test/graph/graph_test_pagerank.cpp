@@ -0,0 +1,100 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/pagerank.hpp"
+
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: a symmetric graph has a known answer, and a random graph with dangling nodes is
+// checked against a straightforward single threaded power iteration for several thread counts.
+
+namespace {
+	auto reference_pagerank(gdwg::graph<int, int> const& g, double damping, int iterations)
+	   -> std::vector<double> {
+		auto const nodes = g.nodes();
+		auto const n = nodes.size();
+		auto out_degree = std::vector<double>(n, 0.0);
+		for (auto const& [from, to, weight] : g) {
+			out_degree[static_cast<std::size_t>(from)] += 1.0;
+		}
+		auto rank = std::vector<double>(n, 1.0 / static_cast<double>(n));
+		for (auto i = 0; i < iterations; ++i) {
+			auto dangling = 0.0;
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				if (out_degree[u] == 0.0) {
+					dangling += rank[u];
+				}
+			}
+			auto next = std::vector<double>(n, (1.0 - damping + damping * dangling)
+			                                      / static_cast<double>(n));
+			for (auto const& [from, to, weight] : g) {
+				auto const f = static_cast<std::size_t>(from);
+				next[static_cast<std::size_t>(to)] += damping * rank[f] / out_degree[f];
+			}
+			rank = next;
+		}
+		return rank;
+	}
+} // namespace
+
+TEST_CASE("pagerank on a cycle is uniform") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 1);
+	g.insert_edge("c", "d", 1);
+	g.insert_edge("d", "a", 1);
+	auto const result = gdwg::pagerank(g);
+	CHECK(result.converged);
+	CHECK(result.iterations == result.residuals.size());
+	for (auto const r : result.rank) {
+		CHECK(r == Approx(0.25));
+	}
+}
+
+TEST_CASE("pagerank handles an empty graph and bad options") {
+	auto const empty = gdwg::pagerank(gdwg::graph<int, int>{});
+	CHECK(empty.rank.empty());
+	CHECK(empty.converged);
+
+	auto const g = gdwg::graph<int, int>{1, 2};
+	CHECK_THROWS_MATCHES(gdwg::pagerank(g, {.damping = 1.5}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::pagerank with a damping factor "
+	                                              "outside [0, 1]"));
+	auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+	CHECK_THROWS_MATCHES(gdwg::pagerank(view),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::pagerank on a csr_graph built "
+	                                              "without incoming edges"));
+}
+
+TEST_CASE("pagerank matches a reference power iteration") {
+	auto rng = std::mt19937(6771);
+	auto g = gdwg::graph<int, int>{};
+	auto constexpr n = 300;
+	for (auto i = 0; i < n; ++i) {
+		g.insert_node(i);
+	}
+	// the last 30 nodes never get outgoing edges
+	auto src = std::uniform_int_distribution<int>(0, n - 31);
+	auto dst = std::uniform_int_distribution<int>(0, n - 1);
+	for (auto i = 0; i < 3000; ++i) {
+		g.insert_edge(src(rng), dst(rng), i % 3);
+	}
+	auto const expected = reference_pagerank(g, 0.85, 200);
+	for (auto const threads : {1, 2, 3, 8}) {
+		auto const result = gdwg::pagerank(g,
+		                                   {.damping = 0.85,
+		                                    .tolerance = 1e-12,
+		                                    .max_iterations = 200,
+		                                    .threads = static_cast<std::size_t>(threads)});
+		CHECK(result.converged);
+		CHECK(std::accumulate(result.rank.begin(), result.rank.end(), 0.0) == Approx(1.0));
+		CHECK(result.residuals.back() < 1e-12);
+		for (auto u = std::size_t{0}; u < expected.size(); ++u) {
+			CHECK(result.rank[u] == Approx(expected[u]).epsilon(1e-6));
+		}
+	}
+}
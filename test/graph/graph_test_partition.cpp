@@ -0,0 +1,185 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/partition.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Rationale: whatever the graph, every node must get a part below k, no part may go over its
+// share by more than the imbalance allowed, and the cut reported must be the cut of the parts
+// returned. On graphs made of k dense clusters joined by a few light edges, the partitioner has
+// to find the clusters, and it must give the same answer on any number of threads.
+
+namespace {
+	using view_type = gdwg::csr_graph<int, int>;
+
+	// clusters of size nodes, densely linked inside and by few light edges to the next cluster
+	auto clustered(std::mt19937& rng, int clusters, int size) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < clusters * size; ++i) {
+			g.insert_node(i);
+		}
+		auto pick = std::uniform_int_distribution<int>(0, size - 1);
+		for (auto c = 0; c < clusters; ++c) {
+			for (auto i = 0; i < size * 4; ++i) {
+				g.insert_edge(c * size + pick(rng), c * size + pick(rng), 5);
+			}
+			// every node in at least one edge of its own cluster
+			for (auto i = 0; i < size; ++i) {
+				g.insert_edge(c * size + i, c * size + (i + 1) % size, 5);
+			}
+			g.insert_edge(c * size + pick(rng), (c + 1) % clusters * size + pick(rng), 1);
+		}
+		return g;
+	}
+
+	auto random_graph(std::mt19937& rng, int n, int m) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto weight = std::uniform_int_distribution<int>(0, 9);
+		for (auto i = 0; i < m; ++i) {
+			g.insert_edge(node(rng), node(rng), weight(rng));
+		}
+		return g;
+	}
+
+	auto check_result(view_type const& view,
+	                  gdwg::partition_result const& result,
+	                  std::size_t k,
+	                  double imbalance) -> void {
+		REQUIRE(result.part.size() == view.num_nodes());
+		REQUIRE(result.sizes.size() == k);
+		auto sizes = std::vector<std::size_t>(k, 0);
+		for (auto const p : result.part) {
+			REQUIRE(p < k);
+			++sizes[p];
+		}
+		CHECK(sizes == result.sizes);
+		auto const limit = std::ceil((1.0 + imbalance) * static_cast<double>(view.num_nodes())
+		                             / static_cast<double>(k));
+		for (auto const size : sizes) {
+			CHECK(static_cast<double>(size) <= limit);
+		}
+		CHECK(result.cut == Approx(gdwg::edge_cut(view, result.part)));
+	}
+} // namespace
+
+TEST_CASE("parts are balanced and the cut is the cut of the parts") {
+	auto rng = std::mt19937(6771);
+	auto const g = random_graph(rng, 3000, 12000);
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	for (auto const k : {2U, 3U, 8U, 17U}) {
+		for (auto const imbalance : {0.0, 0.03, 0.2}) {
+			auto const result = gdwg::multilevel_partition(view, k, {.imbalance = imbalance});
+			check_result(view, result, k, imbalance);
+			CHECK(result.levels > 1);
+		}
+	}
+	// a random split cuts about (k - 1) / k of the weight, a partitioner does much better
+	auto total = 0.0;
+	for (auto const w : view.weights()) {
+		total += w;
+	}
+	CHECK(gdwg::multilevel_partition(view, 2).cut < total * 0.4);
+}
+
+TEST_CASE("clusters are found") {
+	auto rng = std::mt19937(42);
+	auto const g = clustered(rng, 8, 200);
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	auto const result = gdwg::multilevel_partition(view, 8);
+	check_result(view, result, 8, 0.03);
+	// only the eight light edges between clusters are cut
+	CHECK(result.cut == 8.0);
+	for (auto c = 0; c < 8; ++c) {
+		auto const first = result.part[view.id(c * 200)];
+		for (auto i = 1; i < 200; ++i) {
+			CHECK(result.part[view.id(c * 200 + i)] == first);
+		}
+	}
+	// the graph overload reads the same snapshot
+	CHECK(gdwg::multilevel_partition(g, 8).part == result.part);
+}
+
+TEST_CASE("nodes without edges even out the parts") {
+	auto rng = std::mt19937(3);
+	auto g = clustered(rng, 3, 100);
+	for (auto i = 300; i < 700; ++i) {
+		g.insert_node(i);
+	}
+	g.insert_edge(650, 650, 7);
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	// the three clusters fit in three of the four parts and nothing needs cutting between them
+	auto const result = gdwg::multilevel_partition(view, 4, {.imbalance = 0.0});
+	check_result(view, result, 4, 0.0);
+	CHECK(result.sizes == std::vector<std::size_t>(4, 175));
+	CHECK(result.cut == 3.0);
+}
+
+TEST_CASE("the partition doesn't depend on the number of threads") {
+	auto rng = std::mt19937(7);
+	auto const g = random_graph(rng, 5000, 20000);
+	auto const view = view_type(g);
+	auto const one = gdwg::multilevel_partition(view, 6, {.threads = 1});
+	for (auto const threads : {2U, 3U, 8U}) {
+		auto const many = gdwg::multilevel_partition(view, 6, {.threads = threads});
+		CHECK(many.part == one.part);
+		CHECK(many.cut == one.cut);
+	}
+	// a different seed can find a different partition, but just as valid
+	check_result(view, gdwg::multilevel_partition(view, 6, {.seed = 1}), 6, 0.03);
+}
+
+TEST_CASE("small and degenerate inputs") {
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 2.5);
+	g.insert_edge("b", "a", 2.5);
+	g.insert_edge("c", "d", 1.0);
+	g.insert_edge("a", "a", 100.0);
+	auto const view = gdwg::csr_graph<std::string, double>(g, gdwg::csr_layout::outgoing);
+
+	auto const whole = gdwg::multilevel_partition(view, 1);
+	CHECK(whole.part == std::vector<gdwg::part_id>(4, 0));
+	CHECK(whole.cut == 0.0);
+	CHECK(whole.sizes == std::vector<std::size_t>{4});
+
+	// a and b are joined by both directions, self loops are never cut
+	auto const halves = gdwg::multilevel_partition(view, 2);
+	CHECK(halves.cut == 0.0);
+	CHECK(halves.part[view.id("a")] == halves.part[view.id("b")]);
+	CHECK(halves.part[view.id("c")] == halves.part[view.id("d")]);
+	CHECK(halves.sizes == std::vector<std::size_t>{2, 2});
+
+	// more parts than nodes leaves some empty
+	auto const many = gdwg::multilevel_partition(view, 6);
+	CHECK(std::set<gdwg::part_id>(many.part.begin(), many.part.end()).size() == 4);
+	CHECK(many.cut == 6.0);
+
+	auto const empty = gdwg::multilevel_partition(gdwg::graph<int, int>{}, 3);
+	CHECK(empty.part.empty());
+	CHECK(empty.cut == 0.0);
+	CHECK(empty.sizes == std::vector<std::size_t>(3, 0));
+}
+
+TEST_CASE("partition errors") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	g.insert_edge(1, 2, 1);
+	CHECK_THROWS_MATCHES(gdwg::multilevel_partition(g, 0),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::multilevel_partition with no "
+	                                              "parts"));
+	g.insert_edge(2, 1, -1);
+	CHECK_THROWS_MATCHES(gdwg::multilevel_partition(g, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::multilevel_partition on a "
+	                                              "graph with negative edge weights"));
+}
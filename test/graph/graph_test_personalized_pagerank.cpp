@@ -0,0 +1,245 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/personalized_pagerank.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: push leaves rank + sum of residual * (scores from each node) equal to the true
+// scores, so against a dense power iteration the rank never overshoots and the L1 gap is exactly
+// the residual reported. The index must return what a fresh push over the modified graph
+// returns, while keeping results whose touched nodes a modification missed.
+
+namespace {
+	using view_type = gdwg::csr_graph<int, int>;
+
+	// scores personalised to seed, a dangling node's mass going back to seed
+	auto reference(view_type const& view, gdwg::node_id seed, double damping)
+	   -> std::vector<double> {
+		auto const n = view.num_nodes();
+		auto rank = std::vector<double>(n, 0.0);
+		rank[seed] = 1.0;
+		for (auto i = 0; i < 2000; ++i) {
+			auto next = std::vector<double>(n, 0.0);
+			next[seed] = 1.0 - damping;
+			for (auto u = gdwg::node_id{0}; u < n; ++u) {
+				auto const targets = view.out_targets(u);
+				if (targets.empty()) {
+					next[seed] += damping * rank[u];
+					continue;
+				}
+				for (auto const v : targets) {
+					next[v] += damping * rank[u] / static_cast<double>(targets.size());
+				}
+			}
+			rank = next;
+		}
+		return rank;
+	}
+
+	auto random_graph(std::mt19937& rng, int n, int m) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		for (auto i = 0; i < m; ++i) {
+			g.insert_edge(node(rng), node(rng), i % 3);
+		}
+		return g;
+	}
+
+	auto dense(gdwg::personalized_pagerank_result const& result, std::size_t n)
+	   -> std::vector<double> {
+		auto ret = std::vector<double>(n, 0.0);
+		for (auto i = std::size_t{0}; i < result.nodes.size(); ++i) {
+			ret[result.nodes[i]] = result.rank[i];
+		}
+		return ret;
+	}
+
+	// what the index should say about seed, computed from scratch
+	auto fresh(gdwg::graph<int, int> const& g,
+	           int seed,
+	           gdwg::personalized_pagerank_options const& options)
+	   -> std::vector<std::pair<int, double>> {
+		auto const view = view_type(g, gdwg::csr_layout::outgoing);
+		auto const result = gdwg::personalized_pagerank(view, view.id(seed), options);
+		auto ret = std::vector<std::pair<int, double>>();
+		for (auto i = std::size_t{0}; i < result.nodes.size(); ++i) {
+			ret.emplace_back(view.node(result.nodes[i]), result.rank[i]);
+		}
+		std::sort(ret.begin(), ret.end(), [](auto const& a, auto const& b) {
+			return a.second > b.second || (a.second == b.second && a.first < b.first);
+		});
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("push stays below the true scores by exactly the residual") {
+	auto rng = std::mt19937(6771);
+	// a few nodes without outgoing edges and plenty of parallel edges and self loops
+	auto const g = random_graph(rng, 60, 150);
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	auto ws = gdwg::personalized_pagerank_workspace();
+	auto result = gdwg::personalized_pagerank_result{};
+	for (auto const tolerance : {1e-2, 1e-4, 1e-8}) {
+		for (auto seed = gdwg::node_id{0}; seed < view.num_nodes(); seed += 7) {
+			auto const options = gdwg::personalized_pagerank_options{0.85, tolerance};
+			gdwg::personalized_pagerank(view, seed, options, ws, result);
+			auto const expected = reference(view, seed, 0.85);
+			auto const got = dense(result, view.num_nodes());
+			auto gap = 0.0;
+			for (auto u = std::size_t{0}; u < expected.size(); ++u) {
+				CHECK(got[u] <= expected[u] + 1e-12);
+				gap += expected[u] - got[u];
+			}
+			CHECK(gap == Approx(result.residual).margin(1e-9));
+			CHECK(static_cast<double>(result.pushes) <= 1.0 / (0.15 * tolerance));
+			CHECK(std::is_sorted(result.nodes.begin(), result.nodes.end()));
+			if (tolerance == 1e-8) {
+				CHECK(result.residual < 1e-5);
+			}
+		}
+	}
+}
+
+TEST_CASE("push stays local") {
+	// a long path, only the start of which holds any mass worth pushing
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 10000; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i + 1 < 10000; ++i) {
+		g.insert_edge(i, i + 1, 1);
+	}
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	auto const result = gdwg::personalized_pagerank(view, 0, {.damping = 0.5, .tolerance = 1e-3});
+	CHECK(result.nodes.size() < 20);
+	CHECK(result.rank[0] == Approx(0.5));
+	CHECK(result.rank[1] == Approx(0.25));
+}
+
+TEST_CASE("the index agrees with a fresh push after every modification") {
+	auto rng = std::mt19937(42);
+	auto g = random_graph(rng, 40, 90);
+	auto const options = gdwg::personalized_pagerank_options{0.85, 1e-4};
+	auto index = gdwg::personalized_pagerank_index<int, int>(g, {options, 8});
+	auto node = std::uniform_int_distribution<int>(0, 49);
+	auto action = std::uniform_int_distribution<int>(0, 9);
+	auto next = 40;
+	for (auto round = 0; round < 300; ++round) {
+		auto const a = node(rng);
+		auto const b = node(rng);
+		switch (action(rng)) {
+		case 0:
+			index.insert_node(next++);
+			break;
+		case 1:
+			index.erase_node(a);
+			break;
+		case 2:
+		case 3: {
+			auto const edges = std::vector<gdwg::graph<int, int>::value_type>(g.begin(), g.end());
+			if (!edges.empty()) {
+				auto const& e = edges[static_cast<std::size_t>(a) % edges.size()];
+				CHECK(index.erase_edge(e.from, e.to, e.weight));
+			}
+			break;
+		}
+		default:
+			if (g.is_node(a) && g.is_node(b)) {
+				index.insert_edge(a, b, round % 4);
+			}
+		}
+		for (auto const seed : {a, b, 3}) {
+			if (g.is_node(seed)) {
+				REQUIRE(index.rank(seed) == fresh(g, seed, options));
+			}
+		}
+	}
+	CHECK(index.hits() > 0);
+	CHECK(index.misses() > 0);
+}
+
+TEST_CASE("the index keeps results a modification doesn't touch") {
+	// two separate cycles
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "x", "y"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 1);
+	g.insert_edge("c", "a", 1);
+	g.insert_edge("x", "y", 1);
+	g.insert_edge("y", "x", 1);
+	auto index = gdwg::personalized_pagerank_index<std::string, int>(g, {.capacity = 2});
+	auto const scores = index.rank("a");
+	REQUIRE(scores.size() == 3);
+	CHECK(scores[0].first == "a");
+	CHECK(index.misses() == 1);
+	CHECK(index.rank("a") == scores);
+	CHECK(index.hits() == 1);
+
+	// nothing a reaches changes
+	index.insert_edge("x", "x", 2);
+	index.insert_node("z");
+	index.insert_edge("z", "a", 1);
+	CHECK(index.rank("a") == scores);
+	CHECK(index.hits() == 2);
+
+	// y's result touched x, whose edges just changed
+	CHECK(index.rank("y").size() == 2);
+	index.erase_edge("x", "x", 2);
+	CHECK(index.rank("y").size() == 2);
+	CHECK(index.misses() == 3);
+
+	// z points into a's cycle, erasing it changes nothing a reaches
+	index.erase_node("z");
+	CHECK(index.rank("a") == scores);
+	CHECK(index.hits() == 3);
+	index.insert_edge("c", "y", 1);
+	CHECK(index.rank("a").size() == 5);
+	CHECK(index.misses() == 4);
+
+	// least recently used first out
+	CHECK(index.rank("b").size() == 5);
+	CHECK(index.rank("x").size() == 2);
+	CHECK(index.misses() == 6);
+	CHECK(index.rank("b").size() == 5);
+	CHECK(index.hits() == 4);
+	CHECK(index.rank("a").size() == 5);
+	CHECK(index.misses() == 7);
+	CHECK(index.underlying().is_node("a"));
+}
+
+TEST_CASE("personalized pagerank errors") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	g.insert_edge(1, 2, 1);
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	CHECK_THROWS_MATCHES(gdwg::personalized_pagerank(view, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::personalized_pagerank from a "
+	                                              "seed that doesn't exist in the graph"));
+	CHECK_THROWS_MATCHES(gdwg::personalized_pagerank(view, 0, {.damping = 1.0}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::personalized_pagerank with a "
+	                                              "damping factor outside [0, 1)"));
+	CHECK_THROWS_MATCHES(gdwg::personalized_pagerank(view, 0, {.tolerance = 0.0}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::personalized_pagerank with a "
+	                                              "non-positive tolerance"));
+	CHECK_THROWS_MATCHES((gdwg::personalized_pagerank_index<int, int>(g, {{.damping = -0.5}})),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot construct "
+	                                              "gdwg::personalized_pagerank_index with a "
+	                                              "damping factor outside [0, 1)"));
+	auto index = gdwg::personalized_pagerank_index<int, int>(g);
+	CHECK_THROWS_MATCHES(index.rank(3),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::personalized_pagerank_index<N, "
+	                                              "E>::rank from a seed that doesn't exist in the "
+	                                              "graph"));
+}
@@ -0,0 +1,139 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/random_walk.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+// Rationale: walks are checked to follow edges and to stop at dead ends, the same seed has to
+// give the same walks on any number of threads, and the step frequencies of weighted and
+// node2vec walks are compared with their exact probabilities over many walks.
+
+namespace {
+	// every walk by its index, the sink is called from several threads
+	auto collect(gdwg::csr_graph<int, int> const& view, gdwg::walk_options const& options)
+	   -> std::vector<std::vector<gdwg::node_id>> {
+		auto const walks = view.num_nodes() * options.walks_per_node;
+		auto ret = std::vector<std::vector<gdwg::node_id>>(walks);
+		auto mutex = std::mutex();
+		auto const sink = [&](std::size_t walk, std::span<gdwg::node_id const> nodes) {
+			auto lock = std::lock_guard(mutex);
+			ret[walk].assign(nodes.begin(), nodes.end());
+		};
+		gdwg::random_walks(view, options, sink);
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("random walks follow edges and are reproducible") {
+	auto const g = gdwg::rmat_graph({.scale = 8, .edge_factor = 4, .max_weight = 9, .seed = 6771});
+	auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+	for (auto const weighted : {false, true}) {
+		for (auto const p : {1.0, 0.25}) {
+			auto options = gdwg::walk_options{.length = 12, .walks_per_node = 3, .weighted = weighted};
+			options.p = p;
+			options.q = 4.0 * p;
+			options.threads = 1;
+			auto const serial = collect(view, options);
+			options.threads = 4;
+			CHECK(collect(view, options) == serial);
+			options.seed = 1;
+			CHECK(collect(view, options) != serial);
+
+			for (auto w = std::size_t{0}; w < serial.size(); ++w) {
+				auto const& walk = serial[w];
+				REQUIRE(!walk.empty());
+				CHECK(walk.front() == w % view.num_nodes());
+				CHECK(walk.size() <= 12);
+				for (auto i = std::size_t{0}; i + 1 < walk.size(); ++i) {
+					auto const out = view.out_targets(walk[i]);
+					CHECK(std::find(out.begin(), out.end(), walk[i + 1]) != out.end());
+				}
+				if (walk.size() < 12) {
+					CHECK(view.out_degree(walk.back()) == 0);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("weighted walks step in proportion to the weights") {
+	auto g = gdwg::graph<std::string, int>{"hub", "a", "b", "c", "z"};
+	g.insert_edge("hub", "a", 1);
+	g.insert_edge("hub", "b", 2);
+	g.insert_edge("hub", "c", 7);
+	g.insert_edge("hub", "z", 0);
+	auto counts = std::map<std::string, double>();
+	auto walks = 0.0;
+	auto const options = gdwg::walk_options{.length = 2, .walks_per_node = 20000, .weighted = true};
+	auto mutex = std::mutex();
+	gdwg::random_walks(g, options, [&](std::size_t, std::span<std::string const> nodes) {
+		if (nodes.front() == "hub") {
+			auto lock = std::lock_guard(mutex);
+			REQUIRE(nodes.size() == 2);
+			++counts[nodes[1]];
+			++walks;
+		}
+	});
+	CHECK(walks == 20000);
+	CHECK(counts["a"] / walks == Approx(0.1).margin(0.01));
+	CHECK(counts["b"] / walks == Approx(0.2).margin(0.01));
+	CHECK(counts["c"] / walks == Approx(0.7).margin(0.01));
+	CHECK(counts["z"] == 0);
+
+	// a row of zero weights is a dead end
+	auto zero = gdwg::graph<int, int>{1, 2};
+	zero.insert_edge(1, 2, 0);
+	gdwg::random_walks(zero, {.length = 5, .weighted = true}, [](std::size_t, auto nodes) {
+		CHECK(nodes.size() == 1);
+	});
+}
+
+TEST_CASE("node2vec walks are biased by p and q") {
+	// from b having come from a: back to a has weight 1/p, c is also next to a so 1, d is not so
+	// 1/q
+	auto g = gdwg::graph<char, int>{'a', 'b', 'c', 'd'};
+	g.insert_edge('a', 'b', 1);
+	g.insert_edge('a', 'c', 1);
+	g.insert_edge('b', 'a', 1);
+	g.insert_edge('b', 'c', 1);
+	g.insert_edge('b', 'd', 1);
+	auto const options =
+	   gdwg::walk_options{.length = 3, .walks_per_node = 40000, .p = 0.5, .q = 2.0};
+	auto counts = std::map<char, double>();
+	auto walks = 0.0;
+	auto mutex = std::mutex();
+	gdwg::random_walks(g, options, [&](std::size_t, std::span<char const> nodes) {
+		if (nodes.size() == 3 && nodes[0] == 'a' && nodes[1] == 'b') {
+			auto lock = std::lock_guard(mutex);
+			++counts[nodes[2]];
+			++walks;
+		}
+	});
+	CHECK(walks == Approx(20000).margin(600));
+	CHECK(counts['a'] / walks == Approx(2.0 / 3.5).margin(0.015));
+	CHECK(counts['c'] / walks == Approx(1.0 / 3.5).margin(0.015));
+	CHECK(counts['d'] / walks == Approx(0.5 / 3.5).margin(0.015));
+}
+
+TEST_CASE("random walks errors") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	g.insert_edge(1, 2, -1);
+	auto const sink = [](std::size_t, std::span<int const>) {};
+	CHECK_NOTHROW(gdwg::random_walks(g, {}, sink));
+	CHECK_THROWS_MATCHES(gdwg::random_walks(g, {.weighted = true}, sink),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::random_walks on a graph with "
+	                                              "negative edge weights"));
+	CHECK_THROWS_MATCHES(gdwg::random_walks(g, {.q = 0.0}, sink),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::random_walks with a "
+	                                              "non-positive p or q"));
+}
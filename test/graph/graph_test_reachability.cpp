@@ -0,0 +1,150 @@
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/reachability.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Rationale: every pair of nodes is checked against a breadth first search over the graph, on
+// random graphs with and without cycles and again after every edge inserted through the index,
+// since that is where the labels are widened in place rather than rebuilt.
+
+namespace {
+	auto bfs_reaches(gdwg::graph<int, int> const& g, int src, int dst) -> bool {
+		auto seen = std::set<int>{src};
+		auto queue = std::queue<int>();
+		queue.push(src);
+		while (!queue.empty()) {
+			auto const u = queue.front();
+			queue.pop();
+			if (u == dst) {
+				return true;
+			}
+			for (auto const v : g.connections(u)) {
+				if (seen.insert(v).second) {
+					queue.push(v);
+				}
+			}
+		}
+		return false;
+	}
+
+	auto check_all_pairs(gdwg::reachability_index<int, int> const& index) -> void {
+		auto const& g = index.underlying();
+		for (auto const u : g.nodes()) {
+			for (auto const v : g.nodes()) {
+				REQUIRE(index.is_reachable(u, v) == bfs_reaches(g, u, v));
+			}
+		}
+	}
+
+	// edges mostly go from lower to higher nodes, backwards with the given chance
+	auto random_graph(int n, int edges, double backwards, std::mt19937& rng)
+	   -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto coin = std::bernoulli_distribution(backwards);
+		for (auto i = 0; i < edges; ++i) {
+			auto a = node(rng);
+			auto b = node(rng);
+			if ((a > b) != coin(rng)) {
+				std::swap(a, b);
+			}
+			g.insert_edge(a, b, 1);
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("reachability agrees with breadth first search") {
+	auto rng = std::mt19937(6771);
+	for (auto const backwards : {0.0, 0.05, 0.3}) {
+		for (auto round = 0; round < 5; ++round) {
+			auto g = random_graph(40, 60, backwards, rng);
+			auto const index = gdwg::reachability_index<int, int>(g);
+			check_all_pairs(index);
+		}
+	}
+	auto g = gdwg::rmat_graph({.scale = 7, .edge_factor = 2, .seed = 6771});
+	check_all_pairs(gdwg::reachability_index<int, int>(g, {.traversals = 1}));
+}
+
+TEST_CASE("reachability stays exact while edges are inserted") {
+	auto rng = std::mt19937(6771);
+	for (auto const backwards : {0.0, 0.1}) {
+		auto g = random_graph(30, 20, backwards, rng);
+		auto index = gdwg::reachability_index<int, int>(g);
+		auto node = std::uniform_int_distribution<int>(0, 29);
+		auto coin = std::bernoulli_distribution(backwards);
+		for (auto i = 0; i < 40; ++i) {
+			auto a = node(rng);
+			auto b = node(rng);
+			if ((a > b) != coin(rng)) {
+				std::swap(a, b);
+			}
+			index.insert_edge(a, b, 1);
+			check_all_pairs(index);
+		}
+		if (backwards == 0.0) {
+			// a DAG only ever gets its labels widened
+			CHECK(index.rebuilds() == 1);
+		}
+	}
+}
+
+TEST_CASE("reachability index over nodes, cycles and erasures") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 1);
+	auto index = gdwg::reachability_index<std::string, int>(g);
+	CHECK(index.num_components() == 4);
+	CHECK(index.is_reachable("a", "c"));
+	CHECK(index.is_reachable("d", "d"));
+	CHECK(!index.is_reachable("c", "a"));
+	CHECK(!index.is_reachable("a", "d"));
+
+	CHECK(index.insert_node("e"));
+	CHECK(!index.insert_node("e"));
+	CHECK(index.insert_edge("c", "e", 1));
+	CHECK(!index.insert_edge("c", "e", 1));
+	CHECK(index.is_reachable("a", "e"));
+	CHECK(!index.is_reachable("e", "a"));
+	CHECK(index.rebuilds() == 1);
+
+	// closing a cycle merges a, b and c
+	CHECK(index.insert_edge("c", "a", 1));
+	CHECK(index.rebuilds() == 2);
+	CHECK(index.num_components() == 3);
+	CHECK(index.is_reachable("c", "b"));
+	CHECK(g.is_connected("c", "a"));
+
+	CHECK(index.erase_edge("b", "c", 1));
+	CHECK(!index.is_reachable("a", "c"));
+	CHECK(index.is_reachable("c", "b"));
+	CHECK(index.erase_node("a"));
+	CHECK(!index.is_reachable("c", "b"));
+	CHECK(index.rebuilds() == 4);
+	CHECK(&index.underlying() == &g);
+}
+
+TEST_CASE("reachability index errors") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	auto index = gdwg::reachability_index<int, int>(g);
+	CHECK_THROWS_MATCHES(index.is_reachable(1, 3),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::reachability_index<N, "
+	                                              "E>::is_reachable if src or dst node don't exist "
+	                                              "in the graph"));
+	CHECK_THROWS_MATCHES(index.insert_edge(1, 3, 1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::insert_edge when "
+	                                              "either src or dst node does not exist"));
+}
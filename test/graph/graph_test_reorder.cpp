@@ -0,0 +1,244 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/landmarks.hpp"
+#include "gdwg/pagerank.hpp"
+#include "gdwg/reorder.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Rationale: a reordered snapshot must hold exactly the same edges between the same values and
+// still find every node by value, so results read back by N don't change. Each method must give
+// a permutation, and on graphs whose best order is known (a shuffled path, clusters behind
+// random names) it must recover most of the locality the names threw away.
+
+namespace {
+	using view_type = gdwg::csr_graph<std::string, int>;
+
+	using edge_value = std::tuple<std::string, std::string, int>;
+
+	// every edge as values, in a canonical order
+	auto edge_values(view_type const& view) -> std::vector<edge_value> {
+		auto ret = std::vector<edge_value>();
+		for (auto u = gdwg::node_id{0}; u < view.num_nodes(); ++u) {
+			auto const targets = view.out_targets(u);
+			auto const weights = view.out_weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				ret.emplace_back(view.node(u), view.node(targets[k]), weights[k]);
+			}
+		}
+		std::sort(ret.begin(), ret.end());
+		return ret;
+	}
+
+	// the largest and the total difference between the ids at the two ends of an edge
+	auto gaps(view_type const& view) -> std::pair<std::size_t, std::size_t> {
+		auto largest = std::size_t{0};
+		auto total = std::size_t{0};
+		for (auto u = gdwg::node_id{0}; u < view.num_nodes(); ++u) {
+			for (auto const v : view.out_targets(u)) {
+				auto const gap = static_cast<std::size_t>(std::abs(static_cast<long>(u) - v));
+				largest = std::max(largest, gap);
+				total += gap;
+			}
+		}
+		return {largest, total};
+	}
+
+	// names that say nothing about where a node sits
+	auto random_names(std::mt19937& rng, int n) -> std::vector<std::string> {
+		auto ret = std::vector<std::string>();
+		auto letter = std::uniform_int_distribution<int>('a', 'z');
+		while (static_cast<int>(ret.size()) < n) {
+			auto name = std::string(8, ' ');
+			for (auto& c : name) {
+				c = static_cast<char>(letter(rng));
+			}
+			ret.push_back(name);
+		}
+		return ret;
+	}
+
+	// clusters of ten densely linked nodes, with a few edges between neighbouring clusters
+	auto clustered(std::mt19937& rng, int clusters) -> gdwg::graph<std::string, int> {
+		auto const names = random_names(rng, clusters * 10);
+		auto g = gdwg::graph<std::string, int>(names.begin(), names.end());
+		auto pick = std::uniform_int_distribution<int>(0, 9);
+		for (auto c = 0; c < clusters; ++c) {
+			for (auto i = 0; i < 40; ++i) {
+				g.insert_edge(names[static_cast<std::size_t>(c * 10 + pick(rng))],
+				              names[static_cast<std::size_t>(c * 10 + pick(rng))],
+				              i);
+			}
+			if (c + 1 < clusters) {
+				g.insert_edge(names[static_cast<std::size_t>(c * 10 + pick(rng))],
+				              names[static_cast<std::size_t>(c * 10 + 10 + pick(rng))],
+				              0);
+			}
+		}
+		return g;
+	}
+
+	auto is_permutation(std::vector<gdwg::node_id> order, std::size_t n) -> bool {
+		std::sort(order.begin(), order.end());
+		auto identity = std::vector<gdwg::node_id>(n);
+		std::iota(identity.begin(), identity.end(), gdwg::node_id{0});
+		return order == identity;
+	}
+} // namespace
+
+TEST_CASE("a reordered snapshot keeps every edge and finds every node") {
+	auto rng = std::mt19937(6771);
+	auto const g = clustered(rng, 8);
+	auto const view = view_type(g);
+	auto order = std::vector<gdwg::node_id>(view.num_nodes());
+	std::iota(order.begin(), order.end(), gdwg::node_id{0});
+	std::shuffle(order.begin(), order.end(), rng);
+	auto const shuffled = view.reordered(order);
+	REQUIRE(shuffled.num_nodes() == view.num_nodes());
+	REQUIRE(shuffled.num_edges() == view.num_edges());
+	CHECK(shuffled.has_incoming());
+	CHECK(edge_values(shuffled) == edge_values(view));
+	for (auto i = gdwg::node_id{0}; i < shuffled.num_nodes(); ++i) {
+		CHECK(shuffled.node(i) == view.node(order[i]));
+		CHECK(shuffled.id(shuffled.node(i)) == i);
+		// rows stay sorted by target, and weights ascend between parallel edges
+		auto const targets = shuffled.out_targets(i);
+		auto const weights = shuffled.out_weights(i);
+		for (auto k = std::size_t{1}; k < targets.size(); ++k) {
+			CHECK((targets[k - 1] < targets[k]
+			       || (targets[k - 1] == targets[k] && weights[k - 1] <= weights[k])));
+		}
+		for (auto const k : shuffled.in_edges(i)) {
+			CHECK(shuffled.targets()[k] == i);
+		}
+	}
+	CHECK_FALSE(shuffled.find("not a node"));
+
+	// reordering again composes, and the identity leaves the snapshot as it was
+	auto const back = shuffled.reordered(gdwg::reverse_cuthill_mckee(shuffled));
+	CHECK(edge_values(back) == edge_values(view));
+	for (auto const& value : view.nodes()) {
+		CHECK(back.node(back.id(value)) == value);
+	}
+	auto identity = std::vector<gdwg::node_id>(view.num_nodes());
+	std::iota(identity.begin(), identity.end(), gdwg::node_id{0});
+	auto const same = view.reordered(identity);
+	CHECK(same.nodes() == view.nodes());
+	CHECK(std::equal(same.targets().begin(), same.targets().end(), view.targets().begin()));
+
+	auto const outgoing = view_type(g, gdwg::csr_layout::outgoing).reordered(order);
+	CHECK_FALSE(outgoing.has_incoming());
+}
+
+TEST_CASE("every method gives a permutation") {
+	auto rng = std::mt19937(42);
+	auto g = clustered(rng, 5);
+	// isolated nodes and self loops too
+	g.insert_node("alone");
+	g.insert_node("looped");
+	g.insert_edge("looped", "looped", 1);
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	CHECK(is_permutation(gdwg::reverse_cuthill_mckee(view), view.num_nodes()));
+	CHECK(is_permutation(gdwg::hub_sort(view), view.num_nodes()));
+	CHECK(is_permutation(gdwg::gorder(view), view.num_nodes()));
+	CHECK(is_permutation(gdwg::gorder(view, {.window = 1, .hub_threshold = 2}),
+	                     view.num_nodes()));
+
+	auto const empty = gdwg::csr_graph<std::string, int>(gdwg::graph<std::string, int>{});
+	CHECK(gdwg::reverse_cuthill_mckee(empty).empty());
+	CHECK(gdwg::hub_sort(empty).empty());
+	CHECK(gdwg::gorder(empty).empty());
+}
+
+TEST_CASE("reverse Cuthill-McKee straightens a shuffled path") {
+	auto rng = std::mt19937(1);
+	auto const names = random_names(rng, 300);
+	auto g = gdwg::graph<std::string, int>(names.begin(), names.end());
+	for (auto i = std::size_t{0}; i + 1 < names.size(); ++i) {
+		g.insert_edge(names[i], names[i + 1], 1);
+	}
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	CHECK(gaps(view).first > 100);
+	auto const path = gdwg::reorder(g, gdwg::reorder_method::reverse_cuthill_mckee);
+	CHECK(gaps(path).first == 1);
+	// the path is walked from one end to the other
+	auto const first = path.node(0);
+	CHECK((first == names.front() || first == names.back()));
+}
+
+TEST_CASE("locality orders bring clusters back together") {
+	auto rng = std::mt19937(7);
+	auto const g = clustered(rng, 30);
+	auto const view = view_type(g);
+	auto const original = gaps(view).second;
+	for (auto const method : {gdwg::reorder_method::reverse_cuthill_mckee,
+	                          gdwg::reorder_method::gorder})
+	{
+		auto const reordered = gdwg::reorder(view, method);
+		CHECK(gaps(reordered).second * 5 < original);
+	}
+}
+
+TEST_CASE("hub sort puts the busiest nodes first and leaves the rest alone") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e", "f"};
+	for (auto const& v : {"a", "b", "c", "d", "f"}) {
+		g.insert_edge("e", v, 1);
+	}
+	g.insert_edge("b", "a", 1);
+	g.insert_edge("c", "b", 1);
+	g.insert_edge("d", "b", 1);
+	// degrees a 2, b 4, c 2, d 2, e 5, f 1 against an average of 8 * 2 / 6
+	auto const order = gdwg::hub_sort(view_type(g, gdwg::csr_layout::outgoing));
+	auto names = std::vector<std::string>();
+	auto const view = view_type(g, gdwg::csr_layout::outgoing);
+	for (auto const u : order) {
+		names.push_back(view.node(u));
+	}
+	CHECK(names == std::vector<std::string>{"e", "b", "a", "c", "d", "f"});
+}
+
+TEST_CASE("results read back by value don't depend on the order") {
+	auto rng = std::mt19937(99);
+	auto const g = clustered(rng, 12);
+	auto const view = gdwg::csr_graph<std::string, int>(g);
+	auto const expected = gdwg::pagerank(view, {.tolerance = 1e-12, .threads = 1});
+	auto const oracle = gdwg::landmark_oracle<std::string, int>(view, {.landmarks = 4});
+	for (auto const method : {gdwg::reorder_method::reverse_cuthill_mckee,
+	                          gdwg::reorder_method::hub_sort,
+	                          gdwg::reorder_method::gorder})
+	{
+		auto const reordered = gdwg::reorder(view, method);
+		auto const result = gdwg::pagerank(reordered, {.tolerance = 1e-12, .threads = 1});
+		auto const reordered_oracle =
+		   gdwg::landmark_oracle<std::string, int>(reordered, {.landmarks = 4});
+		for (auto const& value : view.nodes()) {
+			CHECK(result.rank[reordered.id(value)] == Approx(expected.rank[view.id(value)]));
+			CHECK(reordered_oracle.find(value) == reordered.find(value));
+		}
+		CHECK(oracle.find("missing") == reordered_oracle.find("missing"));
+	}
+}
+
+TEST_CASE("reordered needs a permutation") {
+	auto const view = view_type(gdwg::graph<std::string, int>{"a", "b", "c"});
+	auto const message = "Cannot call gdwg::csr_graph<N, E>::reordered with an order that isn't a "
+	                     "permutation of the node ids";
+	CHECK_THROWS_MATCHES(view.reordered({0, 1}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message(message));
+	CHECK_THROWS_MATCHES(view.reordered({0, 1, 1}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message(message));
+	CHECK_THROWS_MATCHES(view.reordered({0, 1, 3}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message(message));
+}
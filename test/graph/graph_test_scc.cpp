@@ -0,0 +1,116 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/scc.hpp"
+
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: components are checked on a hand made graph, then against mutual reachability on
+// random graphs. A long chain makes sure the iterative version doesn't need the call stack and the
+// condensation is checked to be a DAG whose edges go up in component id.
+
+namespace {
+	// reach[u][v] by a dfs from every node
+	auto reachability(gdwg::csr_graph<int, int> const& view) -> std::vector<std::vector<bool>> {
+		auto const n = view.num_nodes();
+		auto ret = std::vector<std::vector<bool>>(n, std::vector<bool>(n, false));
+		for (auto s = gdwg::node_id{0}; s < n; ++s) {
+			auto stack = std::vector<gdwg::node_id>{s};
+			ret[s][s] = true;
+			while (!stack.empty()) {
+				auto const u = stack.back();
+				stack.pop_back();
+				for (auto const v : view.out_targets(u)) {
+					if (!ret[s][v]) {
+						ret[s][v] = true;
+						stack.push_back(v);
+					}
+				}
+			}
+		}
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("scc on a small graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e", "f"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 1);
+	g.insert_edge("c", "a", 1);
+	g.insert_edge("c", "d", 2);
+	g.insert_edge("c", "d", 3);
+	g.insert_edge("d", "e", 1);
+	g.insert_edge("e", "d", 1);
+	g.insert_edge("f", "f", 1);
+
+	auto const sccs = gdwg::strongly_connected_components(g);
+	CHECK(sccs.count == 3);
+	// nodes() order is a, b, c, d, e, f
+	auto const& c = sccs.component;
+	CHECK(c[0] == c[1]);
+	CHECK(c[1] == c[2]);
+	CHECK(c[3] == c[4]);
+	CHECK(c[0] != c[3]);
+	CHECK(c[5] != c[0]);
+	CHECK(c[5] != c[3]);
+	CHECK(c[0] < c[3]);
+
+	auto const dag = gdwg::condense(g);
+	CHECK(dag.nodes() == std::vector<gdwg::component_id>{0, 1, 2});
+	CHECK(dag.weights(c[0], c[3]) == std::vector<int>{2, 3});
+	CHECK_FALSE(dag.is_connected(c[5], c[5]));
+	CHECK_FALSE(dag.is_connected(c[0], c[0]));
+}
+
+TEST_CASE("scc on an empty graph") {
+	auto const g = gdwg::graph<int, int>{};
+	auto const sccs = gdwg::strongly_connected_components(g);
+	CHECK(sccs.count == 0);
+	CHECK(sccs.component.empty());
+	CHECK(gdwg::condense(g).empty());
+}
+
+TEST_CASE("scc on a long cycle does not recurse") {
+	auto constexpr n = 200000;
+	auto nodes = std::vector<int>(n);
+	std::iota(nodes.begin(), nodes.end(), 0);
+	auto g = gdwg::graph<int, int>(nodes.begin(), nodes.end());
+	auto edges = std::vector<gdwg::graph<int, int>::value_type>();
+	for (auto i = 0; i + 1 < n; ++i) {
+		edges.push_back({i, i + 1, 1});
+	}
+	g.insert_edges(edges.begin(), edges.end());
+	CHECK(gdwg::strongly_connected_components(g).count == n);
+	g.insert_edge(n - 1, 0, 1);
+	CHECK(gdwg::strongly_connected_components(g).count == 1);
+}
+
+TEST_CASE("scc matches mutual reachability on random graphs") {
+	auto rng = std::mt19937(6771);
+	for (auto round = 0; round < 10; ++round) {
+		auto const n = 40;
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		for (auto i = 0; i < 20 + round * 8; ++i) {
+			g.insert_edge(node(rng), node(rng), node(rng));
+		}
+		auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+		auto const sccs = gdwg::strongly_connected_components(view);
+		auto const reach = reachability(view);
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			for (auto v = gdwg::node_id{0}; v < n; ++v) {
+				CHECK((sccs.component[u] == sccs.component[v]) == (reach[u][v] && reach[v][u]));
+			}
+		}
+		auto const dag = gdwg::condense(view, sccs);
+		CHECK(dag.nodes().size() == sccs.count);
+		for (auto const& [from, to, weight] : dag) {
+			CHECK(from < to);
+		}
+	}
+}
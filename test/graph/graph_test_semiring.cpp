@@ -0,0 +1,270 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/pagerank.hpp"
+#include "gdwg/semiring.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Rationale: breadth first search, Bellman-Ford rounds and PageRank written as a few kernel
+// calls must agree with direct implementations on R-MAT graphs large enough to take the
+// parallel paths, and the sparse kernel must give identical results on any number of threads.
+// Each semiring and the dense kernels are also checked by hand on a small graph.
+
+namespace {
+	auto constexpr infinite = std::numeric_limits<int>::max();
+
+	auto rmat() -> gdwg::csr_graph<int, int> {
+		return gdwg::csr_graph<int, int>(
+		   gdwg::rmat_graph({.scale = 10, .edge_factor = 32, .max_weight = 20, .seed = 6771}));
+	}
+
+	auto bfs(gdwg::csr_graph<int, int> const& g, gdwg::node_id src) -> std::vector<int> {
+		auto ret = std::vector<int>(g.num_nodes(), -1);
+		auto queue = std::queue<gdwg::node_id>();
+		ret[src] = 0;
+		queue.push(src);
+		while (!queue.empty()) {
+			auto const u = queue.front();
+			queue.pop();
+			for (auto const v : g.out_targets(u)) {
+				if (ret[v] == -1) {
+					ret[v] = ret[u] + 1;
+					queue.push(v);
+				}
+			}
+		}
+		return ret;
+	}
+
+	auto dijkstra(gdwg::csr_graph<int, int> const& g, gdwg::node_id src) -> std::vector<int> {
+		auto ret = std::vector<int>(g.num_nodes(), infinite);
+		using entry = std::pair<int, gdwg::node_id>;
+		auto heap = std::priority_queue<entry, std::vector<entry>, std::greater<>>();
+		ret[src] = 0;
+		heap.emplace(0, src);
+		while (!heap.empty()) {
+			auto const [d, u] = heap.top();
+			heap.pop();
+			if (d != ret[u]) {
+				continue;
+			}
+			auto const targets = g.out_targets(u);
+			auto const weights = g.out_weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				if (d + weights[k] < ret[targets[k]]) {
+					ret[targets[k]] = d + weights[k];
+					heap.emplace(ret[targets[k]], targets[k]);
+				}
+			}
+		}
+		return ret;
+	}
+
+	// levels of a breadth first search as repeated frontier expansions
+	auto semiring_bfs(gdwg::csr_graph<int, int> const& g,
+	                  gdwg::node_id src,
+	                  gdwg::spmv_workspace<std::uint8_t>& ws) -> std::vector<int> {
+		auto ret = std::vector<int>(g.num_nodes(), -1);
+		auto visited = std::vector<char>(g.num_nodes(), 0);
+		auto frontier = gdwg::sparse_vector<std::uint8_t>{{src}, {1}};
+		for (auto level = 0; !frontier.indices.empty(); ++level) {
+			for (auto const u : frontier.indices) {
+				ret[u] = level;
+				visited[u] = 1;
+			}
+			frontier = gdwg::vxm<gdwg::or_and>(g, frontier, ws, visited);
+		}
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("breadth first search as sparse frontier expansions") {
+	auto const g = rmat();
+	auto serial = gdwg::spmv_workspace<std::uint8_t>(1);
+	auto parallel = gdwg::spmv_workspace<std::uint8_t>(4);
+	for (auto const src : {0U, 1U, 77U, 1023U}) {
+		auto const expected = bfs(g, src);
+		CHECK(semiring_bfs(g, src, serial) == expected);
+		CHECK(semiring_bfs(g, src, parallel) == expected);
+	}
+}
+
+TEST_CASE("the sparse kernel gives the same result on any number of threads") {
+	auto const g = rmat();
+	// every node with a fractional value, so the order of the additions shows
+	auto x = gdwg::sparse_vector<double>{};
+	for (auto u = gdwg::node_id{0}; u < g.num_nodes(); u += 2) {
+		x.indices.push_back(u);
+		x.values.push_back(1.0 / (u + 3.0));
+	}
+	auto serial = gdwg::spmv_workspace<double>(1);
+	auto const expected = gdwg::vxm<gdwg::plus_times<double>>(g, x, serial);
+	for (auto const threads : {2U, 3U, 8U}) {
+		auto ws = gdwg::spmv_workspace<double>(threads);
+		auto const result = gdwg::vxm<gdwg::plus_times<double>>(g, x, ws);
+		CHECK(result.indices == expected.indices);
+		CHECK(result.values == expected.values);
+	}
+	// and the dense kernel agrees on the entries it has
+	auto dense = std::vector<double>(g.num_nodes(), 0.0);
+	for (auto i = std::size_t{0}; i < x.indices.size(); ++i) {
+		dense[x.indices[i]] = x.values[i];
+	}
+	auto y = std::vector<double>(g.num_nodes());
+	gdwg::vxm<gdwg::plus_times<double>>(g, dense, y, serial);
+	for (auto i = std::size_t{0}; i < expected.indices.size(); ++i) {
+		CHECK(y[expected.indices[i]] == Approx(expected.values[i]));
+	}
+}
+
+TEST_CASE("Bellman-Ford rounds of min-plus products reach the shortest distances") {
+	auto const g = rmat();
+	auto ws = gdwg::spmv_workspace<int>(4);
+	for (auto const src : {0U, 5U, 900U}) {
+		auto dist = std::vector<int>(g.num_nodes(), gdwg::min_plus<int>::zero());
+		dist[src] = 0;
+		auto next = dist;
+		for (auto round = std::size_t{0}; round < g.num_nodes(); ++round) {
+			gdwg::vxm<gdwg::min_plus<int>>(g, dist, next, ws);
+			for (auto u = std::size_t{0}; u < dist.size(); ++u) {
+				next[u] = gdwg::min_plus<int>::add(next[u], dist[u]);
+			}
+			if (next == dist) {
+				break;
+			}
+			dist.swap(next);
+		}
+		CHECK(dist == dijkstra(g, src));
+
+		// the same rounds folded into the distances by the kernel itself
+		auto folded = std::vector<int>(g.num_nodes(), gdwg::min_plus<int>::zero());
+		folded[src] = 0;
+		for (auto round = 0; round < 64; ++round) {
+			auto const before = folded;
+			gdwg::vxm<gdwg::min_plus<int>>(g, before, folded, ws, true);
+		}
+		CHECK(folded == dist);
+	}
+}
+
+TEST_CASE("PageRank as plus-times products matches gdwg::pagerank") {
+	auto const g = gdwg::csr_graph<int, int>(gdwg::rmat_graph({.scale = 10, .seed = 42}));
+	auto const n = g.num_nodes();
+	auto const damping = 0.85;
+	auto const expected = gdwg::pagerank(g, {.tolerance = 0.0, .max_iterations = 20});
+	auto ws = gdwg::spmv_workspace<double>(4);
+	auto rank = std::vector<double>(n, 1.0 / static_cast<double>(n));
+	auto contribution = std::vector<double>(n);
+	auto pulled = std::vector<double>(n);
+	for (auto iteration = 0; iteration < 20; ++iteration) {
+		auto dangling = 0.0;
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			auto const degree = static_cast<double>(g.out_degree(u));
+			contribution[u] = degree == 0.0 ? 0.0 : rank[u] / degree;
+			dangling += degree == 0.0 ? rank[u] : 0.0;
+		}
+		gdwg::vxm<gdwg::plus_times<double>>(g, contribution, pulled, ws);
+		auto const base = (1.0 - damping + damping * dangling) / static_cast<double>(n);
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			rank[u] = base + damping * pulled[u];
+		}
+	}
+	for (auto u = std::size_t{0}; u < n; ++u) {
+		CHECK(rank[u] == Approx(expected.rank[u]).margin(1e-12));
+	}
+}
+
+TEST_CASE("semirings by hand") {
+	// 1 -> 2 (4), 1 -> 2 (7), 1 -> 3 (2), 3 -> 2 (1), 2 -> 4 (5)
+	auto g = gdwg::graph<int, int>{1, 2, 3, 4};
+	g.insert_edge(1, 2, 4);
+	g.insert_edge(1, 2, 7);
+	g.insert_edge(1, 3, 2);
+	g.insert_edge(3, 2, 1);
+	g.insert_edge(2, 4, 5);
+	auto const view = gdwg::csr_graph<int, int>(g);
+	auto ws_int = gdwg::spmv_workspace<int>(2);
+
+	SECTION("min-plus pulls the cheapest of parallel edges") {
+		auto const zero = gdwg::min_plus<int>::zero();
+		auto const x = std::vector<int>{0, 10, 1, zero};
+		auto y = std::vector<int>(4);
+		gdwg::vxm<gdwg::min_plus<int>>(view, x, y, ws_int);
+		CHECK(y == std::vector<int>{zero, 2, 2, 15});
+		// A x looks along outgoing edges instead, y[u] = min over u -> v of w + x[v]
+		gdwg::mxv<gdwg::min_plus<int>>(view, x, y, ws_int);
+		CHECK(y == std::vector<int>{3, zero, 11, zero});
+	}
+	SECTION("plus-times adds parallel edges") {
+		auto const x = std::vector<int>{1, 0, 2, 0};
+		auto y = std::vector<int>(4);
+		gdwg::vxm<gdwg::plus_times<int>>(view, x, y, ws_int);
+		CHECK(y == std::vector<int>{0, 11 + 2, 2, 0});
+		gdwg::vxm<gdwg::plus_times<int>>(view, x, y, ws_int, true);
+		CHECK(y == std::vector<int>{0, 26, 4, 0});
+	}
+	SECTION("max-min finds the widest step") {
+		auto ws = gdwg::spmv_workspace<double>(1);
+		auto const low = gdwg::max_min<double>::zero();
+		auto const x = std::vector<double>{gdwg::max_min<double>::one(), 3.0, 6.0, low};
+		auto y = std::vector<double>(4);
+		gdwg::vxm<gdwg::max_min<double>>(view, x, y, ws);
+		CHECK(y == std::vector<double>{low, 7.0, 2.0, 3.0});
+	}
+	SECTION("or-and ignores weights and masks visited nodes") {
+		auto ws = gdwg::spmv_workspace<std::uint8_t>(1);
+		auto const frontier = gdwg::sparse_vector<std::uint8_t>{{0, 2}, {1, 1}};
+		auto const next = gdwg::vxm<gdwg::or_and>(view, frontier, ws);
+		CHECK(next.indices == std::vector<gdwg::node_id>{1, 2});
+		CHECK(next.values == std::vector<std::uint8_t>{1, 1});
+		auto const mask = std::vector<char>{1, 0, 1, 0};
+		auto const masked = gdwg::vxm<gdwg::or_and>(view, frontier, ws, mask);
+		CHECK(masked.indices == std::vector<gdwg::node_id>{1});
+	}
+	SECTION("an empty sparse vector stays empty") {
+		auto const next = gdwg::vxm<gdwg::plus_times<int>>(view, {}, ws_int);
+		CHECK(next.indices.empty());
+		CHECK(next.values.empty());
+	}
+}
+
+TEST_CASE("semiring kernels reject inputs that don't fit") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	g.insert_edge(1, 2, 1);
+	auto const view = gdwg::csr_graph<int, int>(g);
+	auto ws = gdwg::spmv_workspace<int>(1);
+	auto y = std::vector<int>(3);
+	auto const short_x = std::vector<int>(2);
+	CHECK_THROWS_MATCHES(gdwg::mxv<gdwg::plus_times<int>>(view, short_x, y, ws),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::mxv with vectors whose size "
+	                                              "doesn't match the graph"));
+	CHECK_THROWS_MATCHES(gdwg::vxm<gdwg::plus_times<int>>(view, short_x, y, ws),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::vxm with vectors whose size "
+	                                              "doesn't match the graph"));
+	auto const outgoing = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+	CHECK_THROWS_MATCHES(gdwg::vxm<gdwg::plus_times<int>>(outgoing, y, y, ws),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::vxm on a csr_graph built "
+	                                              "without incoming edges"));
+	auto const outside = gdwg::sparse_vector<int>{{3}, {1}};
+	CHECK_THROWS_MATCHES(gdwg::vxm<gdwg::plus_times<int>>(view, outside, ws),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::vxm with a sparse_vector that "
+	                                              "doesn't fit the graph"));
+	auto const mask = std::vector<char>(2);
+	CHECK_THROWS_MATCHES(gdwg::vxm<gdwg::plus_times<int>>(view, {{0}, {1}}, ws, mask),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::vxm with a mask whose size "
+	                                              "doesn't match the graph"));
+}
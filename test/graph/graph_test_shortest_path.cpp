@@ -0,0 +1,204 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: the searches are checked on a small hand made graph where the answer is known, then
+// against a plain Bellman-Ford on random graphs so both the early termination and the reuse of a
+// single workspace across many queries are exercised.
+
+namespace {
+	// distances from src by repeatedly relaxing every edge, slow but obviously correct
+	auto bellman_ford(gdwg::graph<int, int> const& g, int src) -> std::vector<long> {
+		auto const n = g.nodes().size();
+		auto dist = std::vector<long>(n, std::numeric_limits<long>::max());
+		dist[static_cast<std::size_t>(src)] = 0;
+		for (auto round = std::size_t{0}; round < n; ++round) {
+			for (auto const& [from, to, weight] : g) {
+				auto const f = static_cast<std::size_t>(from);
+				auto const t = static_cast<std::size_t>(to);
+				if (dist[f] != std::numeric_limits<long>::max() && dist[f] + weight < dist[t]) {
+					dist[t] = dist[f] + weight;
+				}
+			}
+		}
+		return dist;
+	}
+
+	auto random_graph(int n, int e, unsigned seed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto rng = std::mt19937(seed);
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto weight = std::uniform_int_distribution<int>(0, 20);
+		for (auto i = 0; i < e; ++i) {
+			g.insert_edge(node(rng), node(rng), weight(rng));
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("astar on a small graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 4);
+	g.insert_edge("a", "c", 1);
+	g.insert_edge("c", "b", 2);
+	g.insert_edge("b", "d", 5);
+	g.insert_edge("c", "d", 8);
+	g.insert_edge("d", "e", 3);
+
+	SECTION("zero heuristic is dijkstra") {
+		auto const result = gdwg::astar(g, std::string("a"), std::string("e"), [](auto const&) {
+			return 0;
+		});
+		CHECK(result.found);
+		CHECK(result.distance == 11);
+		CHECK(result.nodes == std::vector<std::string>{"a", "c", "b", "d", "e"});
+		CHECK(result.stats.settled > 0);
+	}
+
+	SECTION("unreachable destination") {
+		auto const result = gdwg::astar(g, std::string("e"), std::string("a"), [](auto const&) {
+			return 0;
+		});
+		CHECK_FALSE(result.found);
+		CHECK(result.nodes.empty());
+	}
+
+	SECTION("src is dst") {
+		auto const result = gdwg::astar(g, std::string("b"), std::string("b"), [](auto const&) {
+			return 0;
+		});
+		CHECK(result.found);
+		CHECK(result.distance == 0);
+		CHECK(result.nodes == std::vector<std::string>{"b"});
+	}
+
+	SECTION("check throws") {
+		CHECK_THROWS_MATCHES(gdwg::astar(g,
+		                                 std::string("a"),
+		                                 std::string("z"),
+		                                 [](auto const&) { return 0; }),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::astar if src or dst node "
+		                                              "don't exist in the graph"));
+		g.insert_edge("a", "e", -1);
+		CHECK_THROWS_MATCHES(gdwg::astar(g,
+		                                 std::string("a"),
+		                                 std::string("e"),
+		                                 [](auto const&) { return 0; }),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::astar on a graph with "
+		                                              "negative edge weights"));
+	}
+}
+
+TEST_CASE("astar on a grid settles fewer nodes with a heuristic") {
+	// 20 x 20 grid with unit weights, node id is row * 20 + column
+	auto constexpr side = 20;
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < side * side; ++i) {
+		g.insert_node(i);
+	}
+	for (auto r = 0; r < side; ++r) {
+		for (auto c = 0; c < side; ++c) {
+			auto const u = r * side + c;
+			if (c + 1 < side) {
+				g.insert_edge(u, u + 1, 1);
+				g.insert_edge(u + 1, u, 1);
+			}
+			if (r + 1 < side) {
+				g.insert_edge(u, u + side, 1);
+				g.insert_edge(u + side, u, 1);
+			}
+		}
+	}
+	auto const dst = side * side - 1;
+	auto const manhattan = [&](int u) {
+		return std::abs(u / side - dst / side) + std::abs(u % side - dst % side);
+	};
+	auto const guided = gdwg::astar(g, 0, dst, manhattan);
+	auto const blind = gdwg::astar(g, 0, dst, [](int) { return 0; });
+	CHECK(guided.distance == 2 * (side - 1));
+	CHECK(blind.distance == 2 * (side - 1));
+	CHECK(guided.nodes.size() == static_cast<std::size_t>(2 * (side - 1) + 1));
+	CHECK(guided.stats.settled < blind.stats.settled);
+}
+
+TEST_CASE("bidirectional dijkstra on a small graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 4);
+	g.insert_edge("a", "c", 1);
+	g.insert_edge("c", "b", 2);
+	g.insert_edge("b", "d", 5);
+	g.insert_edge("c", "d", 8);
+	g.insert_edge("d", "e", 3);
+
+	auto const result = gdwg::bidirectional_dijkstra(g, std::string("a"), std::string("e"));
+	CHECK(result.found);
+	CHECK(result.distance == 11);
+	CHECK(result.nodes == std::vector<std::string>{"a", "c", "b", "d", "e"});
+
+	auto const back = gdwg::bidirectional_dijkstra(g, std::string("e"), std::string("a"));
+	CHECK_FALSE(back.found);
+
+	CHECK_THROWS_MATCHES(gdwg::bidirectional_dijkstra(g, std::string("z"), std::string("a")),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::bidirectional_dijkstra if src or "
+	                                              "dst node don't exist in the graph"));
+
+	auto const outgoing = gdwg::csr_graph<std::string, int>(g, gdwg::csr_layout::outgoing);
+	auto ws = gdwg::search_workspace<int>();
+	CHECK_THROWS_MATCHES(gdwg::bidirectional_dijkstra(outgoing, 0, 1, ws),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::bidirectional_dijkstra on a "
+	                                              "csr_graph built without incoming edges"));
+}
+
+TEST_CASE("searches agree with bellman ford and reuse one workspace") {
+	auto const g = random_graph(60, 240, 6771);
+	auto const view = gdwg::csr_graph<int, int>(g);
+	auto ws = gdwg::search_workspace<int>(view.num_nodes());
+	auto path = std::vector<gdwg::node_id>();
+	for (auto src = 0; src < 60; src += 7) {
+		auto const expected = bellman_ford(g, src);
+		for (auto dst = 0; dst < 60; ++dst) {
+			auto const reachable = expected[static_cast<std::size_t>(dst)]
+			                       != std::numeric_limits<long>::max();
+			auto const s = view.id(src);
+			auto const t = view.id(dst);
+
+			auto const a = gdwg::astar(view, s, t, [](gdwg::node_id) { return 0; }, ws);
+			CHECK(a.found == reachable);
+			if (reachable) {
+				CHECK(a.distance == expected[static_cast<std::size_t>(dst)]);
+				ws.path(path);
+				CHECK(path.front() == s);
+				CHECK(path.back() == t);
+			}
+
+			auto const b = gdwg::bidirectional_dijkstra(view, s, t, ws);
+			CHECK(b.found == reachable);
+			if (reachable) {
+				CHECK(b.distance == expected[static_cast<std::size_t>(dst)]);
+				ws.path(path);
+				REQUIRE(path.front() == s);
+				REQUIRE(path.back() == t);
+				// the spliced path must add up to the reported distance
+				auto total = 0;
+				for (auto i = std::size_t{0}; i + 1 < path.size(); ++i) {
+					auto const ws_between = g.weights(view.node(path[i]), view.node(path[i + 1]));
+					total += *std::min_element(ws_between.begin(), ws_between.end());
+				}
+				CHECK(total == b.distance);
+			}
+		}
+	}
+}
@@ -0,0 +1,91 @@
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/spanning_forest.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Rationale: a small graph with a known answer, then kruskal and boruvka are checked to pick the
+// same forest on random graphs with many equal weights (where a sloppy tie break would differ or
+// form a cycle), and that the forest spans exactly the weakly connected components.
+
+TEST_CASE("spanning forest of a small graph") {
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d", "e", "f"};
+	g.insert_edge("a", "b", 4.0);
+	g.insert_edge("b", "c", 1.0);
+	g.insert_edge("c", "a", 2.0);
+	g.insert_edge("a", "c", 3.0);
+	g.insert_edge("c", "d", 5.0);
+	g.insert_edge("e", "f", 0.5);
+	g.insert_edge("e", "e", 0.1);
+
+	auto const sequential = gdwg::kruskal(g);
+	CHECK(sequential.total_weight == Approx(8.5));
+	CHECK(sequential.edges.size() == 4);
+	using value_type = gdwg::graph<std::string, double>::value_type;
+	auto const as_tuple = [](value_type const& e) { return std::tie(e.from, e.to, e.weight); };
+	auto const by_value = [&](value_type const& lhs, value_type const& rhs) {
+		return as_tuple(lhs) < as_tuple(rhs);
+	};
+	auto expected = std::vector<value_type>{{"b", "c", 1.0},
+	                                        {"c", "a", 2.0},
+	                                        {"c", "d", 5.0},
+	                                        {"e", "f", 0.5}};
+	auto edges = sequential.edges;
+	std::sort(edges.begin(), edges.end(), by_value);
+	std::sort(expected.begin(), expected.end(), by_value);
+	auto const same = [&](value_type const& lhs, value_type const& rhs) {
+		return as_tuple(lhs) == as_tuple(rhs);
+	};
+	CHECK(std::equal(edges.begin(), edges.end(), expected.begin(), expected.end(), same));
+
+	for (auto const threads : {1, 3}) {
+		auto const parallel = gdwg::boruvka(g, static_cast<std::size_t>(threads));
+		CHECK(parallel.total_weight == Approx(8.5));
+		CHECK(parallel.edges.size() == 4);
+	}
+
+	CHECK(gdwg::kruskal(gdwg::graph<int, int>{}).edges.empty());
+	CHECK(gdwg::boruvka(gdwg::graph<int, int>{1, 2}).edges.empty());
+}
+
+TEST_CASE("kruskal and boruvka agree on random graphs") {
+	auto rng = std::mt19937(6771);
+	for (auto round = 0; round < 8; ++round) {
+		auto constexpr n = 300;
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		// only a handful of distinct weights so ties are everywhere
+		auto weight = std::uniform_int_distribution<int>(1, 4);
+		for (auto i = 0; i < 200 * (round + 1); ++i) {
+			g.insert_edge(node(rng), node(rng), weight(rng));
+		}
+		auto const view = gdwg::csr_graph<int, int>(g);
+		auto const components = gdwg::weakly_connected_components(view, {.threads = 1});
+		auto sequential = gdwg::kruskal(view);
+		CHECK(sequential.edges.size() == n - components.sizes.size());
+		std::sort(sequential.edges.begin(), sequential.edges.end());
+		for (auto const threads : {1, 2, 4}) {
+			auto parallel = gdwg::boruvka(view, static_cast<std::size_t>(threads));
+			CHECK(parallel.total_weight == sequential.total_weight);
+			std::sort(parallel.edges.begin(), parallel.edges.end());
+			CHECK(parallel.edges == sequential.edges);
+		}
+	}
+}
+
+TEST_CASE("boruvka on an R-MAT graph") {
+	auto const g = gdwg::rmat_graph<double>({.scale = 11, .edge_factor = 8, .max_weight = 1000});
+	auto const view = gdwg::csr_graph<int, double>(g);
+	auto const sequential = gdwg::kruskal(view);
+	auto const parallel = gdwg::boruvka(view, 4);
+	CHECK(parallel.edges.size() == sequential.edges.size());
+	CHECK(parallel.total_weight == Approx(sequential.total_weight));
+}
@@ -0,0 +1,169 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/subgraph_match.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <mutex>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Rationale: random patterns are matched against random targets and compared with trying every
+// injective mapping, with and without node and weight predicates, so the filtering and the
+// ordering can't drop a match. Threads must find the same matches, and the motif case of the
+// request (a weighted directed cycle) is covered over node values.
+
+namespace {
+	using mapping = std::vector<gdwg::node_id>;
+
+	auto random_graph(int n, int edges, std::mt19937& rng) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto node = std::uniform_int_distribution<int>(0, n - 1);
+		auto weight = std::uniform_int_distribution<int>(1, 4);
+		for (auto i = 0; i < edges; ++i) {
+			g.insert_edge(node(rng), node(rng), weight(rng));
+		}
+		return g;
+	}
+
+	template<typename NodeMatch, typename EdgeMatch>
+	auto brute_force(gdwg::csr_graph<int, int> const& pattern,
+	                 gdwg::csr_graph<int, int> const& target,
+	                 NodeMatch node_match,
+	                 EdgeMatch edge_match) -> std::vector<mapping> {
+		auto ret = std::vector<mapping>();
+		auto current = mapping(pattern.num_nodes());
+		auto const sources = pattern.edge_sources();
+		auto const extend = [&](auto&& self, std::size_t p) -> void {
+			if (p == pattern.num_nodes()) {
+				for (auto e = std::size_t{0}; e < pattern.num_edges(); ++e) {
+					auto const from = current[sources[e]];
+					auto const to = current[pattern.targets()[e]];
+					auto const row = target.out_targets(from);
+					auto found = false;
+					for (auto k = std::size_t{0}; k < row.size(); ++k) {
+						found = found
+						        || (row[k] == to
+						            && edge_match(pattern.weights()[e], target.out_weights(from)[k]));
+					}
+					if (!found) {
+						return;
+					}
+				}
+				ret.push_back(current);
+				return;
+			}
+			for (auto t = gdwg::node_id{0}; t < target.num_nodes(); ++t) {
+				auto const placed = current.begin() + static_cast<std::ptrdiff_t>(p);
+				if (std::find(current.begin(), placed, t) == placed
+				    && node_match(pattern.node(static_cast<gdwg::node_id>(p)), target.node(t)))
+				{
+					current[p] = t;
+					self(self, p + 1);
+				}
+			}
+		};
+		extend(extend, 0);
+		return ret;
+	}
+
+	template<typename... Predicates>
+	auto collect(gdwg::csr_graph<int, int> const& pattern,
+	             gdwg::csr_graph<int, int> const& target,
+	             std::size_t threads,
+	             Predicates... predicates) -> std::vector<mapping> {
+		auto ret = std::vector<mapping>();
+		auto mutex = std::mutex();
+		auto const count = gdwg::subgraph_matches(
+		   pattern,
+		   target,
+		   [&](std::span<gdwg::node_id const> m) {
+			   auto lock = std::lock_guard(mutex);
+			   ret.emplace_back(m.begin(), m.end());
+		   },
+		   {.threads = threads},
+		   predicates...);
+		CHECK(count == ret.size());
+		std::sort(ret.begin(), ret.end());
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("subgraph matches agree with trying every mapping") {
+	auto rng = std::mt19937(6771);
+	auto const same_parity = [](int p, int t) { return p % 2 == t % 2; };
+	auto const heavier = [](int p, int t) { return t >= p; };
+	for (auto round = 0; round < 40; ++round) {
+		auto const pattern_graph = random_graph(2 + round % 3, 2 + round % 4, rng);
+		auto const target_graph = random_graph(9, 24, rng);
+		auto const pattern = gdwg::csr_graph<int, int>(pattern_graph);
+		auto const target = gdwg::csr_graph<int, int>(target_graph);
+		auto const anything = [](int, int) { return true; };
+
+		auto const plain = collect(pattern, target, 1);
+		CHECK(plain == brute_force(pattern, target, anything, anything));
+		CHECK(collect(pattern, target, 4) == plain);
+		CHECK(collect(pattern, target, 2, same_parity, heavier)
+		      == brute_force(pattern, target, same_parity, heavier));
+	}
+}
+
+TEST_CASE("weighted cycles in a transaction graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 500);
+	g.insert_edge("b", "c", 700);
+	g.insert_edge("c", "a", 900);
+	g.insert_edge("c", "d", 50);
+	g.insert_edge("d", "a", 600);
+	g.insert_edge("a", "e", 1000);
+
+	// a 3 cycle of transfers over 100 each
+	auto triangle = gdwg::graph<int, int>{0, 1, 2};
+	triangle.insert_edge(0, 1, 100);
+	triangle.insert_edge(1, 2, 100);
+	triangle.insert_edge(2, 0, 100);
+	auto found = std::vector<std::vector<std::string>>();
+	auto mutex = std::mutex();
+	auto const sink = [&](std::span<std::string const> m) {
+		auto lock = std::lock_guard(mutex);
+		found.emplace_back(m.begin(), m.end());
+	};
+	auto const at_least = [](int p, int t) { return t >= p; };
+	auto const count = gdwg::subgraph_matches(triangle, g, sink, {}, {}, at_least);
+	// one cycle, found from each of its three rotations
+	CHECK(count == 3);
+	std::sort(found.begin(), found.end());
+	CHECK(found.front() == std::vector<std::string>{"a", "b", "c"});
+
+	// the 4 cycle through d uses a 50 transfer, so it only shows up without the weight limit
+	auto square = gdwg::graph<int, int>{0, 1, 2, 3};
+	square.insert_edge(0, 1, 100);
+	square.insert_edge(1, 2, 100);
+	square.insert_edge(2, 3, 100);
+	square.insert_edge(3, 0, 100);
+	CHECK(gdwg::subgraph_matches(square, g, [](auto) {}, {}, {}, at_least) == 0);
+	CHECK(gdwg::subgraph_matches(square, g, [](auto) {}) == 4);
+
+	// only nodes whose name comes after the pattern's label may stand in for it
+	auto labelled = gdwg::graph<std::string, int>{"b"};
+	auto const after = [](std::string const& p, std::string const& t) { return t > p; };
+	CHECK(gdwg::subgraph_matches(labelled, g, [](auto) {}, {}, after) == 3);
+	CHECK(gdwg::subgraph_matches(gdwg::graph<int, int>{}, g, [](auto) {}) == 0);
+}
+
+TEST_CASE("subgraph matches errors") {
+	auto const g = gdwg::graph<int, int>{1};
+	auto const outgoing = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+	auto const both = gdwg::csr_graph<int, int>(g);
+	CHECK_THROWS_MATCHES(gdwg::subgraph_matches(outgoing, both, [](auto) {}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::subgraph_matches on a "
+	                                              "csr_graph built without incoming edges"));
+}
@@ -0,0 +1,159 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/topological_sort.hpp"
+
+#include <catch2/catch.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: an order is valid when every edge goes forwards in it, so that is what is checked
+// after the one shot sort and after every incremental insert. Cycles have to be real cycles of the
+// graph (or of the graph plus the rejected edge).
+
+namespace {
+	template<typename N, typename E>
+	auto is_valid_order(gdwg::graph<N, E> const& g, std::vector<N> const& order) -> bool {
+		if (order.size() != g.nodes().size()) {
+			return false;
+		}
+		auto position = std::map<N, std::size_t>();
+		for (auto i = std::size_t{0}; i < order.size(); ++i) {
+			position[order[i]] = i;
+		}
+		return std::all_of(g.begin(), g.end(), [&](auto const& e) {
+			return position.at(e.from) < position.at(e.to);
+		});
+	}
+} // namespace
+
+TEST_CASE("kahn topological sort") {
+	auto g = gdwg::graph<std::string, int>{"compile", "link", "test", "package", "docs"};
+	g.insert_edge("compile", "link", 3);
+	g.insert_edge("link", "test", 1);
+	g.insert_edge("link", "package", 2);
+	g.insert_edge("test", "package", 1);
+
+	auto const sorted = gdwg::topological_sort(g);
+	CHECK(sorted.is_dag);
+	CHECK(sorted.cycle.empty());
+	CHECK(is_valid_order(g, sorted.order));
+
+	SECTION("cycle is reported") {
+		g.insert_edge("package", "compile", 1);
+		auto const cyclic = gdwg::topological_sort(g);
+		CHECK_FALSE(cyclic.is_dag);
+		CHECK(cyclic.order.empty());
+		REQUIRE(cyclic.cycle.size() >= 2);
+		for (auto i = std::size_t{0}; i < cyclic.cycle.size(); ++i) {
+			CHECK(g.is_connected(cyclic.cycle[i], cyclic.cycle[(i + 1) % cyclic.cycle.size()]));
+		}
+	}
+
+	SECTION("self loop is a cycle") {
+		g.insert_edge("docs", "docs", 1);
+		auto const cyclic = gdwg::topological_sort(g);
+		CHECK_FALSE(cyclic.is_dag);
+		CHECK(cyclic.cycle == std::vector<std::string>{"docs"});
+	}
+}
+
+TEST_CASE("incremental order keeps up with inserts") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	auto order = gdwg::incremental_topological_order<std::string, int>(g);
+	CHECK(is_valid_order(g, order.order()));
+
+	// kahn puts a first, so this agrees with the order and nothing moves
+	auto const forward = order.insert_edge("a", "c", 1);
+	CHECK(forward.inserted);
+	CHECK(order.last_reordered() == 0);
+	CHECK(order.insert_edge("b", "c", 1).inserted);
+	CHECK(is_valid_order(g, order.order()));
+
+	// d currently sits after a so a -> ... must be reshuffled
+	CHECK(order.insert_edge("d", "a", 1).inserted);
+	CHECK(order.last_reordered() > 0);
+	CHECK(is_valid_order(g, order.order()));
+	CHECK(order.position("d") < order.position("a"));
+
+	// duplicate edge is not inserted but isn't a cycle either
+	auto const duplicate = order.insert_edge("d", "a", 1);
+	CHECK_FALSE(duplicate.inserted);
+	CHECK(duplicate.cycle.empty());
+
+	SECTION("cycle is rejected and reported") {
+		auto const rejected = order.insert_edge("c", "d", 7);
+		CHECK_FALSE(rejected.inserted);
+		REQUIRE(rejected.cycle.size() >= 3);
+		CHECK(rejected.cycle.front() == "d");
+		CHECK(rejected.cycle.back() == "c");
+		for (auto i = std::size_t{0}; i + 1 < rejected.cycle.size(); ++i) {
+			CHECK(g.is_connected(rejected.cycle[i], rejected.cycle[i + 1]));
+		}
+		CHECK_FALSE(g.is_connected("c", "d"));
+		CHECK(is_valid_order(g, order.order()));
+
+		auto const self = order.insert_edge("a", "a", 1);
+		CHECK_FALSE(self.inserted);
+		CHECK(self.cycle == std::vector<std::string>{"a"});
+	}
+
+	SECTION("nodes come and go") {
+		CHECK(order.insert_node("e"));
+		CHECK_FALSE(order.insert_node("e"));
+		CHECK(order.insert_edge("e", "d", 1).inserted);
+		CHECK(is_valid_order(g, order.order()));
+		CHECK(order.erase_node("a"));
+		CHECK_FALSE(g.is_node("a"));
+		CHECK(is_valid_order(g, order.order()));
+		CHECK(order.erase_edge("e", "d", 1));
+		CHECK_FALSE(order.erase_edge("e", "d", 1));
+		// once the path back is gone the edge is fine
+		CHECK(order.insert_edge("c", "d", 1).inserted);
+		CHECK(order.insert_node("a"));
+		CHECK(order.insert_edge("d", "a", 1).inserted);
+		CHECK(is_valid_order(g, order.order()));
+	}
+
+	SECTION("check throws") {
+		CHECK_THROWS_MATCHES(order.insert_edge("a", "z", 1),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call "
+		                                              "gdwg::incremental_topological_order<N, "
+		                                              "E>::insert_edge on a node that doesn't exist "
+		                                              "in the graph"));
+		auto cyclic = gdwg::graph<int, int>{1, 2};
+		cyclic.insert_edge(1, 2, 1);
+		cyclic.insert_edge(2, 1, 1);
+		using order_type = gdwg::incremental_topological_order<int, int>;
+		CHECK_THROWS_MATCHES(order_type(cyclic),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot construct "
+		                                              "gdwg::incremental_topological_order over a "
+		                                              "graph that has a cycle"));
+	}
+}
+
+TEST_CASE("incremental order agrees with kahn on random inserts") {
+	auto rng = std::mt19937(6771);
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 50; ++i) {
+		g.insert_node(i);
+	}
+	auto order = gdwg::incremental_topological_order<int, int>(g);
+	auto node = std::uniform_int_distribution<int>(0, 49);
+	for (auto i = 0; i < 400; ++i) {
+		auto const src = node(rng);
+		auto const dst = node(rng);
+		auto const had_edge = g.find(src, dst, i) != g.end();
+		auto copy = g;
+		copy.insert_edge(src, dst, i);
+		auto const acyclic = gdwg::topological_sort(copy).is_dag;
+
+		auto const result = order.insert_edge(src, dst, i);
+		CHECK(result.inserted == (acyclic && !had_edge));
+		CHECK(result.cycle.empty() == acyclic);
+		REQUIRE(is_valid_order(g, order.order()));
+	}
+}
@@ -0,0 +1,133 @@
+#include "gdwg/detail/intersect.hpp"
+#include "gdwg/generators.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/triangles.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <iterator>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Rationale: the intersection kernels are checked against std::set_intersection on lists of very
+// different lengths (galloping) and similar lengths (the block compare and its tail). Triangle
+// counts are checked on small graphs where direction, parallel edges and self loops must not
+// change the answer, then against a brute force count on random graphs with several threads.
+
+namespace {
+	auto intersection(std::vector<gdwg::node_id> const& a, std::vector<gdwg::node_id> const& b)
+	   -> std::vector<gdwg::node_id> {
+		auto ret = std::vector<gdwg::node_id>();
+		gdwg::detail::intersect(a, b, [&](gdwg::node_id x) { ret.push_back(x); });
+		return ret;
+	}
+
+	auto random_list(std::mt19937& rng, std::size_t size, gdwg::node_id range)
+	   -> std::vector<gdwg::node_id> {
+		auto pick = std::uniform_int_distribution<gdwg::node_id>(0, range);
+		auto ret = std::vector<gdwg::node_id>(size);
+		std::generate(ret.begin(), ret.end(), [&] { return pick(rng); });
+		std::sort(ret.begin(), ret.end());
+		ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+		return ret;
+	}
+} // namespace
+
+TEST_CASE("sorted list intersection") {
+	auto rng = std::mt19937(6771);
+	// sizes before duplicates are removed, and the range the values are drawn from
+	auto const cases = std::vector<std::tuple<std::size_t, std::size_t, gdwg::node_id>>{
+	   {0, 10, 20},
+	   {3, 7, 10},
+	   {50, 60, 100},
+	   {200, 190, 500},
+	   {5, 1000, 2000},
+	   {40, 4000, 5000},
+	};
+	for (auto const& [small, large, range] : cases) {
+		auto const a = random_list(rng, small, range);
+		auto const b = random_list(rng, large, range);
+		auto expected = std::vector<gdwg::node_id>();
+		std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		auto both = intersection(a, b);
+		std::sort(both.begin(), both.end());
+		CHECK(both == expected);
+		auto swapped = intersection(b, a);
+		std::sort(swapped.begin(), swapped.end());
+		CHECK(swapped == expected);
+	}
+}
+
+TEST_CASE("triangles in a small graph") {
+	// a 4-clique on a..d with every kind of noise, plus a pendant e
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "a", 1);
+	g.insert_edge("a", "c", 1);
+	g.insert_edge("a", "c", 2);
+	g.insert_edge("d", "a", 1);
+	g.insert_edge("b", "c", 1);
+	g.insert_edge("d", "b", 1);
+	g.insert_edge("c", "d", 1);
+	g.insert_edge("c", "c", 1);
+	g.insert_edge("e", "a", 1);
+
+	auto const result = gdwg::count_triangles(g, {.threads = 2});
+	CHECK(result.triangles == 4);
+	CHECK(result.per_node == std::vector<std::uint64_t>{3, 3, 3, 3, 0});
+	CHECK(result.degree == std::vector<std::size_t>{4, 3, 3, 3, 1});
+	CHECK(result.clustering[0] == Approx(0.5));
+	CHECK(result.clustering[1] == Approx(1.0));
+	CHECK(result.clustering[4] == 0.0);
+	// 12 closed triples over 6 + 3 * 3 triples in total
+	CHECK(result.transitivity == Approx(12.0 / 15.0));
+	CHECK(result.average_clustering == Approx(3.5 / 5.0));
+
+	auto const empty = gdwg::count_triangles(gdwg::graph<int, int>{});
+	CHECK(empty.triangles == 0);
+	CHECK(empty.transitivity == 0.0);
+}
+
+TEST_CASE("triangles agree with a brute force count") {
+	for (auto round = std::size_t{0}; round < 6; ++round) {
+		auto const g = gdwg::rmat_graph({.scale = 7, .edge_factor = 2 + 2 * round, .seed = round});
+		auto const view = gdwg::csr_graph<int, int>(g);
+		auto const n = view.num_nodes();
+		auto adjacent = std::vector<std::vector<bool>>(n, std::vector<bool>(n, false));
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			for (auto const v : view.out_targets(u)) {
+				adjacent[u][v] = adjacent[v][u] = u != v;
+			}
+		}
+		auto expected = std::vector<std::uint64_t>(n, 0);
+		auto total = std::uint64_t{0};
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			for (auto v = u + 1; v < n; ++v) {
+				for (auto w = v + 1; w < n && adjacent[u][v]; ++w) {
+					if (adjacent[u][w] && adjacent[v][w]) {
+						++expected[u];
+						++expected[v];
+						++expected[w];
+						++total;
+					}
+				}
+			}
+		}
+		for (auto const threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}}) {
+			auto const result = gdwg::count_triangles(view, {.threads = threads});
+			CHECK(result.triangles == total);
+			CHECK(result.per_node == expected);
+		}
+	}
+}
+
+TEST_CASE("count_triangles needs incoming edges") {
+	auto const g = gdwg::graph<int, int>{1};
+	auto const view = gdwg::csr_graph<int, int>(g, gdwg::csr_layout::outgoing);
+	CHECK_THROWS_MATCHES(gdwg::count_triangles(view),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::count_triangles on a csr_graph "
+	                                              "built without incoming edges"));
+}